@@ -114,9 +114,24 @@ void AppController::configureComponents()
 {
     LOG_DEBUG << "Configuring components...";
 
+    configureBinaryLog();
+
     connection_manager_->setAutoReconnect(config_.network.auto_reconnect);
     connection_manager_->setReconnectInterval(config_.network.reconnect_interval_ms);
     connection_manager_->setMaxReconnectAttempts(config_.network.max_reconnect_attempts);
+
+    network::OverflowPolicy overflow_policy = network::OverflowPolicy::DropOldest;
+    network::overflowPolicyFromString(config_.network.message_queue_overflow.toStdString(), overflow_policy);
+    connection_manager_->setMessageQueueConfig(
+        static_cast<std::size_t>(config_.network.message_queue_capacity), overflow_policy);
+
+    auto ingest_backend = network::ConnectionManager::IngestBackend::Epoll;
+    network::ConnectionManager::ingestBackendFromString(config_.network.ingest_backend, ingest_backend);
+    connection_manager_->setIngestBackend(ingest_backend);
+
+    auto update_mode = network::ConnectionManager::UpdateMode::Immediate;
+    network::ConnectionManager::updateModeFromString(config_.network.update_mode, update_mode);
+    connection_manager_->setUpdateMode(update_mode, config_.network.update_interval_ms);
     LOG_DEBUG << "ConnectionManager configured: host=" << config_.network.host.toStdString()
               << " port=" << config_.network.port;
 
@@ -124,26 +139,39 @@ void AppController::configureComponents()
     connection_manager_->setWarningEngineConfig(warning_config);
     LOG_DEBUG << "WarningEngine configured";
 
+    if (sync_monitor_) {
+        delete sync_monitor_;
+    }
+    sync_monitor_ = new SynchronizationMonitor(config_.sync.max_timestamp_diff_ms, this);
+    sync_monitor_->setAlignmentConfig(config_.sync.toAlignmentConfig());
+    LOG_DEBUG << "SyncMonitor configured with threshold=" << config_.sync.max_timestamp_diff_ms << "ms";
+
     video_widget_->setSourceUrl(config_.video.source_url);
     video_widget_->setAutoStart(config_.video.auto_start);
+    video_widget_->setFramePoolSize(config_.video.frame_pool_size);
+
+    video::FramePipelineConfig pipeline_config;
+    pipeline_config.worker_count = config_.video.processing_threads;
+    pipeline_config.max_in_flight = config_.video.max_frames_in_flight;
+    pipeline_config.late_threshold_ms = config_.video.late_frame_ms;
+    video_widget_->setPipelineConfig(pipeline_config);
+    video_widget_->setAsyncProcessing(config_.video.async_processing);
+
+    auto scale_quality = video::AbstractVideoWidget::ScaleQuality::Fast;
+    video::AbstractVideoWidget::scaleQualityFromString(config_.video.scale_quality, scale_quality);
+    video_widget_->setScaleQuality(scale_quality);
+
+    auto render_backend = video::AbstractVideoWidget::RenderBackend::Raster;
+    video::AbstractVideoWidget::renderBackendFromString(config_.video.render_backend, render_backend);
+    video_widget_->setRenderBackend(render_backend);
     LOG_DEBUG << "VideoWidget configured: url=" << config_.video.source_url.toStdString();
 
-    video_widget_->addFrameProcessor(overlay_processor_);
-
     auto* marking_processor = dynamic_cast<video::MarkingOverlayProcessor*>(overlay_processor_.data());
     if (marking_processor) {
-        marking_processor->setMarkingObjectListModel(connection_manager_->markingListModel());
-        marking_processor->setLaneStateViewModel(connection_manager_->laneViewModel());
-        marking_processor->setWarningListModel(connection_manager_->warningListModel());
-        LOG_DEBUG << "MarkingOverlayProcessor configured with ViewModels";
+        marking_processor->setSnapshotSource(overlaySnapshotSource());
+        LOG_DEBUG << "MarkingOverlayProcessor configured with domain snapshots";
     }
-    LOG_DEBUG << "MarkingOverlayProcessor added to VideoWidget";
-
-    if (sync_monitor_) {
-        delete sync_monitor_;
-    }
-    sync_monitor_ = new SynchronizationMonitor(config_.sync.max_timestamp_diff_ms, this);
-    LOG_DEBUG << "SyncMonitor configured with threshold=" << config_.sync.max_timestamp_diff_ms << "ms";
+    applyOverlayPath(video_widget_->renderBackend());
 }
 
 
@@ -181,6 +209,18 @@ void AppController::wireComponents()
             &video::NetworkVideoWidget::connectionFailed,
             this, &AppController::onVideoConnectionError);
 
+    // The OpenGL backend may give up once it sees the context
+    connect(video_widget_,
+            &video::NetworkVideoWidget::renderBackendChanged,
+            this, &AppController::applyOverlayPath);
+
+    if (connection_manager_->updateMode() == network::ConnectionManager::UpdateMode::FrameSync) {
+        connect(video_widget_,
+                &video::NetworkVideoWidget::frameDisplayed,
+                connection_manager_, &network::ConnectionManager::applyPendingUpdates);
+        LOG_DEBUG << "Video frames → ConnectionManager update tick connected";
+    }
+
     if (config_.sync.enable_sync_monitoring) {
         connect(video_widget_,
                 &video::NetworkVideoWidget::frameDisplayed,
@@ -188,6 +228,13 @@ void AppController::wireComponents()
                     sync_monitor_->updateVideoTimestamp(timestamp_ms);
                 });
         LOG_DEBUG << "Video timestamp → SyncMonitor connected";
+
+        if (config_.sync.frame_alignment) {
+            connect(connection_manager_,
+                    &network::ConnectionManager::snapshotPublished,
+                    sync_monitor_, &SynchronizationMonitor::recordSnapshot);
+            LOG_DEBUG << "Domain snapshots → SyncMonitor timeline connected";
+        }
     }
 
     connect(sync_monitor_,
@@ -226,7 +273,7 @@ void AppController::onLaneStateUpdated()
     const auto& lane_state = connection_manager_->laneState();
 
     if (config_.sync.enable_sync_monitoring) {
-        sync_monitor_->updateDataTimestamp(lane_state.timestampMs());
+        sync_monitor_->updateDataTimestamp(connection_manager_->laneHostTimestampMs());
     }
 
     LOG_DEBUG << "Lane state updated, ts=" << lane_state.timestampMs();
@@ -235,12 +282,6 @@ void AppController::onLaneStateUpdated()
 void AppController::onMarkingModelUpdated()
 {
     const auto& marking_model = connection_manager_->markingModel();
-
-    auto* marking_processor = dynamic_cast<video::MarkingOverlayProcessor*>(overlay_processor_.data());
-    if (marking_processor) {
-        marking_processor->updateMarkings(marking_model);
-    }
-
     LOG_DEBUG << "Marking model updated, count=" << marking_model.size();
 }
 
@@ -316,6 +357,60 @@ void AppController::setVideoConnected(bool connected)
     }
 }
 
+const domain::SnapshotSource* AppController::overlaySnapshotSource() const
+{
+    // Frames are only paired with the data of their time while the monitor
+    // is fed both sides
+    if (config_.sync.enable_sync_monitoring && config_.sync.frame_alignment)
+        return &sync_monitor_->timeline();
+    return &connection_manager_->snapshotPublisher();
+}
+
+void AppController::applyOverlayPath(video::AbstractVideoWidget::RenderBackend backend)
+{
+    const bool raster = backend == video::AbstractVideoWidget::RenderBackend::Raster;
+
+    // The OpenGL surface draws the overlay from the snapshot by itself
+    if (raster) {
+        video_widget_->setOverlaySnapshotSource(nullptr);
+        if (!overlay_processor_attached_) {
+            video_widget_->addFrameProcessor(overlay_processor_);
+            LOG_DEBUG << "MarkingOverlayProcessor added to VideoWidget";
+        }
+    } else {
+        if (overlay_processor_attached_)
+            video_widget_->removeFrameProcessor(overlay_processor_);
+        video_widget_->setOverlaySnapshotSource(overlaySnapshotSource());
+        LOG_DEBUG << "Overlay drawn by the OpenGL video surface";
+    }
+    overlay_processor_attached_ = raster;
+}
+
+void AppController::configureBinaryLog()
+{
+    auto& binary_log = logger::BinaryLog::instance();
+    if (config_.logging.binary_path.isEmpty()) {
+        binary_log.close();
+        return;
+    }
+
+    logger::LogLevel level = logger::LogLevel::Trace;
+    logger::level_from_string(config_.logging.binary_level.toStdString(), level);
+    binary_log.set_level(level);
+
+    std::string error;
+    const std::size_t file_bytes = static_cast<std::size_t>(config_.logging.binary_file_size_mb) * 1024 * 1024;
+    if (!binary_log.open(config_.logging.binary_path.toStdString(), file_bytes,
+                         static_cast<std::uint32_t>(config_.logging.binary_max_files), error)) {
+        LOG_ERROR << "Binary log not started: " << error;
+        return;
+    }
+    LOG_INFO << "Binary log: " << config_.logging.binary_path.toStdString()
+             << " level=" << config_.logging.binary_level.toStdString()
+             << " files=" << config_.logging.binary_max_files
+             << "x" << config_.logging.binary_file_size_mb << "MB";
+}
+
 void AppController::updateGlobalConnectionState()
 {
     bool new_state = is_data_connected_ && is_video_connected_;
@@ -83,6 +83,7 @@ private:
     network::ConnectionManager* connection_manager_{nullptr};
     video::NetworkVideoWidget* video_widget_{nullptr};
     video::FrameProcessorPtr overlay_processor_{nullptr};
+    bool overlay_processor_attached_{false};
     SynchronizationMonitor* sync_monitor_{nullptr};
 
     config::AppConfig config_;
@@ -97,6 +98,9 @@ private:
     void wireComponents();
 
     void updateGlobalConnectionState();
+    void applyOverlayPath(video::AbstractVideoWidget::RenderBackend backend);
+    void configureBinaryLog();
+    const domain::SnapshotSource* overlaySnapshotSource() const;
     void updateStatusMessage(const QString& message);
     void setDataConnected(bool connected);
     void setVideoConnected(bool connected);
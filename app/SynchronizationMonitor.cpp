@@ -1,6 +1,8 @@
 #include "SynchronizationMonitor.hpp"
 #include "LoggerMacros.hpp"
+#include <algorithm>
 #include <cmath>
+#include <cstdlib>
 
 namespace app {
 
@@ -20,7 +22,8 @@ void SynchronizationMonitor::updateDataTimestamp(std::uint64_t timestamp_ms) {
     }
 
     emit dataTimestampChanged(timestamp_ms);
-    checkSynchronization();
+    if (timeline_.size() == 0)
+        checkSynchronization();
 }
 
 void SynchronizationMonitor::updateVideoTimestamp(std::uint64_t timestamp_ms) {
@@ -32,7 +35,28 @@ void SynchronizationMonitor::updateVideoTimestamp(std::uint64_t timestamp_ms) {
     }
 
     emit videoTimestampChanged(timestamp_ms);
-    checkSynchronization();
+    if (timeline_.size() == 0)
+        checkSynchronization();
+    else
+        checkAlignment();
+}
+
+void SynchronizationMonitor::setAlignmentConfig(const domain::AlignmentConfig& config) {
+    timeline_.setConfig(config);
+    LOG_DEBUG << "SynchronizationMonitor: alignment history=" << config.history
+              << " max_skew=" << config.max_skew_ms << "ms hold_back=" << config.hold_back_ms << "ms";
+}
+
+void SynchronizationMonitor::recordSnapshot(const domain::DomainSnapshotPtr& snapshot) {
+    timeline_.record(snapshot);
+}
+
+QVariantList SynchronizationMonitor::alignmentHistogram() const {
+    QVariantList histogram;
+    histogram.reserve(static_cast<int>(kAlignmentBuckets));
+    for (quint64 count : alignment_stats_.histogram)
+        histogram.append(count);
+    return histogram;
 }
 
 void SynchronizationMonitor::reset() {
@@ -42,6 +66,8 @@ void SynchronizationMonitor::reset() {
     video_timestamp_ms_ = 0;
     has_data_ = false;
     has_video_ = false;
+    timeline_.clear();
+    alignment_stats_ = {};
 
     setTimestampDiff(0);
     setSynchronized(true);
@@ -59,8 +85,41 @@ void SynchronizationMonitor::checkSynchronization() {
         diff = video_timestamp_ms_ - data_timestamp_ms_;
     }
 
-    int diff_ms = static_cast<int>(diff);
+    reportDiff(static_cast<int>(diff));
+}
+
+void SynchronizationMonitor::checkAlignment() {
+    const domain::SnapshotAlignment alignment = timeline_.align(video_timestamp_ms_);
+    recordAlignment(alignment);
+
+    // Error to the snapshot actually paired with the frame, not to the newest data
+    reportDiff(static_cast<int>(std::min<std::int64_t>(std::llabs(alignment.error_ms), INT32_MAX)));
+}
+
+void SynchronizationMonitor::recordAlignment(const domain::SnapshotAlignment& alignment) {
+    AlignmentStats& stats = alignment_stats_;
+    ++stats.frames;
+    if (!alignment.aligned) {
+        ++stats.out_of_skew;
+        return;
+    }
+
+    ++stats.aligned;
+    if (alignment.interpolated)
+        ++stats.interpolated;
+
+    const std::int64_t error = std::llabs(alignment.error_ms);
+    const auto bucket = std::lower_bound(kAlignmentBucketBoundsMs.begin(), kAlignmentBucketBoundsMs.end(), error);
+    ++stats.histogram[static_cast<std::size_t>(bucket - kAlignmentBucketBoundsMs.begin())];
+
+    if (stats.aligned % kHistogramPublishFrames == 0) {
+        LOG_TRACE << "SynchronizationMonitor: aligned=" << stats.aligned
+                  << " interpolated=" << stats.interpolated << " out_of_skew=" << stats.out_of_skew;
+        emit alignmentHistogramChanged(alignmentHistogram());
+    }
+}
 
+void SynchronizationMonitor::reportDiff(int diff_ms) {
     setTimestampDiff(diff_ms);
 
     bool currently_synced = (diff_ms <= threshold_ms_);
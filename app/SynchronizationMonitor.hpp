@@ -1,7 +1,10 @@
 #pragma once
 
 #include <QObject>
+#include <QVariantList>
+#include <array>
 #include <cstdint>
+#include "SnapshotTimeline.h"
 
 namespace app {
 
@@ -16,15 +19,40 @@ class SynchronizationMonitor : public QObject {
     Q_PROPERTY(quint64 lastVideoTimestamp READ lastVideoTimestamp
                NOTIFY videoTimestampChanged)
     Q_PROPERTY(int threshold READ threshold CONSTANT)
+    Q_PROPERTY(QVariantList alignmentHistogram READ alignmentHistogram
+               NOTIFY alignmentHistogramChanged)
 
 public:
+    // |alignment error| histogram: bucket i counts errors up to
+    // kAlignmentBucketBoundsMs[i] ms, the last bucket everything beyond
+    static constexpr std::array<int, 9> kAlignmentBucketBoundsMs{1, 2, 5, 10, 20, 50, 100, 200, 500};
+    static constexpr std::size_t kAlignmentBuckets = kAlignmentBucketBoundsMs.size() + 1;
+
+    struct AlignmentStats {
+        quint64 frames = 0;         // video frames checked against the timeline
+        quint64 aligned = 0;        // paired within max skew
+        quint64 interpolated = 0;   // of those, with an interpolated lane
+        quint64 out_of_skew = 0;    // shown with the newest snapshot instead
+        std::array<quint64, kAlignmentBuckets> histogram{};
+    };
 
     explicit SynchronizationMonitor(int threshold_ms, QObject* parent = nullptr);
     ~SynchronizationMonitor() override = default;
 
+    // Both on domain::hostClockMs(): data via ConnectionManager's sensor
+    // timebase, video frames are stamped with it on arrival
     void updateDataTimestamp(std::uint64_t timestamp_ms);
     void updateVideoTimestamp(std::uint64_t timestamp_ms);
 
+    // Frame alignment: snapshots go into the timeline, and each video
+    // timestamp is measured against it instead of the last data timestamp
+    void setAlignmentConfig(const domain::AlignmentConfig& config);
+    void recordSnapshot(const domain::DomainSnapshotPtr& snapshot);
+    const domain::SnapshotTimeline& timeline() const { return timeline_; }
+
+    AlignmentStats alignmentStats() const { return alignment_stats_; }
+    QVariantList alignmentHistogram() const;
+
     void reset();
 
     int timestampDiffMs() const { return timestamp_diff_ms_; }
@@ -41,6 +69,8 @@ signals:
     void videoTimestampChanged(quint64 timestamp);
     void desyncWarning(const QString& message);
     void syncRestored();
+    // Every kHistogramPublishFrames aligned video frames
+    void alignmentHistogramChanged(const QVariantList& histogram);
 
 private:
     std::uint64_t data_timestamp_ms_{0};
@@ -51,8 +81,15 @@ private:
     bool has_data_{false};
     bool has_video_{false};
 
+    static constexpr quint64 kHistogramPublishFrames = 30;
+
+    domain::SnapshotTimeline timeline_;
+    AlignmentStats alignment_stats_;
 
     void checkSynchronization();
+    void checkAlignment();
+    void reportDiff(int diff_ms);
+    void recordAlignment(const domain::SnapshotAlignment& alignment);
     void setTimestampDiff(int diff);
     void setSynchronized(bool synced);
 };
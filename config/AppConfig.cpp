@@ -1,5 +1,6 @@
 #include "AppConfig.hpp"
 #include "WarningEngine.h"
+#include "SnapshotTimeline.h"
 
 namespace config {
 
@@ -11,6 +12,11 @@ QJsonObject NetworkConfig::toJson() const {
     json["reconnect_interval_ms"] = reconnect_interval_ms;
     json["max_reconnect_attempts"] = max_reconnect_attempts;
     json["auto_reconnect"] = auto_reconnect;
+    json["message_queue_capacity"] = message_queue_capacity;
+    json["message_queue_overflow"] = message_queue_overflow;
+    json["ingest_backend"] = ingest_backend;
+    json["update_mode"] = update_mode;
+    json["update_interval_ms"] = update_interval_ms;
     return json;
 }
 
@@ -32,6 +38,21 @@ NetworkConfig NetworkConfig::fromJson(const QJsonObject& json) {
     if (json.contains("auto_reconnect"))
         config.auto_reconnect = json["auto_reconnect"].toBool();
 
+    if (json.contains("message_queue_capacity"))
+        config.message_queue_capacity = json["message_queue_capacity"].toInt();
+
+    if (json.contains("message_queue_overflow"))
+        config.message_queue_overflow = json["message_queue_overflow"].toString();
+
+    if (json.contains("ingest_backend"))
+        config.ingest_backend = json["ingest_backend"].toString();
+
+    if (json.contains("update_mode"))
+        config.update_mode = json["update_mode"].toString();
+
+    if (json.contains("update_interval_ms"))
+        config.update_interval_ms = json["update_interval_ms"].toInt();
+
     return config;
 }
 
@@ -40,6 +61,13 @@ QJsonObject VideoConfig::toJson() const {
     QJsonObject json;
     json["source_url"] = source_url;
     json["auto_start"] = auto_start;
+    json["frame_pool_size"] = frame_pool_size;
+    json["async_processing"] = async_processing;
+    json["processing_threads"] = processing_threads;
+    json["max_frames_in_flight"] = max_frames_in_flight;
+    json["late_frame_ms"] = late_frame_ms;
+    json["scale_quality"] = scale_quality;
+    json["render_backend"] = render_backend;
     return json;
 }
 
@@ -52,6 +80,27 @@ VideoConfig VideoConfig::fromJson(const QJsonObject& json) {
     if (json.contains("auto_start"))
         config.auto_start = json["auto_start"].toBool();
 
+    if (json.contains("frame_pool_size"))
+        config.frame_pool_size = json["frame_pool_size"].toInt();
+
+    if (json.contains("async_processing"))
+        config.async_processing = json["async_processing"].toBool();
+
+    if (json.contains("processing_threads"))
+        config.processing_threads = json["processing_threads"].toInt();
+
+    if (json.contains("max_frames_in_flight"))
+        config.max_frames_in_flight = json["max_frames_in_flight"].toInt();
+
+    if (json.contains("late_frame_ms"))
+        config.late_frame_ms = json["late_frame_ms"].toInt();
+
+    if (json.contains("scale_quality"))
+        config.scale_quality = json["scale_quality"].toString();
+
+    if (json.contains("render_backend"))
+        config.render_backend = json["render_backend"].toString();
+
     return config;
 }
 
@@ -65,6 +114,7 @@ QJsonObject WarningConfig::toJson() const {
     json["min_lane_quality"] = static_cast<int>(min_lane_quality);
     json["enable_crosswalk_warnings"] = enable_crosswalk_warnings;
     json["enable_lane_departure_warnings"] = enable_lane_departure_warnings;
+    json["rules"] = rules;
     return json;
 }
 
@@ -92,6 +142,9 @@ WarningConfig WarningConfig::fromJson(const QJsonObject& json) {
     if (json.contains("enable_lane_departure_warnings"))
         config.enable_lane_departure_warnings = json["enable_lane_departure_warnings"].toBool();
 
+    if (json.contains("rules"))
+        config.rules = json["rules"].toArray();
+
     return config;
 }
 
@@ -104,14 +157,109 @@ domain::WarningEngineConfig WarningConfig::toDomainConfig() const {
     domain_config.min_lane_quality = min_lane_quality;
     domain_config.enable_crosswalk_warnings = enable_crosswalk_warnings;
     domain_config.enable_lane_departure_warnings = enable_lane_departure_warnings;
+    QString error;
+    ruleSpecs(domain_config.rules, error);     // validated on load
     return domain_config;
 }
 
+bool WarningConfig::ruleSpecs(std::vector<domain::WarningRuleSpec>& out, QString& error) const {
+    out.clear();
+    std::vector<domain::WarningRuleSpec> specs;
+
+    for (int i = 0; i < rules.size(); ++i) {
+        if (!rules[i].isObject()) {
+            error = QString("Warning rule #%1 must be an object").arg(i + 1);
+            return false;
+        }
+        const QJsonObject json = rules[i].toObject();
+        domain::WarningRuleSpec spec;
+        spec.name = json["name"].toString().toStdString();
+        const QString label = spec.name.empty() ? QString("#%1").arg(i + 1)
+                                                : QString("'%1'").arg(json["name"].toString());
+
+        if (json.contains("enabled"))
+            spec.enabled = json["enabled"].toBool();
+
+        if (json.contains("type") &&
+            !domain::warningTypeFromString(json["type"].toString().toStdString(), spec.type)) {
+            error = QString("Warning rule %1: unknown type '%2'").arg(label, json["type"].toString());
+            return false;
+        }
+
+        if (json.contains("severity") &&
+            !domain::warningSeverityFromString(json["severity"].toString().toStdString(), spec.severity)) {
+            error = QString("Warning rule %1: unknown severity '%2'").arg(label, json["severity"].toString());
+            return false;
+        }
+
+        if (!domain::warningSubjectFromString(json["subject"].toString().toStdString(),
+                                              spec.subject, spec.marking_class)) {
+            error = QString("Warning rule %1: subject must be one of: lane, crosswalk, arrow, unknown").arg(label);
+            return false;
+        }
+
+        const auto parse_conditions = [&](const QString& key, std::vector<domain::WarningCondition>& conditions) {
+            for (const QJsonValue& value : json[key].toArray()) {
+                domain::WarningCondition condition;
+                if (!domain::parseWarningCondition(value.toString().toStdString(), condition)) {
+                    error = QString("Warning rule %1: bad condition '%2' (expected \"<field> <op> <number>\")")
+                                .arg(label, value.toString());
+                    return false;
+                }
+                conditions.push_back(condition);
+            }
+            return true;
+        };
+        if (!parse_conditions("when", spec.when) || !parse_conditions("critical_when", spec.critical_when))
+            return false;
+
+        const QJsonObject hysteresis = json["hysteresis"].toObject();
+        for (auto it = hysteresis.begin(); it != hysteresis.end(); ++it) {
+            domain::WarningField field{};
+            if (!domain::warningFieldFromString(it.key().toStdString(), field)) {
+                error = QString("Warning rule %1: unknown hysteresis field '%2'").arg(label, it.key());
+                return false;
+            }
+            spec.hysteresis.emplace_back(field, static_cast<float>(it.value().toDouble()));
+        }
+
+        if (json.contains("min_duration_ms")) {
+            const int min_duration_ms = json["min_duration_ms"].toInt(-1);
+            if (min_duration_ms < 0) {
+                error = QString("Warning rule %1: min_duration_ms must be a non-negative integer").arg(label);
+                return false;
+            }
+            spec.min_duration_ms = static_cast<std::uint32_t>(min_duration_ms);
+        }
+
+        const auto parse_field = [&](const QString& key, domain::WarningField& field) {
+            if (json.contains(key) && !domain::warningFieldFromString(json[key].toString().toStdString(), field)) {
+                error = QString("Warning rule %1: unknown %2 field '%3'").arg(label, key, json[key].toString());
+                return false;
+            }
+            return true;
+        };
+        if (!parse_field("distance", spec.distance) || !parse_field("confidence", spec.confidence))
+            return false;
+
+        spec.message = json["message"].toString().toStdString();
+        specs.push_back(std::move(spec));
+    }
+
+    out = std::move(specs);
+    return true;
+}
+
 
 QJsonObject SyncConfig::toJson() const {
     QJsonObject json;
     json["max_timestamp_diff_ms"] = max_timestamp_diff_ms;
     json["enable_sync_monitoring"] = enable_sync_monitoring;
+    json["frame_alignment"] = frame_alignment;
+    json["alignment_history"] = alignment_history;
+    json["max_alignment_skew_ms"] = max_alignment_skew_ms;
+    json["hold_back_ms"] = hold_back_ms;
+    json["interpolate_lane"] = interpolate_lane;
     return json;
 }
 
@@ -124,6 +272,57 @@ SyncConfig SyncConfig::fromJson(const QJsonObject& json) {
     if (json.contains("enable_sync_monitoring"))
         config.enable_sync_monitoring = json["enable_sync_monitoring"].toBool();
 
+    if (json.contains("frame_alignment"))
+        config.frame_alignment = json["frame_alignment"].toBool();
+
+    if (json.contains("alignment_history"))
+        config.alignment_history = json["alignment_history"].toInt();
+
+    if (json.contains("max_alignment_skew_ms"))
+        config.max_alignment_skew_ms = json["max_alignment_skew_ms"].toInt();
+
+    if (json.contains("hold_back_ms"))
+        config.hold_back_ms = json["hold_back_ms"].toInt();
+
+    if (json.contains("interpolate_lane"))
+        config.interpolate_lane = json["interpolate_lane"].toBool();
+
+    return config;
+}
+
+domain::AlignmentConfig SyncConfig::toAlignmentConfig() const {
+    domain::AlignmentConfig alignment_config;
+    alignment_config.history = static_cast<std::size_t>(alignment_history);
+    alignment_config.max_skew_ms = static_cast<std::uint64_t>(max_alignment_skew_ms);
+    alignment_config.hold_back_ms = static_cast<std::uint64_t>(hold_back_ms);
+    alignment_config.interpolate_lane = interpolate_lane;
+    return alignment_config;
+}
+
+QJsonObject LoggingConfig::toJson() const {
+    QJsonObject json;
+    json["binary_path"] = binary_path;
+    json["binary_level"] = binary_level;
+    json["binary_file_size_mb"] = binary_file_size_mb;
+    json["binary_max_files"] = binary_max_files;
+    return json;
+}
+
+LoggingConfig LoggingConfig::fromJson(const QJsonObject& json) {
+    LoggingConfig config;
+
+    if (json.contains("binary_path"))
+        config.binary_path = json["binary_path"].toString();
+
+    if (json.contains("binary_level"))
+        config.binary_level = json["binary_level"].toString();
+
+    if (json.contains("binary_file_size_mb"))
+        config.binary_file_size_mb = json["binary_file_size_mb"].toInt();
+
+    if (json.contains("binary_max_files"))
+        config.binary_max_files = json["binary_max_files"].toInt();
+
     return config;
 }
 
@@ -133,6 +332,7 @@ QJsonObject AppConfig::toJson() const {
     json["video"] = video.toJson();
     json["warning"] = warning.toJson();
     json["sync"] = sync.toJson();
+    json["logging"] = logging.toJson();
     return json;
 }
 
@@ -151,6 +351,9 @@ AppConfig AppConfig::fromJson(const QJsonObject& json) {
     if (json.contains("sync"))
         config.sync = SyncConfig::fromJson(json["sync"].toObject());
 
+    if (json.contains("logging"))
+        config.logging = LoggingConfig::fromJson(json["logging"].toObject());
+
     return config;
 }
 
@@ -1,11 +1,15 @@
 #pragma once
 
 #include <QString>
+#include <QJsonArray>
 #include <QJsonObject>
 #include <cstdint>
+#include <vector>
 
 namespace domain {
     class WarningEngineConfig;
+    struct WarningRuleSpec;
+    struct AlignmentConfig;
 }
 
 namespace config {
@@ -17,6 +21,11 @@ struct NetworkConfig {
     int reconnect_interval_ms{5000};
     int max_reconnect_attempts{0};  // 0 = unlimited
     bool auto_reconnect{true};
+    int message_queue_capacity{256};                // parsed messages buffered for the GUI thread
+    QString message_queue_overflow{"drop_oldest"};  // drop_oldest | drop_newest | coalesce_latest
+    QString ingest_backend{"epoll"};                // epoll | qt (QTcpSocket reader, the fallback)
+    QString update_mode{"immediate"};               // immediate | timer | frame
+    int update_interval_ms{16};                     // timer period; fallback tick in frame mode
 
     QJsonObject toJson() const;
     static NetworkConfig fromJson(const QJsonObject& json);
@@ -26,6 +35,13 @@ struct NetworkConfig {
 struct VideoConfig {
     QString source_url{"rtsp://127.0.0.1:8554/stream"};
     bool auto_start{false};
+    int frame_pool_size{6};     // recycled decoded-frame buffers
+    bool async_processing{true};    // run frame processors off the GUI thread
+    int processing_threads{2};
+    int max_frames_in_flight{3};
+    int late_frame_ms{100};         // a frame overtaken by newer ones is skipped after this
+    QString scale_quality{"fast"};  // fast | smooth
+    QString render_backend{"raster"};   // raster | opengl (falls back to raster without GL 3.3 / ES 3.0)
 
     QJsonObject toJson() const;
     static VideoConfig fromJson(const QJsonObject& json);
@@ -40,19 +56,40 @@ struct WarningConfig {
     std::uint8_t min_lane_quality{60};
     bool enable_crosswalk_warnings{true};
     bool enable_lane_departure_warnings{true};
+    // Rule objects; when present they replace the built-in rules the fields
+    // above configure. See config.json for the format.
+    QJsonArray rules{};
 
     QJsonObject toJson() const;
     static WarningConfig fromJson(const QJsonObject& json);
     domain::WarningEngineConfig toDomainConfig() const;
+    bool ruleSpecs(std::vector<domain::WarningRuleSpec>& out, QString& error) const;
 };
 
 
 struct SyncConfig {
     int max_timestamp_diff_ms{500};  
     bool enable_sync_monitoring{true};
+    bool frame_alignment{true};         // overlay shows the data at the frame's time, not the newest
+    int alignment_history{64};          // snapshots kept for pairing
+    int max_alignment_skew_ms{100};
+    int hold_back_ms{0};                // pair frames with data this much older
+    bool interpolate_lane{true};
 
     QJsonObject toJson() const;
     static SyncConfig fromJson(const QJsonObject& json);
+    domain::AlignmentConfig toAlignmentConfig() const;
+};
+
+
+struct LoggingConfig {
+    QString binary_path{};              // binary diagnostic log (decode with blog_decode); empty = off
+    QString binary_level{"trace"};      // trace | debug | info | warn | error
+    int binary_file_size_mb{64};        // preallocated size of each file
+    int binary_max_files{4};            // current file plus rotated ones
+
+    QJsonObject toJson() const;
+    static LoggingConfig fromJson(const QJsonObject& json);
 };
 
 
@@ -61,6 +98,7 @@ struct AppConfig {
     VideoConfig video;
     WarningConfig warning;
     SyncConfig sync;
+    LoggingConfig logging;
 
     QJsonObject toJson() const;
     static AppConfig fromJson(const QJsonObject& json);
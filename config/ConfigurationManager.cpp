@@ -1,5 +1,7 @@
 #include "ConfigurationManager.hpp"
 #include "LoggerMacros.hpp"
+#include "MessageQueue.h"
+#include "WarningRules.h"
 #include <QFile>
 #include <QJsonDocument>
 #include <QJsonParseError>
@@ -102,6 +104,9 @@ bool ConfigurationManager::validateConfig(const AppConfig& config, QString& erro
     if (!validateSyncConfig(config.sync, error))
         return false;
 
+    if (!validateLoggingConfig(config.logging, error))
+        return false;
+
     return true;
 }
 
@@ -126,6 +131,32 @@ bool ConfigurationManager::validateNetworkConfig(const NetworkConfig& cfg, QStri
         return false;
     }
 
+    if (cfg.message_queue_capacity < 2 || cfg.message_queue_capacity > 65536) {
+        error = "Message queue capacity must be between 2 and 65536";
+        return false;
+    }
+
+    network::OverflowPolicy policy;
+    if (!network::overflowPolicyFromString(cfg.message_queue_overflow.toStdString(), policy)) {
+        error = "Message queue overflow must be one of: drop_oldest, drop_newest, coalesce_latest";
+        return false;
+    }
+
+    if (cfg.ingest_backend != "epoll" && cfg.ingest_backend != "qt") {
+        error = "Ingest backend must be one of: epoll, qt";
+        return false;
+    }
+
+    if (cfg.update_mode != "immediate" && cfg.update_mode != "timer" && cfg.update_mode != "frame") {
+        error = "Update mode must be one of: immediate, timer, frame";
+        return false;
+    }
+
+    if (cfg.update_interval_ms < 1 || cfg.update_interval_ms > 1000) {
+        error = "Update interval must be between 1ms and 1000ms";
+        return false;
+    }
+
     return true;
 }
 
@@ -140,6 +171,36 @@ bool ConfigurationManager::validateVideoConfig(const VideoConfig& cfg, QString&
         return false;
     }
 
+    if (cfg.frame_pool_size < 2 || cfg.frame_pool_size > 64) {
+        error = "Frame pool size must be between 2 and 64";
+        return false;
+    }
+
+    if (cfg.processing_threads < 1 || cfg.processing_threads > 16) {
+        error = "Processing threads must be between 1 and 16";
+        return false;
+    }
+
+    if (cfg.max_frames_in_flight < 1 || cfg.max_frames_in_flight > 16) {
+        error = "Max frames in flight must be between 1 and 16";
+        return false;
+    }
+
+    if (cfg.late_frame_ms < 0 || cfg.late_frame_ms > 5000) {
+        error = "Late frame threshold must be between 0ms and 5000ms";
+        return false;
+    }
+
+    if (cfg.scale_quality != "fast" && cfg.scale_quality != "smooth") {
+        error = "Scale quality must be one of: fast, smooth";
+        return false;
+    }
+
+    if (cfg.render_backend != "raster" && cfg.render_backend != "opengl") {
+        error = "Render backend must be one of: raster, opengl";
+        return false;
+    }
+
     return true;
 }
 
@@ -174,6 +235,17 @@ bool ConfigurationManager::validateWarningConfig(const WarningConfig& cfg, QStri
         return false;
     }
 
+    std::vector<domain::WarningRuleSpec> rules;
+    if (!cfg.ruleSpecs(rules, error))
+        return false;
+
+    domain::WarningProgram program;
+    std::string compile_error;
+    if (!domain::WarningProgram::compile(rules, program, compile_error)) {
+        error = QString::fromStdString(compile_error);
+        return false;
+    }
+
     return true;
 }
 
@@ -183,6 +255,41 @@ bool ConfigurationManager::validateSyncConfig(const SyncConfig& cfg, QString& er
         return false;
     }
 
+    if (cfg.alignment_history < 2 || cfg.alignment_history > 1024) {
+        error = "Alignment history must be between 2 and 1024 snapshots";
+        return false;
+    }
+
+    if (cfg.max_alignment_skew_ms < 0 || cfg.max_alignment_skew_ms > 10000) {
+        error = "Max alignment skew must be between 0 and 10000ms";
+        return false;
+    }
+
+    if (cfg.hold_back_ms < 0 || cfg.hold_back_ms > 2000) {
+        error = "Hold-back delay must be between 0 and 2000ms";
+        return false;
+    }
+
+    return true;
+}
+
+bool ConfigurationManager::validateLoggingConfig(const LoggingConfig& cfg, QString& error) {
+    logger::LogLevel level = logger::LogLevel::Trace;
+    if (!logger::level_from_string(cfg.binary_level.toStdString(), level) || level == logger::LogLevel::Fatal) {
+        error = QString("Invalid binary log level: %1").arg(cfg.binary_level);
+        return false;
+    }
+
+    if (cfg.binary_file_size_mb < 1 || cfg.binary_file_size_mb > 4096) {
+        error = "Binary log file size must be between 1 and 4096 MB";
+        return false;
+    }
+
+    if (cfg.binary_max_files < 1 || cfg.binary_max_files > 100) {
+        error = "Binary log file count must be between 1 and 100";
+        return false;
+    }
+
     return true;
 }
 
@@ -34,6 +34,7 @@ private:
     static bool validateVideoConfig(const VideoConfig& cfg, QString& error);
     static bool validateWarningConfig(const WarningConfig& cfg, QString& error);
     static bool validateSyncConfig(const SyncConfig& cfg, QString& error);
+    static bool validateLoggingConfig(const LoggingConfig& cfg, QString& error);
 };
 
 } // namespace config
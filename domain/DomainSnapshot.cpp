@@ -0,0 +1,54 @@
+#include "DomainSnapshot.h"
+#include <atomic>
+#include <utility>
+
+namespace domain {
+
+    SnapshotPublisher::SnapshotPublisher()
+        : current_(std::make_shared<const DomainSnapshot>())
+    {
+        retired_.reserve(kMaxRetired);
+    }
+
+    std::shared_ptr<DomainSnapshot> SnapshotPublisher::acquire() {
+        // A retired snapshot held only by us cannot be reached by any reader:
+        // it is no longer current, and readers only copy what they already own.
+        for (auto it = retired_.begin(); it != retired_.end(); ++it) {
+            if (it->use_count() == 1) {
+                std::atomic_thread_fence(std::memory_order_acquire);
+                std::shared_ptr<DomainSnapshot> snapshot = std::move(*it);
+                retired_.erase(it);
+                return snapshot;
+            }
+        }
+        return std::make_shared<DomainSnapshot>();
+    }
+
+    void SnapshotPublisher::publish(std::shared_ptr<DomainSnapshot> snapshot) {
+        if (!snapshot)
+            return;
+
+        snapshot->version = next_version_++;
+        snapshot->content_version = snapshot->version;
+        std::atomic_store_explicit(&current_, DomainSnapshotPtr(snapshot), std::memory_order_release);
+
+        if (live_) {
+            if (retired_.size() == kMaxRetired)
+                retired_.erase(retired_.begin());
+            retired_.push_back(std::move(live_));
+        }
+        live_ = std::move(snapshot);
+    }
+
+    DomainSnapshotPtr SnapshotPublisher::current() const noexcept {
+        return std::atomic_load_explicit(&current_, std::memory_order_acquire);
+    }
+
+    std::uint64_t SnapshotPublisher::version() const noexcept {
+        return current()->version;
+    }
+
+    DomainSnapshotPtr SnapshotPublisher::snapshotFor(std::uint64_t /*frame_timestamp_ms*/) const {
+        return current();
+    }
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "LaneState.h"
+#include "MarkingObject.h"
+#include "Warning.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace domain {
+
+    // Immutable copy of the whole domain state at one point in time
+    struct DomainSnapshot {
+        std::uint64_t version = 0;
+        // Version of the published snapshot the markings and warnings come
+        // from. Equal to version except in interpolated snapshots, which
+        // only change the lane.
+        std::uint64_t content_version = 0;
+        std::uint64_t timestamp_ms = 0;     // host time of the newest data in it
+        std::uint64_t lane_host_ms = 0;     // host time of the lane state, 0 if none
+        LaneState lane;
+        MarkingObjectModel markings;
+        WarningModel warnings;
+    };
+
+    using DomainSnapshotPtr = std::shared_ptr<const DomainSnapshot>;
+
+    // Where overlays get the domain state to draw over a video frame
+    class SnapshotSource {
+    public:
+        virtual ~SnapshotSource() = default;
+
+        // Snapshot for a frame captured at frame_timestamp_ms (0 if unknown).
+        // Safe to call from any thread.
+        virtual DomainSnapshotPtr snapshotFor(std::uint64_t frame_timestamp_ms) const = 0;
+    };
+
+    // Single-writer publication point for DomainSnapshot. current() may be
+    // called from any thread and returns a snapshot that stays valid for as
+    // long as the caller holds it. The writer fills the buffer returned by
+    // acquire() and hands it to publish(); buffers nobody references any
+    // more are recycled, so steady-state publishing does not allocate.
+    class SnapshotPublisher : public SnapshotSource {
+    public:
+        SnapshotPublisher();
+
+        SnapshotPublisher(const SnapshotPublisher&) = delete;
+        SnapshotPublisher& operator=(const SnapshotPublisher&) = delete;
+
+        // Writer only
+        std::shared_ptr<DomainSnapshot> acquire();
+        void publish(std::shared_ptr<DomainSnapshot> snapshot);
+
+        DomainSnapshotPtr current() const noexcept;
+        std::uint64_t version() const noexcept;
+
+        // Always the current snapshot, whatever the frame time
+        DomainSnapshotPtr snapshotFor(std::uint64_t frame_timestamp_ms) const override;
+
+    private:
+        static constexpr std::size_t kMaxRetired = 4;
+
+        DomainSnapshotPtr current_;     // only through std::atomic_load/atomic_store
+        std::shared_ptr<DomainSnapshot> live_;      // writer's handle on current_
+        std::vector<std::shared_ptr<DomainSnapshot>> retired_;
+        std::uint64_t next_version_ = 1;
+    };
+}
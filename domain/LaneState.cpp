@@ -53,6 +53,17 @@ namespace domain {
         valid_ = true;
     }
 
+    LaneState LaneState::interpolate(const LaneState& from, const LaneState& to, float t) noexcept {
+        t = std::fmin(std::fmax(t, 0.0f), 1.0f);
+
+        LaneState state = t < 0.5f ? from : to;
+        state.left_offset_m_ = from.left_offset_m_ + (to.left_offset_m_ - from.left_offset_m_) * t;
+        state.right_offset_m_ = from.right_offset_m_ + (to.right_offset_m_ - from.right_offset_m_) * t;
+        state.timestamp_ms_ = from.timestamp_ms_ + static_cast<laneproto::TimestampMs>(
+            std::lround((static_cast<double>(to.timestamp_ms_) - static_cast<double>(from.timestamp_ms_)) * t));
+        return state;
+    }
+
     void LaneState::reset() noexcept {
         lane_type_left_ = {};
         lane_type_right_ = {};
@@ -30,6 +30,10 @@ namespace domain {
         void updateFromProto(const laneproto::LaneSummary& msg) noexcept;
         void reset() noexcept;
 
+        // Offsets and timestamp blended at t in [0, 1]; the rest comes from
+        // whichever state is nearer
+        static LaneState interpolate(const LaneState& from, const LaneState& to, float t) noexcept;
+
         laneproto::LaneType laneTypeLeft() const noexcept;
         laneproto::LaneType laneTypeRight() const noexcept;
 
@@ -0,0 +1,86 @@
+#include "MarkingIndex.h"
+
+namespace domain {
+
+    void MarkingIndex::build(const MarkingObjectModel& model) {
+        model_ = &model;
+        for (auto& bucket : buckets_) {
+            bucket.x.clear();
+            bucket.y.clear();
+            bucket.index.clear();
+        }
+
+        entries_.clear();
+        for (std::uint32_t i = 0; i < model.size(); ++i) {
+            const MarkingObject& obj = model[i];
+            entries_.push_back({obj.xMeters(), obj.yMeters(), i, obj.classId()});
+        }
+        std::sort(entries_.begin(), entries_.end(),
+                  [](const Entry& a, const Entry& b) { return a.x < b.x; });
+
+        for (const Entry& entry : entries_) {
+            const auto slot = static_cast<std::size_t>(entry.class_id);
+            if (slot >= buckets_.size())
+                buckets_.resize(slot + 1);
+            Bucket& bucket = buckets_[slot];
+            bucket.x.push_back(entry.x);
+            bucket.y.push_back(entry.y);
+            bucket.index.push_back(entry.index);
+        }
+    }
+
+    void MarkingIndex::clear() noexcept {
+        model_ = nullptr;
+        for (auto& bucket : buckets_) {
+            bucket.x.clear();
+            bucket.y.clear();
+            bucket.index.clear();
+        }
+    }
+
+    std::size_t MarkingIndex::count(laneproto::MarkingClassId class_id) const noexcept {
+        const Bucket* bucket = find(class_id);
+        return bucket ? bucket->x.size() : 0;
+    }
+
+    void MarkingIndex::nearest(laneproto::MarkingClassId class_id, float x, float y,
+                               std::size_t k, std::vector<MarkingNeighbor>& out) const {
+        out.clear();
+        const Bucket* bucket = find(class_id);
+        if (!bucket || k == 0)
+            return;
+
+        const auto insert = [&](std::size_t i, float distance2) {
+            if (out.size() == k && distance2 >= out.back().distance2)
+                return;
+            if (out.size() == k)
+                out.pop_back();
+            const MarkingNeighbor neighbor{bucket->index[i], distance2};
+            out.insert(std::upper_bound(out.begin(), out.end(), neighbor,
+                           [](const MarkingNeighbor& a, const MarkingNeighbor& b) {
+                               return a.distance2 < b.distance2;
+                           }),
+                       neighbor);
+        };
+
+        // Walk outward from x, nearer side first; once the x gap alone is
+        // no better than the k-th distance, nothing further out can be
+        const std::size_t n = bucket->x.size();
+        std::size_t right = static_cast<std::size_t>(
+            std::lower_bound(bucket->x.begin(), bucket->x.end(), x) - bucket->x.begin());
+        std::size_t left = right;
+        while (left > 0 || right < n) {
+            const float left_dx = left > 0 ? x - bucket->x[left - 1] : 0.0f;
+            const float right_dx = right < n ? bucket->x[right] - x : 0.0f;
+            const bool take_left = left > 0 && (right == n || left_dx < right_dx);
+            const float dx = take_left ? left_dx : right_dx;
+            if (out.size() == k && dx * dx >= out.back().distance2)
+                break;
+
+            const std::size_t i = take_left ? --left : right++;
+            const float dy = bucket->y[i] - y;
+            insert(i, dx * dx + dy * dy);
+        }
+    }
+
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "MarkingObject.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace domain {
+
+    struct MarkingNeighbor {
+        std::size_t index;                  // into the indexed model
+        float distance2;                    // squared, in m^2
+    };
+
+    // Per-class arrays of marking positions sorted by x, built once per
+    // MarkingObjectModel update. Range and corridor queries binary-search
+    // the x interval and visit only the objects inside it, so a rule costs
+    // O(log n + hits) instead of a scan over every object.
+    //
+    // Holds a pointer to the indexed model: rebuild after the model
+    // changes and do not query after it is destroyed.
+    class MarkingIndex {
+    public:
+        void build(const MarkingObjectModel& model);
+        void clear() noexcept;
+
+        const MarkingObjectModel* model() const noexcept { return model_; }
+        std::size_t size() const noexcept { return model_ ? model_->size() : 0; }
+        std::size_t count(laneproto::MarkingClassId class_id) const noexcept;
+
+        // visit(const MarkingObject&) for every object of the class with
+        // x_min <= x <= x_max, in increasing x
+        template<typename Visit>
+        void forEachInRange(laneproto::MarkingClassId class_id,
+                            float x_min, float x_max, Visit&& visit) const
+        {
+            const Bucket* bucket = find(class_id);
+            if (!bucket)
+                return;
+            const auto first = std::lower_bound(bucket->x.begin(), bucket->x.end(), x_min);
+            for (auto it = first; it != bucket->x.end() && *it <= x_max; ++it)
+                visit((*model_)[bucket->index[static_cast<std::size_t>(it - bucket->x.begin())]]);
+        }
+
+        // As forEachInRange, also limited to y_min <= y <= y_max
+        template<typename Visit>
+        void forEachInCorridor(laneproto::MarkingClassId class_id,
+                               float x_min, float x_max, float y_min, float y_max,
+                               Visit&& visit) const
+        {
+            const Bucket* bucket = find(class_id);
+            if (!bucket)
+                return;
+            const auto first = std::lower_bound(bucket->x.begin(), bucket->x.end(), x_min);
+            for (auto it = first; it != bucket->x.end() && *it <= x_max; ++it) {
+                const std::size_t i = static_cast<std::size_t>(it - bucket->x.begin());
+                if (bucket->y[i] >= y_min && bucket->y[i] <= y_max)
+                    visit((*model_)[bucket->index[i]]);
+            }
+        }
+
+        // Up to k objects of the class nearest to (x, y), closest first.
+        // Reuses out's storage.
+        void nearest(laneproto::MarkingClassId class_id, float x, float y,
+                     std::size_t k, std::vector<MarkingNeighbor>& out) const;
+
+    private:
+        struct Bucket {
+            std::vector<float> x;           // sorted
+            std::vector<float> y;
+            std::vector<std::uint32_t> index;
+        };
+
+        struct Entry {
+            float x;
+            float y;
+            std::uint32_t index;
+            laneproto::MarkingClassId class_id;
+        };
+
+        const Bucket* find(laneproto::MarkingClassId class_id) const noexcept {
+            const auto slot = static_cast<std::size_t>(class_id);
+            return model_ && slot < buckets_.size() && !buckets_[slot].x.empty() ? &buckets_[slot] : nullptr;
+        }
+
+        const MarkingObjectModel* model_ = nullptr;
+        std::vector<Bucket> buckets_;       // by class id
+        std::vector<Entry> entries_;        // build scratch
+    };
+
+}
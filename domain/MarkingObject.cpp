@@ -48,6 +48,14 @@ namespace domain {
         return flags_;
     }
 
+    std::uint32_t MarkingObject::trackId() const noexcept {
+        return track_id_;
+    }
+
+    void MarkingObject::setTrackId(std::uint32_t track_id) noexcept {
+        track_id_ = track_id;
+    }
+
     bool MarkingObject::isCrosswalk() const noexcept {
         return class_id_ == laneproto::MarkingClassId::Crosswalk;
     }
@@ -77,7 +85,8 @@ namespace domain {
 
     std::ostream& operator<<(std::ostream& os, const MarkingObject& obj) {
         os << "MarkingObject{"
-           << " class_id=" << static_cast<int>(obj.classId())
+           << " track_id=" << obj.trackId()
+           << ", class_id=" << static_cast<int>(obj.classId())
            << ", x_m=" << obj.xMeters()
            << ", y_m=" << obj.yMeters()
            << ", length_m=" << obj.lengthMeters()
@@ -132,6 +141,10 @@ namespace domain {
         return objects_;
     }
 
+    void MarkingObjectModel::setTrackId(std::size_t index, std::uint32_t track_id) noexcept {
+        objects_[index].setTrackId(track_id);
+    }
+
     laneproto::TimestampMs MarkingObjectModel::timestampMs() const noexcept {
         return timestamp_ms_;
     }
@@ -16,6 +16,7 @@ namespace domain {
         float yaw_deg_ = 0.0f;
         std::uint8_t confidence_ = 0;
         std::uint8_t flags_ = 0;
+        std::uint32_t track_id_ = 0;
 
     public:
         MarkingObject() noexcept = default;
@@ -32,6 +33,11 @@ namespace domain {
         std::uint8_t confidence() const noexcept;
         std::uint8_t rawFlags() const noexcept;
 
+        // Assigned by MarkingTracker; 0 until the object has been seen long
+        // enough to be confirmed
+        std::uint32_t trackId() const noexcept;
+        void setTrackId(std::uint32_t track_id) noexcept;
+
         bool isCrosswalk() const noexcept;
         bool isArrow() const noexcept;
         bool hasFlag(std::uint8_t mask) const noexcept;
@@ -63,6 +69,8 @@ namespace domain {
         const MarkingObject& operator[](std::size_t index) const noexcept;
         const std::vector<MarkingObject>& objects() const noexcept;
 
+        void setTrackId(std::size_t index, std::uint32_t track_id) noexcept;
+
         laneproto::TimestampMs timestampMs() const noexcept;
         laneproto::SequenceNumber seq() const noexcept;
 
@@ -0,0 +1,126 @@
+#include "MarkingTracker.h"
+#include <algorithm>
+
+namespace domain {
+
+    MarkingTracker::MarkingTracker(const MarkingTrackerConfig& config)
+        : config_(config)
+    {
+    }
+
+    std::size_t MarkingTracker::confirmedCount() const noexcept {
+        return static_cast<std::size_t>(std::count_if(tracks_.begin(), tracks_.end(),
+            [](const MarkingTrack& track) { return track.id != 0; }));
+    }
+
+    void MarkingTracker::reset() noexcept {
+        tracks_.clear();
+        last_timestamp_ms_ = 0;
+    }
+
+    void MarkingTracker::update(MarkingObjectModel& model, std::uint64_t timestamp_ms) {
+        // A sensor restart or a long outage: nothing predicted from before is
+        // worth matching against
+        if (last_timestamp_ms_ != 0 &&
+            (timestamp_ms < last_timestamp_ms_ || timestamp_ms - last_timestamp_ms_ > config_.reset_gap_ms))
+            tracks_.clear();
+
+        const float dt_s = !tracks_.empty() && timestamp_ms > last_timestamp_ms_
+            ? static_cast<float>(timestamp_ms - last_timestamp_ms_) / 1000.0f : 0.0f;
+        last_timestamp_ms_ = timestamp_ms;
+
+        for (auto& track : tracks_) {
+            track.x_m += track.vx_mps * dt_s;
+            track.y_m += track.vy_mps * dt_s;
+        }
+
+        const std::size_t detections = model.size();
+        detections_.clear();
+        for (const auto& obj : model)
+            detections_.push_back({obj.xMeters(), obj.yMeters(), obj.classId()});
+
+        // Gated candidate pairs; markings are spread out, so there are few
+        candidates_.clear();
+        for (std::uint32_t t = 0; t < tracks_.size(); ++t) {
+            const MarkingTrack& track = tracks_[t];
+            const float gate = config_.gate_m + config_.gate_growth_m * track.missed;
+            const float gate2 = gate * gate;
+            for (std::uint32_t d = 0; d < detections; ++d) {
+                const Detection& detection = detections_[d];
+                if (detection.class_id != track.class_id)
+                    continue;
+                const float dx = detection.x_m - track.x_m;
+                const float dy = detection.y_m - track.y_m;
+                const float distance2 = dx * dx + dy * dy;
+                if (distance2 <= gate2)
+                    candidates_.push_back({distance2, t, d});
+            }
+        }
+        std::sort(candidates_.begin(), candidates_.end(),
+                  [](const Candidate& a, const Candidate& b) { return a.distance2 < b.distance2; });
+
+        track_match_.assign(tracks_.size(), -1);
+        detection_matched_.assign(detections, 0);
+        for (const Candidate& candidate : candidates_) {
+            if (track_match_[candidate.track] >= 0 || detection_matched_[candidate.detection])
+                continue;
+            track_match_[candidate.track] = static_cast<std::int32_t>(candidate.detection);
+            detection_matched_[candidate.detection] = 1;
+        }
+
+        // Correct matched tracks, coast or drop the others
+        std::size_t kept = 0;
+        for (std::size_t t = 0; t < tracks_.size(); ++t) {
+            MarkingTrack track = tracks_[t];
+            const std::int32_t match = track_match_[t];
+
+            if (match >= 0) {
+                const Detection& detection = detections_[static_cast<std::size_t>(match)];
+                const float rx = detection.x_m - track.x_m;
+                const float ry = detection.y_m - track.y_m;
+                if (track.hits == 1 && dt_s > 0.0f) {
+                    // Second sighting: the two positions are the best velocity there is
+                    track.x_m = detection.x_m;
+                    track.y_m = detection.y_m;
+                    track.vx_mps = rx / dt_s;
+                    track.vy_mps = ry / dt_s;
+                } else {
+                    track.x_m += config_.alpha * rx;
+                    track.y_m += config_.alpha * ry;
+                    if (dt_s > 0.0f) {
+                        track.vx_mps += config_.beta * rx / dt_s;
+                        track.vy_mps += config_.beta * ry / dt_s;
+                    }
+                }
+                track.missed = 0;
+                if (track.hits < UINT16_MAX)
+                    ++track.hits;
+                if (track.id == 0 && track.hits >= config_.confirm_hits)
+                    track.id = next_id_++;
+                model.setTrackId(static_cast<std::size_t>(match), track.id);
+            } else {
+                ++track.missed;
+                if (track.id == 0 || track.missed > config_.max_missed)
+                    continue;
+            }
+            tracks_[kept++] = track;
+        }
+        tracks_.resize(kept);
+
+        // Unmatched detections start tentative tracks
+        for (std::size_t d = 0; d < detections; ++d) {
+            if (detection_matched_[d])
+                continue;
+            const Detection& detection = detections_[d];
+            MarkingTrack track;
+            track.class_id = detection.class_id;
+            track.x_m = detection.x_m;
+            track.y_m = detection.y_m;
+            track.hits = 1;
+            if (config_.confirm_hits <= 1)
+                track.id = next_id_++;
+            model.setTrackId(d, track.id);
+            tracks_.push_back(track);
+        }
+    }
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "MarkingObject.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace domain {
+
+    struct MarkingTrackerConfig {
+        float gate_m = 2.5f;                // max distance between prediction and detection
+        float gate_growth_m = 0.5f;         // added to the gate per missed frame
+        std::uint16_t confirm_hits = 3;     // consecutive detections before a track gets an id
+        std::uint16_t max_missed = 5;       // frames a confirmed track coasts before it is dropped
+        float alpha = 0.7f;                 // position correction gain
+        float beta = 0.3f;                  // velocity correction gain
+        std::uint64_t reset_gap_ms = 1000;  // longer gaps (or time going back) drop all tracks
+    };
+
+    struct MarkingTrack {
+        std::uint32_t id = 0;               // 0 while tentative
+        laneproto::MarkingClassId class_id{};
+        float x_m = 0.0f;
+        float y_m = 0.0f;
+        float vx_mps = 0.0f;                // in the vehicle frame, so static markings move
+        float vy_mps = 0.0f;
+        std::uint16_t hits = 0;
+        std::uint16_t missed = 0;
+    };
+
+    // Associates marking objects across frames and writes stable track ids
+    // into the model.
+    //
+    // Each track is predicted forward at constant velocity, then detections
+    // of the same class are assigned greedily, nearest pair first, within a
+    // gate around the prediction. A matched track is corrected with an
+    // alpha-beta filter. New detections start tentative tracks that get an
+    // id after confirm_hits consecutive matches and die on their first miss;
+    // confirmed tracks survive max_missed missed frames, so an object that
+    // drops out for a frame or two keeps its id.
+    //
+    // Allocation-free once its buffers have grown to the largest frame.
+    // Not thread-safe; ConnectionManager uses it on the GUI thread.
+    class MarkingTracker {
+    public:
+        explicit MarkingTracker(const MarkingTrackerConfig& config = {});
+
+        const MarkingTrackerConfig& config() const noexcept { return config_; }
+        void setConfig(const MarkingTrackerConfig& config) noexcept { config_ = config; }
+
+        // timestamp_ms: the model's sensor time, unwrapped
+        void update(MarkingObjectModel& model, std::uint64_t timestamp_ms);
+
+        const std::vector<MarkingTrack>& tracks() const noexcept { return tracks_; }
+        std::size_t confirmedCount() const noexcept;
+
+        void reset() noexcept;
+
+    private:
+        struct Detection {
+            float x_m;
+            float y_m;
+            laneproto::MarkingClassId class_id;
+        };
+
+        struct Candidate {
+            float distance2;
+            std::uint32_t track;
+            std::uint32_t detection;
+        };
+
+        MarkingTrackerConfig config_;
+        std::vector<MarkingTrack> tracks_;
+        std::uint32_t next_id_ = 1;
+        std::uint64_t last_timestamp_ms_ = 0;
+
+        // Per-update scratch
+        std::vector<Detection> detections_;
+        std::vector<Candidate> candidates_;
+        std::vector<std::int32_t> track_match_;     // detection index or -1
+        std::vector<std::uint8_t> detection_matched_;
+    };
+}
@@ -0,0 +1,171 @@
+#include "SensorTimebase.h"
+#include <chrono>
+#include <cmath>
+
+namespace domain {
+
+    namespace {
+        constexpr std::uint32_t kHalfRange = 0x80000000u;
+
+        std::uint64_t extend(std::uint32_t epoch, std::uint32_t raw) noexcept {
+            return (static_cast<std::uint64_t>(epoch) << 32) | raw;
+        }
+    }
+
+    std::uint64_t hostClockMs() noexcept {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    SensorTimebase::SensorTimebase(const SensorTimebaseConfig& config) noexcept
+        : config_(config)
+    {
+    }
+
+    void SensorTimebase::setConfig(const SensorTimebaseConfig& config) noexcept {
+        config_ = config;
+        restartFit();
+    }
+
+    std::uint64_t SensorTimebase::unwrap(std::uint32_t sensor_ms) noexcept {
+        if (!has_last_) {
+            has_last_ = true;
+            last_raw_ = sensor_ms;
+            return extend(wraps_, sensor_ms);
+        }
+
+        // Unsigned difference: a step forward is anything under half the range
+        if (static_cast<std::uint32_t>(sensor_ms - last_raw_) < kHalfRange) {
+            if (sensor_ms < last_raw_)
+                ++wraps_;
+            last_raw_ = sensor_ms;
+            return extend(wraps_, sensor_ms);
+        }
+
+        // A little behind the newest: a late message, possibly from before the last wrap
+        if (static_cast<std::uint32_t>(last_raw_ - sensor_ms) <= config_.max_backstep_ms) {
+            const bool before_wrap = sensor_ms > last_raw_ && wraps_ > 0;
+            return extend(before_wrap ? wraps_ - 1 : wraps_, sensor_ms);
+        }
+
+        // Far behind: the sensor restarted its counter
+        ++restarts_;
+        wraps_ = 0;
+        last_raw_ = sensor_ms;
+        restartFit();
+        return sensor_ms;
+    }
+
+    std::uint64_t SensorTimebase::observe(std::uint32_t sensor_ms, std::uint64_t host_ms) noexcept {
+        return addSample(unwrap(sensor_ms), host_ms);
+    }
+
+    std::uint64_t SensorTimebase::addSample(std::uint64_t sensor_ms, std::uint64_t host_ms) noexcept {
+        const std::int64_t y_abs = static_cast<std::int64_t>(host_ms) - static_cast<std::int64_t>(sensor_ms);
+        if (samples_ == 0) {
+            x_anchor_ = sensor_ms;
+            x_first_ = sensor_ms;
+            y_anchor_ = y_abs;
+        }
+        if (sensor_ms > x_anchor_)
+            shiftAnchor(sensor_ms);
+
+        const double dx = static_cast<double>(static_cast<std::int64_t>(sensor_ms - x_anchor_));
+        const double y = static_cast<double>(y_abs - y_anchor_);
+        const double residual = y - (offset_ + drift_ * dx);
+
+        double weight = 1.0;
+        if (samples_ >= config_.min_samples) {
+            const bool late = residual > config_.late_threshold_ms;
+            const bool early = residual < -config_.late_threshold_ms;
+            outliers_ = (late || early) ? outliers_ + 1 : 0;
+
+            if (outliers_ >= config_.max_outliers) {
+                ++restarts_;
+                restartFit();
+                return addSample(sensor_ms, host_ms);
+            }
+            if (late)
+                weight = 0.05;      // delayed in transit; says little about the clocks
+        }
+
+        const double lambda = 1.0 - 1.0 / std::fmax(config_.window_samples, 2.0);
+        s0_ = lambda * s0_ + weight;
+        sx_ = lambda * sx_ + weight * dx;
+        sy_ = lambda * sy_ + weight * y;
+        sxx_ = lambda * sxx_ + weight * dx * dx;
+        sxy_ = lambda * sxy_ + weight * dx * y;
+        if (weight == 1.0)
+            residual_ms2_ = samples_ == 0 ? 0.0 : lambda * residual_ms2_ + (1.0 - lambda) * residual * residual;
+
+        ++samples_;
+        solve();
+        return sensor_ms;
+    }
+
+    void SensorTimebase::shiftAnchor(std::uint64_t x) noexcept {
+        const double d = static_cast<double>(x - x_anchor_);
+        sxx_ = sxx_ - 2.0 * d * sx_ + d * d * s0_;
+        sxy_ = sxy_ - d * sy_;
+        sx_ = sx_ - d * s0_;
+        offset_ += drift_ * d;
+        x_anchor_ = x;
+    }
+
+    void SensorTimebase::solve() noexcept {
+        if (s0_ <= 0.0)
+            return;
+
+        const double det = s0_ * sxx_ - sx_ * sx_;
+        if (hasDrift() && det > 1e-9 * s0_ * sxx_) {
+            drift_ = (s0_ * sxy_ - sx_ * sy_) / det;
+            offset_ = (sy_ - drift_ * sx_) / s0_;
+        } else {
+            drift_ = 0.0;
+            offset_ = sy_ / s0_;
+        }
+    }
+
+    std::uint64_t SensorTimebase::toHostMs(std::uint64_t sensor_ms) const noexcept {
+        if (samples_ == 0)
+            return sensor_ms;
+
+        const double dx = static_cast<double>(static_cast<std::int64_t>(sensor_ms - x_anchor_));
+        const double y = static_cast<double>(y_anchor_) + offset_ + drift_ * dx;
+        const std::int64_t host = static_cast<std::int64_t>(sensor_ms) + std::llround(y);
+        return host > 0 ? static_cast<std::uint64_t>(host) : 0;
+    }
+
+    bool SensorTimebase::hasDrift() const noexcept {
+        return samples_ >= config_.min_samples && x_anchor_ - x_first_ >= config_.min_span_ms;
+    }
+
+    double SensorTimebase::offsetMs() const noexcept {
+        return static_cast<double>(y_anchor_) + offset_;
+    }
+
+    double SensorTimebase::driftPpm() const noexcept {
+        return drift_ * 1e6;
+    }
+
+    double SensorTimebase::residualMs() const noexcept {
+        return std::sqrt(residual_ms2_);
+    }
+
+    void SensorTimebase::restartFit() noexcept {
+        samples_ = 0;
+        s0_ = sx_ = sy_ = sxx_ = sxy_ = 0.0;
+        offset_ = 0.0;
+        drift_ = 0.0;
+        residual_ms2_ = 0.0;
+        outliers_ = 0;
+    }
+
+    void SensorTimebase::reset() noexcept {
+        restartFit();
+        has_last_ = false;
+        last_raw_ = 0;
+        wraps_ = 0;
+        restarts_ = 0;
+    }
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstdint>
+
+namespace domain {
+
+    // Host monotonic clock in milliseconds. Video frames and message arrival
+    // times are stamped with it, so everything aligned against sensor data
+    // shares one clock that neither NTP nor the user can step.
+    std::uint64_t hostClockMs() noexcept;
+
+    struct SensorTimebaseConfig {
+        double window_samples = 500.0;      // effective length of the fit's memory
+        std::uint32_t min_samples = 8;      // before that only the offset is estimated
+        std::uint64_t min_span_ms = 2000;   // sensor time the samples must cover for a drift estimate
+        double late_threshold_ms = 30.0;    // arrivals this far behind the fit count as delayed
+        std::uint32_t max_outliers = 20;    // consecutive bad samples that mean the clock jumped
+        std::uint32_t max_backstep_ms = 1000;   // larger backward steps are a sensor restart
+    };
+
+    // Maps sensor timestamps (laneproto::TimestampMs, a 32-bit millisecond
+    // counter that wraps every ~49.7 days) onto hostClockMs().
+    //
+    // unwrap() extends the counter to 64 bits. observe() also feeds the
+    // estimator with (sensor time, host arrival time) pairs. The fit is an
+    // exponentially weighted least-squares line host - sensor = offset +
+    // drift * sensor. Network delay only ever makes a message late, so
+    // arrivals well behind the line get a small weight, while early ones
+    // pull the line down at full weight. A long run of samples that do not
+    // fit at all (sensor reboot, host suspend) restarts the estimate.
+    //
+    // Not thread-safe; ConnectionManager uses it on the GUI thread.
+    class SensorTimebase {
+    public:
+        explicit SensorTimebase(const SensorTimebaseConfig& config = {}) noexcept;
+
+        const SensorTimebaseConfig& config() const noexcept { return config_; }
+        void setConfig(const SensorTimebaseConfig& config) noexcept;
+
+        std::uint64_t unwrap(std::uint32_t sensor_ms) noexcept;
+
+        // unwrap() plus an estimator update; returns the unwrapped time
+        std::uint64_t observe(std::uint32_t sensor_ms, std::uint64_t host_ms) noexcept;
+
+        // Host time of an unwrapped sensor timestamp; sensor_ms itself until
+        // the first observation
+        std::uint64_t toHostMs(std::uint64_t sensor_ms) const noexcept;
+
+        bool hasOffset() const noexcept { return samples_ > 0; }
+        bool hasDrift() const noexcept;
+        double offsetMs() const noexcept;       // host - sensor at the latest sample
+        double driftPpm() const noexcept;
+        double residualMs() const noexcept;     // RMS of recent on-time samples
+        std::uint32_t wraps() const noexcept { return wraps_; }
+        std::uint32_t restarts() const noexcept { return restarts_; }
+
+        void reset() noexcept;
+
+    private:
+        SensorTimebaseConfig config_;
+
+        // Unwrapping
+        bool has_last_ = false;
+        std::uint32_t last_raw_ = 0;
+        std::uint32_t wraps_ = 0;
+        std::uint32_t restarts_ = 0;
+
+        // Fit of y = host - sensor against x = sensor, both relative to the
+        // anchors so the sums stay small; the x anchor follows the newest
+        // sample
+        std::uint64_t samples_ = 0;
+        std::uint64_t x_anchor_ = 0;
+        std::int64_t y_anchor_ = 0;
+        std::uint64_t x_first_ = 0;
+        double s0_ = 0.0, sx_ = 0.0, sy_ = 0.0, sxx_ = 0.0, sxy_ = 0.0;
+        double offset_ = 0.0;       // relative to y_anchor_, at x_anchor_
+        double drift_ = 0.0;        // ms per ms
+        double residual_ms2_ = 0.0;
+        std::uint32_t outliers_ = 0;
+
+        std::uint64_t addSample(std::uint64_t sensor_ms, std::uint64_t host_ms) noexcept;
+        void restartFit() noexcept;
+        void shiftAnchor(std::uint64_t x) noexcept;
+        void solve() noexcept;
+    };
+}
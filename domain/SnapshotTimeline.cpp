@@ -0,0 +1,163 @@
+#include "SnapshotTimeline.h"
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <utility>
+
+namespace domain {
+
+    namespace {
+        bool earlierThan(std::uint64_t timestamp_ms, const DomainSnapshotPtr& snapshot) {
+            return timestamp_ms < snapshot->timestamp_ms;
+        }
+
+        std::uint64_t distance(std::uint64_t a, std::uint64_t b) {
+            return a > b ? a - b : b - a;
+        }
+
+        bool sameOffsets(const LaneState& a, const LaneState& b) {
+            return a.leftOffsetMeters() == b.leftOffsetMeters() && a.rightOffsetMeters() == b.rightOffsetMeters();
+        }
+    }
+
+    SnapshotTimeline::SnapshotTimeline(const AlignmentConfig& config)
+        : config_(config)
+    {
+    }
+
+    void SnapshotTimeline::setConfig(const AlignmentConfig& config) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        config_ = config;
+        while (history_.size() > std::max<std::size_t>(config_.history, 1))
+            history_.pop_front();
+        interpolated_.reset();
+    }
+
+    AlignmentConfig SnapshotTimeline::config() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return config_;
+    }
+
+    void SnapshotTimeline::record(DomainSnapshotPtr snapshot) {
+        if (!snapshot || snapshot->timestamp_ms == 0)
+            return;
+
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        // Sensor data arrives in order almost always, so this is normally an append
+        auto it = std::upper_bound(history_.begin(), history_.end(), snapshot->timestamp_ms, earlierThan);
+        if (it != history_.begin() && (*std::prev(it))->timestamp_ms == snapshot->timestamp_ms) {
+            *std::prev(it) = std::move(snapshot);
+        } else {
+            history_.insert(it, std::move(snapshot));
+            if (history_.size() > std::max<std::size_t>(config_.history, 1))
+                history_.pop_front();
+        }
+    }
+
+    void SnapshotTimeline::clear() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        history_.clear();
+        interpolated_.reset();
+    }
+
+    std::size_t SnapshotTimeline::size() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return history_.size();
+    }
+
+    SnapshotAlignment SnapshotTimeline::align(std::uint64_t frame_timestamp_ms) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        SnapshotAlignment result;
+        if (history_.empty())
+            return result;
+
+        result.snapshot = history_.back();
+        if (frame_timestamp_ms == 0)
+            return result;
+
+        const std::uint64_t reference = frame_timestamp_ms > config_.hold_back_ms
+            ? frame_timestamp_ms - config_.hold_back_ms : 0;
+
+        const auto after_it = std::upper_bound(history_.begin(), history_.end(), reference, earlierThan);
+        const DomainSnapshotPtr before = after_it != history_.begin() ? *std::prev(after_it) : nullptr;
+        const DomainSnapshotPtr after = after_it != history_.end() ? *after_it : nullptr;
+
+        const DomainSnapshotPtr& nearest = !before ? after
+            : !after ? before
+            : (distance(before->timestamp_ms, reference) <= distance(after->timestamp_ms, reference) ? before : after);
+
+        result.error_ms = static_cast<std::int64_t>(nearest->timestamp_ms) - static_cast<std::int64_t>(reference);
+        if (distance(nearest->timestamp_ms, reference) > config_.max_skew_ms)
+            return result;
+
+        result.aligned = true;
+        result.snapshot = nearest;
+
+        if (config_.interpolate_lane && before && after && before->timestamp_ms != reference &&
+            before->lane.isValid() && after->lane.isValid() &&
+            before->lane_host_ms != 0 && after->lane_host_ms != 0 &&
+            before->lane.seq() != after->lane.seq() && !sameOffsets(before->lane, after->lane)) {
+            result.snapshot = interpolate(before, after, reference);
+            result.interpolated = true;
+        }
+        return result;
+    }
+
+    DomainSnapshotPtr SnapshotTimeline::snapshotFor(std::uint64_t frame_timestamp_ms) const {
+        return align(frame_timestamp_ms).snapshot;
+    }
+
+    DomainSnapshotPtr SnapshotTimeline::interpolate(const DomainSnapshotPtr& before, const DomainSnapshotPtr& after,
+                                                    std::uint64_t reference_ms) const {
+        const bool same_pair = interpolated_ && interpolated_from_ == before->version &&
+                               interpolated_to_ == after->version;
+        if (same_pair && interpolated_reference_ == reference_ms)
+            return interpolated_;
+
+        // The lane's own times on the host clock, not the snapshots': a
+        // snapshot may be newer only because markings changed
+        const double from_ms = static_cast<double>(before->lane_host_ms);
+        const double to_ms = static_cast<double>(after->lane_host_ms);
+        const float t = to_ms > from_ms
+            ? static_cast<float>((static_cast<double>(reference_ms) - from_ms) / (to_ms - from_ms))
+            : 1.0f;
+
+        const DomainSnapshotPtr& nearer = t < 0.5f ? before : after;
+        const LaneState lane = LaneState::interpolate(before->lane, after->lane, t);
+
+        if (same_pair && interpolated_base_ == nearer->version) {
+            // Past either end t is clamped and the lane stops moving; keep
+            // the version so overlays don't redraw an identical lane
+            if (sameOffsets(lane, interpolated_->lane)) {
+                interpolated_reference_ = reference_ms;
+                return interpolated_;
+            }
+            // Readers only copy it under mutex_, so held only by us means
+            // nobody can be reading it; skip copying markings and warnings
+            if (interpolated_.use_count() == 1) {
+                std::atomic_thread_fence(std::memory_order_acquire);
+                interpolated_->lane = lane;
+                interpolated_->timestamp_ms = reference_ms;
+                interpolated_->lane_host_ms = reference_ms;
+                interpolated_->version = next_interpolated_version_++;
+                interpolated_reference_ = reference_ms;
+                return interpolated_;
+            }
+        }
+
+        auto snapshot = std::make_shared<DomainSnapshot>(*nearer);
+        snapshot->lane = lane;
+        snapshot->timestamp_ms = reference_ms;
+        snapshot->lane_host_ms = reference_ms;
+        snapshot->version = next_interpolated_version_++;
+
+        interpolated_ = std::move(snapshot);
+        interpolated_from_ = before->version;
+        interpolated_to_ = after->version;
+        interpolated_base_ = nearer->version;
+        interpolated_reference_ = reference_ms;
+        return interpolated_;
+    }
+}
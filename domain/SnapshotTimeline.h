@@ -0,0 +1,72 @@
+#pragma once
+
+#include "DomainSnapshot.h"
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+
+namespace domain {
+
+    struct AlignmentConfig {
+        std::size_t history = 64;           // snapshots kept, oldest dropped first
+        std::uint64_t max_skew_ms = 100;    // farther than this from any snapshot: not aligned
+        std::uint64_t hold_back_ms = 0;     // frames are paired with data this much older
+        bool interpolate_lane = true;       // blend lane offsets between the two nearest snapshots
+    };
+
+    struct SnapshotAlignment {
+        DomainSnapshotPtr snapshot;     // null only while the timeline is empty
+        std::int64_t error_ms = 0;      // nearest snapshot time minus the frame's reference time
+        bool aligned = false;           // false: out of skew or no frame time, snapshot is the newest
+        bool interpolated = false;
+    };
+
+    // Recent snapshots ordered by sensor time, for pairing each video frame
+    // with the domain state it actually shows. Thread-safe; align() may be
+    // called from frame processing workers while record() runs on the GUI
+    // thread.
+    //
+    // A frame at time T is matched against data at T - hold_back_ms. Holding
+    // back lets late sensor data arrive, so the reference time usually has a
+    // snapshot on both sides and the lane can be interpolated instead of
+    // snapped to the nearer one.
+    class SnapshotTimeline : public SnapshotSource {
+    public:
+        explicit SnapshotTimeline(const AlignmentConfig& config = {});
+
+        void setConfig(const AlignmentConfig& config);
+        AlignmentConfig config() const;
+
+        // Snapshots without a timestamp are ignored; one with the same
+        // timestamp as a recorded snapshot replaces it
+        void record(DomainSnapshotPtr snapshot);
+        void clear();
+        std::size_t size() const;
+
+        SnapshotAlignment align(std::uint64_t frame_timestamp_ms) const;
+        DomainSnapshotPtr snapshotFor(std::uint64_t frame_timestamp_ms) const override;
+
+    private:
+        // Interpolated snapshots get versions of their own so that overlay
+        // caches keyed on the version see them as new; their content_version
+        // stays that of the snapshot they copy
+        static constexpr std::uint64_t kInterpolatedVersionBit = std::uint64_t{1} << 63;
+
+        mutable std::mutex mutex_;
+        AlignmentConfig config_;
+        std::deque<DomainSnapshotPtr> history_;     // ascending timestamp_ms
+
+        // Last interpolation, reused while frames keep asking for it and
+        // updated in place once no reader holds it
+        mutable std::shared_ptr<DomainSnapshot> interpolated_;
+        mutable std::uint64_t interpolated_from_ = 0;
+        mutable std::uint64_t interpolated_to_ = 0;
+        mutable std::uint64_t interpolated_base_ = 0;       // version of the snapshot it copies
+        mutable std::uint64_t interpolated_reference_ = 0;
+        mutable std::uint64_t next_interpolated_version_ = kInterpolatedVersionBit;
+
+        DomainSnapshotPtr interpolate(const DomainSnapshotPtr& before, const DomainSnapshotPtr& after,
+                                      std::uint64_t reference_ms) const;
+    };
+}
@@ -2,9 +2,161 @@
 #include <ostream>
 #include <stdexcept>
 #include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <deque>
+#include <locale>
+#include <memory>
+#include <mutex>
+#include <sstream>
 
 namespace domain {
 
+    namespace {
+
+        struct MessageSegment {
+            std::uint32_t literal_begin;
+            std::uint32_t literal_size;
+            int param;                      // -1: literal only
+            float scale;
+        };
+
+        struct MessagePattern {
+            std::string pattern;
+            std::string literals;
+            std::vector<MessageSegment> segments;
+            std::vector<std::string> names;
+        };
+
+        // Patterns are immutable once interned and never freed. format()
+        // reads the current table without locking; intern() publishes a copy
+        // with the new pattern appended and keeps the old tables alive, as a
+        // reader may still hold one. Tables only change when rules are
+        // compiled, so the copies are few and small.
+        struct MessageTable {
+            std::vector<const MessagePattern*> patterns{nullptr};   // index 0 is the empty message
+        };
+
+        std::mutex intern_mutex;
+        std::deque<MessagePattern> pattern_storage;                 // guarded by intern_mutex
+        std::vector<std::unique_ptr<const MessageTable>> tables;    // every table published
+        std::atomic<const MessageTable*> current_table{nullptr};
+
+        void appendInteger(std::string& out, int value) {
+            char digits[16];
+            const int length = std::snprintf(digits, sizeof(digits), "%d", value);
+            out.append(digits, static_cast<std::size_t>(length));
+        }
+
+        bool parseScale(const std::string& text, float& out) {
+            std::istringstream in(text);
+            in.imbue(std::locale::classic());
+            float value = 0.0f;
+            if (!(in >> value) || !(in >> std::ws).eof() || !std::isfinite(value))
+                return false;
+            out = value;
+            return true;
+        }
+
+        bool parsePattern(const std::string& text, MessagePattern& out, std::string& error) {
+            out.pattern = text;
+            std::size_t pos = 0;
+            while (pos < text.size()) {
+                const std::size_t open = text.find('{', pos);
+                const std::size_t literal_end = open == std::string::npos ? text.size() : open;
+                MessageSegment segment{static_cast<std::uint32_t>(out.literals.size()),
+                                       static_cast<std::uint32_t>(literal_end - pos), -1, 1.0f};
+                out.literals.append(text, pos, literal_end - pos);
+                pos = literal_end;
+
+                if (open != std::string::npos) {
+                    const std::size_t close = text.find('}', open);
+                    if (close == std::string::npos) {
+                        error = "unclosed '{' in message";
+                        return false;
+                    }
+                    std::string name = text.substr(open + 1, close - open - 1);
+                    const std::size_t star = name.find('*');
+                    if (star != std::string::npos) {
+                        if (!parseScale(name.substr(star + 1), segment.scale)) {
+                            error = "bad scale in message placeholder {" + name + "}";
+                            return false;
+                        }
+                        name.resize(star);
+                    }
+                    auto found = std::find(out.names.begin(), out.names.end(), name);
+                    if (found == out.names.end()) {
+                        if (out.names.size() == WarningMessages::kMaxParams) {
+                            error = "more than " + std::to_string(WarningMessages::kMaxParams)
+                                    + " distinct placeholders in message";
+                            return false;
+                        }
+                        found = out.names.insert(out.names.end(), name);
+                    }
+                    segment.param = static_cast<int>(found - out.names.begin());
+                    pos = close + 1;
+                }
+                out.segments.push_back(segment);
+            }
+            return true;
+        }
+
+    }
+
+    bool WarningMessages::intern(const std::string& pattern, std::uint16_t& id,
+                                 std::vector<std::string>& names, std::string& error) {
+        std::lock_guard<std::mutex> lock(intern_mutex);
+        const MessageTable* table = current_table.load(std::memory_order_relaxed);
+        if (table) {
+            for (std::size_t i = 1; i < table->patterns.size(); ++i) {
+                if (table->patterns[i]->pattern == pattern) {
+                    id = static_cast<std::uint16_t>(i);
+                    names = table->patterns[i]->names;
+                    return true;
+                }
+            }
+        }
+
+        MessagePattern parsed;
+        if (!parsePattern(pattern, parsed, error))
+            return false;
+        const std::size_t count = table ? table->patterns.size() : 1;
+        if (count > UINT16_MAX) {
+            error = "too many distinct warning messages";
+            return false;
+        }
+
+        pattern_storage.push_back(std::move(parsed));
+        auto next = std::make_unique<MessageTable>();
+        if (table)
+            next->patterns = table->patterns;
+        next->patterns.push_back(&pattern_storage.back());
+
+        id = static_cast<std::uint16_t>(count);
+        names = pattern_storage.back().names;
+        current_table.store(next.get(), std::memory_order_release);
+        tables.push_back(std::move(next));
+        return true;
+    }
+
+    void WarningMessages::format(std::uint16_t id, const float* params, std::string& out) {
+        const MessageTable* table = current_table.load(std::memory_order_acquire);
+        if (!table || id == 0 || id >= table->patterns.size())
+            return;
+        const MessagePattern& pattern = *table->patterns[id];
+        for (const MessageSegment& segment : pattern.segments) {
+            out.append(pattern.literals, segment.literal_begin, segment.literal_size);
+            if (segment.param < 0)
+                continue;
+            const float value = params[segment.param] * segment.scale;
+            if (std::isfinite(value) && std::fabs(value) < 1e9f)
+                appendInteger(out, static_cast<int>(value));
+            else
+                out += '?';
+        }
+    }
+
     Warning::Warning(WarningType type, WarningSeverity severity, std::uint64_t timestamp_ms,
                      float distance_m, std::uint8_t confidence)
         : type_(type)
@@ -35,8 +187,18 @@ namespace domain {
         return confidence_;
     }
 
-    const std::string& Warning::message() const noexcept {
-        return message_;
+    std::string Warning::message() const {
+        std::string text;
+        appendMessage(text);
+        return text;
+    }
+
+    void Warning::appendMessage(std::string& out) const {
+        WarningMessages::format(message_id_, message_params_.data(), out);
+    }
+
+    bool Warning::hasSameMessage(const Warning& other) const noexcept {
+        return message_id_ == other.message_id_ && message_params_ == other.message_params_;
     }
 
     bool Warning::isActive() const noexcept {
@@ -63,18 +225,32 @@ namespace domain {
         confidence_ = confidence;
     }
 
-    void Warning::setMessage(const std::string& message) {
-        message_ = message;
-    }
-
-    void Warning::setMessage(std::string&& message) noexcept {
-        message_ = std::move(message);
+    void Warning::setMessage(std::uint16_t message_id, const float* params, std::size_t count) noexcept {
+        message_id_ = message_id;
+        message_params_.fill(0.0f);
+        std::copy_n(params, std::min(count, message_params_.size()), message_params_.begin());
     }
 
     void Warning::setActive(bool active) noexcept {
         active_ = active;
     }
 
+    std::uint32_t Warning::sourceId() const noexcept {
+        return source_id_;
+    }
+
+    void Warning::setSourceId(std::uint32_t source_id) noexcept {
+        source_id_ = source_id;
+    }
+
+    std::uint16_t Warning::ruleId() const noexcept {
+        return rule_id_;
+    }
+
+    void Warning::setRuleId(std::uint16_t rule_id) noexcept {
+        rule_id_ = rule_id;
+    }
+
     bool Warning::isCritical() const noexcept {
         return severity_ == WarningSeverity::Critical;
     }
@@ -97,7 +273,10 @@ namespace domain {
         timestamp_ms_ = 0;
         distance_m_ = 0.0f;
         confidence_ = 0;
-        message_.clear();
+        source_id_ = 0;
+        rule_id_ = 0;
+        message_id_ = 0;
+        message_params_.fill(0.0f);
         active_ = false;
     }
 
@@ -142,8 +321,9 @@ namespace domain {
            << ", confidence=" << static_cast<int>(warning.confidence())
            << ", active=" << std::boolalpha << warning.isActive() << std::noboolalpha;
 
-        if (!warning.message().empty()) {
-            os << ", message=\"" << warning.message() << "\"";
+        const std::string message = warning.message();
+        if (!message.empty()) {
+            os << ", message=\"" << message << "\"";
         }
 
         os << " }";
@@ -160,6 +340,11 @@ namespace domain {
         valid_ = true;
     }
 
+    void WarningModel::swapWarnings(std::vector<Warning>& warnings) noexcept {
+        warnings_.swap(warnings);
+        valid_ = true;
+    }
+
     std::size_t WarningModel::size() const noexcept {
         return warnings_.size();
     }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <cstdint>
 #include <string>
 #include <vector>
@@ -22,6 +23,25 @@ namespace domain {
         Critical
     };
 
+    // Process-wide table of message patterns. Patterns are interned when
+    // rules are compiled; a Warning carries the pattern id and numeric
+    // parameters, and the text is built only when something displays it.
+    class WarningMessages {
+    public:
+        static constexpr std::size_t kMaxParams = 4;
+
+        // "{name}" or "{name*scale}" placeholders, printed as integers. An
+        // already interned pattern returns its existing id. names receives
+        // the distinct placeholder names in parameter order. Returns false
+        // on a malformed pattern or more than kMaxParams names.
+        static bool intern(const std::string& pattern, std::uint16_t& id,
+                           std::vector<std::string>& names, std::string& error);
+
+        // Appends the message for id (0: none) to out. Lock-free, so display
+        // code on any thread can call it while rules are being compiled.
+        static void format(std::uint16_t id, const float* params, std::string& out);
+    };
+
     class Warning {
     private:
         WarningType type_ = WarningType::Unknown;
@@ -29,7 +49,10 @@ namespace domain {
         std::uint64_t timestamp_ms_ = 0;
         float distance_m_ = 0.0f;
         std::uint8_t confidence_ = 0;
-        std::string message_;
+        std::uint32_t source_id_ = 0;
+        std::uint16_t rule_id_ = 0;
+        std::uint16_t message_id_ = 0;
+        std::array<float, WarningMessages::kMaxParams> message_params_{};
         bool active_ = false;
 
     public:
@@ -44,17 +67,26 @@ namespace domain {
         std::uint64_t timestampMs() const noexcept;
         float distanceMeters() const noexcept;
         std::uint8_t confidence() const noexcept;
-        const std::string& message() const noexcept;
+        // Formatted on each call; appendMessage() reuses the caller's buffer
+        std::string message() const;
+        void appendMessage(std::string& out) const;
+        bool hasSameMessage(const Warning& other) const noexcept;
         bool isActive() const noexcept;
+        // Track id of the object that raised the warning, 0 if none
+        std::uint32_t sourceId() const noexcept;
+        // 1-based index of the WarningEngine rule that raised it, 0 if none
+        std::uint16_t ruleId() const noexcept;
 
         void setType(WarningType type) noexcept;
         void setSeverity(WarningSeverity severity) noexcept;
         void setTimestampMs(std::uint64_t timestamp_ms) noexcept;
         void setDistanceMeters(float distance_m) noexcept;
         void setConfidence(std::uint8_t confidence) noexcept;
-        void setMessage(const std::string& message);
-        void setMessage(std::string&& message) noexcept;
+        // params: one value per name intern() returned for the pattern
+        void setMessage(std::uint16_t message_id, const float* params, std::size_t count) noexcept;
         void setActive(bool active) noexcept;
+        void setSourceId(std::uint32_t source_id) noexcept;
+        void setRuleId(std::uint16_t rule_id) noexcept;
 
         bool isCritical() const noexcept;
         bool isConfident(std::uint8_t threshold = 50) const noexcept;
@@ -85,6 +117,10 @@ namespace domain {
 
         void addWarning(const Warning& warning);
         void addWarning(Warning&& warning);
+        // Takes warnings' contents and hands back the previous ones' storage,
+        // so a caller-owned buffer and the model trade capacity instead of
+        // allocating
+        void swapWarnings(std::vector<Warning>& warnings) noexcept;
 
         std::size_t size() const noexcept;
         bool empty() const noexcept;
@@ -1,131 +1,89 @@
 #include "WarningEngine.h"
-#include <cmath>
-#include <string>
+#include <utility>
 
 namespace domain {
 
-    WarningEngine::WarningEngine(const WarningEngineConfig& config) noexcept
-        : config_(config)
-    {}
-
-    const WarningEngineConfig& WarningEngine::config() const noexcept {
-        return config_;
-    }
-
-    void WarningEngine::setConfig(const WarningEngineConfig& config) noexcept {
-        config_ = config;
-    }
-
-    Warning WarningEngine::makeCrosswalkWarning(const MarkingObject& obj,
-                                                std::uint64_t timestamp_ms) const {
-        float distance = obj.xMeters();
-        WarningSeverity severity = WarningSeverity::Warning;
-
-        if (distance < config_.crosswalk_critical_distance_m) {
-            severity = WarningSeverity::Critical;
+    std::vector<WarningRuleSpec> defaultWarningRules(const WarningEngineConfig& config) {
+        std::vector<WarningRuleSpec> rules;
+
+        if (config.enable_crosswalk_warnings) {
+            WarningRuleSpec crosswalk;
+            crosswalk.name = "crosswalk_ahead";
+            crosswalk.type = WarningType::CrosswalkAhead;
+            crosswalk.subject = WarningSubject::Marking;
+            crosswalk.marking_class = laneproto::MarkingClassId::Crosswalk;
+            crosswalk.when = {
+                {WarningField::X, WarningCompare::GreaterEqual, 0.0f},
+                {WarningField::X, WarningCompare::LessEqual, config.crosswalk_distance_threshold_m},
+                {WarningField::Confidence, WarningCompare::GreaterEqual, static_cast<float>(config.min_marking_confidence)},
+            };
+            crosswalk.critical_when = {
+                {WarningField::X, WarningCompare::Less, config.crosswalk_critical_distance_m},
+            };
+            crosswalk.message = "Crosswalk ahead at {x} m";
+            rules.push_back(std::move(crosswalk));
         }
 
-        Warning w{
-            WarningType::CrosswalkAhead,
-            severity,
-            timestamp_ms,
-            distance,
-            obj.confidence()
-        };
-
-        std::string msg = "Crosswalk ahead at ";
-        msg += std::to_string(static_cast<int>(distance));
-        msg += " m";
-        w.setMessage(std::move(msg));
+        if (config.enable_lane_departure_warnings) {
+            WarningRuleSpec left;
+            left.name = "lane_departure_left";
+            left.type = WarningType::LaneDepartureLeft;
+            left.when = {
+                {WarningField::LaneQuality, WarningCompare::GreaterEqual, static_cast<float>(config.min_lane_quality)},
+                {WarningField::OffsetsValid, WarningCompare::Equal, 1.0f},
+                {WarningField::CenterOffset, WarningCompare::Less, -config.lane_departure_offset_threshold_m},
+            };
+            left.message = "Lane departure left: offset {abs_center_offset*100} cm";
 
-        return w;
-    }
+            WarningRuleSpec right = left;
+            right.name = "lane_departure_right";
+            right.type = WarningType::LaneDepartureRight;
+            right.when.back() = {WarningField::CenterOffset, WarningCompare::Greater, config.lane_departure_offset_threshold_m};
+            right.message = "Lane departure right: offset {abs_center_offset*100} cm";
 
-    void WarningEngine::addCrosswalkWarnings(const MarkingObjectModel& markings,
-                                             std::uint64_t timestamp_ms,
-                                             std::vector<Warning>& out) const {
-        if (!config_.enable_crosswalk_warnings) {
-            return;
+            rules.push_back(std::move(left));
+            rules.push_back(std::move(right));
         }
 
-        for (const auto& obj : markings) {
-            if (!obj.isCrosswalk()) {
-                continue;
-            }
-
-            if (!obj.isConfident(config_.min_marking_confidence)) {
-                continue;
-            }
-
-            float distance = obj.xMeters();
-            if (distance < 0.0f || distance > config_.crosswalk_distance_threshold_m) {
-                continue;
-            }
-
-            out.push_back(makeCrosswalkWarning(obj, timestamp_ms));
-        }
+        return rules;
     }
 
-    void WarningEngine::addLaneDepartureWarnings(const LaneState& lane,
-                                                  std::uint64_t timestamp_ms,
-                                                  std::vector<Warning>& out) const {
-        if (!config_.enable_lane_departure_warnings) {
-            return;
-        }
+    WarningEngine::WarningEngine()
+    {
+        setConfig(config_);
+    }
 
-        if (!lane.isValid()) {
-            return;
-        }
+    WarningEngine::WarningEngine(const WarningEngineConfig& config)
+    {
+        setConfig(config);
+    }
 
-        if (!lane.isQualityGood(config_.min_lane_quality)) {
-            return;
-        }
+    const WarningEngineConfig& WarningEngine::config() const noexcept {
+        return config_;
+    }
 
-        if (!lane.hasValidOffsets()) {
-            return;
-        }
+    bool WarningEngine::setConfig(const WarningEngineConfig& config, std::string* error) {
+        config_ = config;
 
-        float center_offset = lane.centerOffsetMeters();
+        std::string compile_error;
+        if (WarningProgram::compile(config.rules.empty() ? defaultWarningRules(config) : config.rules,
+                                    program_, compile_error))
+            return true;
 
-        if (center_offset < -config_.lane_departure_offset_threshold_m) {
-            Warning w{
-                WarningType::LaneDepartureLeft,
-                WarningSeverity::Warning,
-                timestamp_ms,
-                std::fabs(center_offset),
-                lane.qualityRaw()
-            };
-            std::string msg = "Lane departure left: offset ";
-            msg += std::to_string(static_cast<int>(std::fabs(center_offset) * 100));
-            msg += " cm";
-            w.setMessage(std::move(msg));
-            out.push_back(std::move(w));
-        } else if (center_offset > config_.lane_departure_offset_threshold_m) {
-            Warning w{
-                WarningType::LaneDepartureRight,
-                WarningSeverity::Warning,
-                timestamp_ms,
-                std::fabs(center_offset),
-                lane.qualityRaw()
-            };
-            std::string msg = "Lane departure right: offset ";
-            msg += std::to_string(static_cast<int>(std::fabs(center_offset) * 100));
-            msg += " cm";
-            w.setMessage(std::move(msg));
-            out.push_back(std::move(w));
-        }
+        if (error)
+            *error = std::move(compile_error);
+        WarningProgram::compile(defaultWarningRules(config), program_, compile_error);
+        return false;
     }
 
-    std::vector<Warning> WarningEngine::update(const LaneState& lane,
-                                               const MarkingObjectModel& markings,
-                                               std::uint64_t timestamp_ms) const {
-        std::vector<Warning> result;
-        result.reserve(8);
-
-        addCrosswalkWarnings(markings, timestamp_ms, result);
-        addLaneDepartureWarnings(lane, timestamp_ms, result);
+    std::size_t WarningEngine::ruleCount() const noexcept {
+        return program_.ruleCount();
+    }
 
-        return result;
+    void WarningEngine::update(const LaneState& lane, const MarkingIndex& markings,
+                               std::uint64_t timestamp_ms, std::vector<Warning>& out) {
+        out.clear();
+        program_.run(lane, markings, timestamp_ms, out);
     }
 
-}
\ No newline at end of file
+}
@@ -1,9 +1,13 @@
 #pragma once
 
 #include "LaneState.h"
+#include "MarkingIndex.h"
 #include "MarkingObject.h"
 #include "Warning.h"
+#include "WarningRules.h"
 #include <cstdint>
+#include <string>
+#include <vector>
 
 
 namespace domain {
@@ -16,33 +20,35 @@ namespace domain {
         std::uint8_t min_lane_quality = 60;
         bool enable_crosswalk_warnings = true;
         bool enable_lane_departure_warnings = true;
+        // Rules from the config's warning section; when empty, the built-in
+        // crosswalk and lane departure rules are made from the fields above
+        std::vector<WarningRuleSpec> rules;
     };
 
+    // The built-in rules, with thresholds from config
+    std::vector<WarningRuleSpec> defaultWarningRules(const WarningEngineConfig& config);
+
     class WarningEngine {
     public:
-        WarningEngine() = default;
-        explicit WarningEngine(const WarningEngineConfig& config) noexcept;
+        WarningEngine();
+        explicit WarningEngine(const WarningEngineConfig& config);
 
         const WarningEngineConfig& config() const noexcept;
-        void setConfig(const WarningEngineConfig& config) noexcept;
+        // Compiles the config's rules. On an invalid rule returns false with
+        // error set and runs the built-in rules instead; ConfigurationManager
+        // rejects such configs before they get here.
+        bool setConfig(const WarningEngineConfig& config, std::string* error = nullptr);
+
+        std::size_t ruleCount() const noexcept;
 
-        std::vector<Warning> update(const LaneState& lane,
-                                    const MarkingObjectModel& markings,
-                                    std::uint64_t timestamp_ms) const;
+        // markings: index built from the current MarkingObjectModel. out is
+        // cleared and refilled; reusing it keeps the update allocation-free.
+        void update(const LaneState& lane, const MarkingIndex& markings,
+                    std::uint64_t timestamp_ms, std::vector<Warning>& out);
 
     private:
         WarningEngineConfig config_{};
-
-        void addCrosswalkWarnings(const MarkingObjectModel& markings,
-                                  std::uint64_t timestamp_ms,
-                                  std::vector<Warning>& out) const;
-
-        void addLaneDepartureWarnings(const LaneState& lane,
-                                      std::uint64_t timestamp_ms,
-                                      std::vector<Warning>& out) const;
-
-        Warning makeCrosswalkWarning(const MarkingObject& obj,
-                                     std::uint64_t timestamp_ms) const;
+        WarningProgram program_;
     };
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,426 @@
+#include "WarningRules.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <locale>
+#include <sstream>
+
+namespace domain {
+
+    namespace {
+
+        constexpr std::size_t kFieldCount = static_cast<std::size_t>(WarningField::Count);
+
+        bool isLaneField(WarningField field) noexcept {
+            return field < WarningField::X;
+        }
+
+        std::string ruleLabel(const WarningRuleSpec& spec, std::size_t index) {
+            return spec.name.empty() ? "#" + std::to_string(index + 1) : "'" + spec.name + "'";
+        }
+
+        // Classic locale: the GUI sets the user's, where 0.3 may be 0,3
+        bool parseNumber(const std::string& text, float& out) {
+            std::istringstream in(text);
+            in.imbue(std::locale::classic());
+            float value = 0.0f;
+            if (!(in >> value) || !(in >> std::ws).eof() || !std::isfinite(value))
+                return false;
+            out = value;
+            return true;
+        }
+
+        float holdThreshold(WarningCompare op, float value, float margin) noexcept {
+            switch (op) {
+                case WarningCompare::Less:
+                case WarningCompare::LessEqual:
+                    return value + margin;
+                case WarningCompare::Greater:
+                case WarningCompare::GreaterEqual:
+                    return value - margin;
+                case WarningCompare::Equal:
+                case WarningCompare::NotEqual:
+                    break;
+            }
+            return value;
+        }
+
+        // Narrows [min, max] by a condition on the value; != leaves it alone
+        void narrow(WarningCompare op, float threshold, float& min, float& max) noexcept {
+            const auto bits = static_cast<std::uint8_t>(op);
+            const bool less = bits & static_cast<std::uint8_t>(WarningCompare::Less);
+            const bool greater = bits & static_cast<std::uint8_t>(WarningCompare::Greater);
+            if (less && !greater)
+                max = std::min(max, threshold);
+            else if (greater && !less)
+                min = std::max(min, threshold);
+            else if (!less && !greater) {
+                min = std::max(min, threshold);
+                max = std::min(max, threshold);
+            }
+        }
+
+    }
+
+    const char* warningFieldName(WarningField field) noexcept {
+        switch (field) {
+            case WarningField::LaneQuality:     return "lane_quality";
+            case WarningField::OffsetsValid:    return "offsets_valid";
+            case WarningField::CenterOffset:    return "center_offset";
+            case WarningField::AbsCenterOffset: return "abs_center_offset";
+            case WarningField::LeftOffset:      return "left_offset";
+            case WarningField::RightOffset:     return "right_offset";
+            case WarningField::LaneWidth:       return "lane_width";
+            case WarningField::LaneTypeLeft:    return "lane_type_left";
+            case WarningField::LaneTypeRight:   return "lane_type_right";
+            case WarningField::X:               return "x";
+            case WarningField::Y:               return "y";
+            case WarningField::AbsY:            return "abs_y";
+            case WarningField::Length:          return "length";
+            case WarningField::Width:           return "width";
+            case WarningField::Yaw:             return "yaw";
+            case WarningField::Confidence:      return "confidence";
+            case WarningField::Area:            return "area";
+            case WarningField::TrackId:         return "track_id";
+            case WarningField::Count:           break;
+        }
+        return "unknown";
+    }
+
+    bool warningFieldFromString(const std::string& name, WarningField& out) noexcept {
+        for (std::size_t i = 0; i < kFieldCount; ++i) {
+            const auto field = static_cast<WarningField>(i);
+            if (name == warningFieldName(field)) {
+                out = field;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    const char* warningTypeName(WarningType type) noexcept {
+        switch (type) {
+            case WarningType::CrosswalkAhead:       return "crosswalk_ahead";
+            case WarningType::LaneDepartureLeft:    return "lane_departure_left";
+            case WarningType::LaneDepartureRight:   return "lane_departure_right";
+            case WarningType::SolidLineCross:       return "solid_line_cross";
+            case WarningType::Custom:               return "custom";
+            case WarningType::Unknown:              break;
+        }
+        return "unknown";
+    }
+
+    bool warningTypeFromString(const std::string& name, WarningType& out) noexcept {
+        for (auto type : {WarningType::CrosswalkAhead, WarningType::LaneDepartureLeft,
+                          WarningType::LaneDepartureRight, WarningType::SolidLineCross,
+                          WarningType::Custom}) {
+            if (name == warningTypeName(type)) {
+                out = type;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    const char* warningSeverityName(WarningSeverity severity) noexcept {
+        switch (severity) {
+            case WarningSeverity::Info:     return "info";
+            case WarningSeverity::Warning:  return "warning";
+            case WarningSeverity::Critical: return "critical";
+        }
+        return "unknown";
+    }
+
+    bool warningSeverityFromString(const std::string& name, WarningSeverity& out) noexcept {
+        for (auto severity : {WarningSeverity::Info, WarningSeverity::Warning, WarningSeverity::Critical}) {
+            if (name == warningSeverityName(severity)) {
+                out = severity;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool warningSubjectFromString(const std::string& name, WarningSubject& subject,
+                                  laneproto::MarkingClassId& marking_class) noexcept {
+        if (name == "lane") {
+            subject = WarningSubject::Lane;
+            return true;
+        }
+        subject = WarningSubject::Marking;
+        if (name == "crosswalk")
+            marking_class = laneproto::MarkingClassId::Crosswalk;
+        else if (name == "arrow")
+            marking_class = laneproto::MarkingClassId::Arrow;
+        else if (name == "unknown")
+            marking_class = laneproto::MarkingClassId::Unknown;
+        else
+            return false;
+        return true;
+    }
+
+    bool parseWarningCondition(const std::string& text, WarningCondition& out) noexcept {
+        try {
+            std::istringstream in(text);
+            std::string field_name;
+            std::string op_name;
+            std::string value_text;
+            if (!(in >> field_name >> op_name >> value_text) || !(in >> std::ws).eof())
+                return false;
+
+            WarningCondition condition;
+            if (!warningFieldFromString(field_name, condition.field) ||
+                !parseNumber(value_text, condition.value))
+                return false;
+
+            static const std::pair<const char*, WarningCompare> ops[] = {
+                {"<", WarningCompare::Less},        {"<=", WarningCompare::LessEqual},
+                {"==", WarningCompare::Equal},      {"!=", WarningCompare::NotEqual},
+                {">=", WarningCompare::GreaterEqual}, {">", WarningCompare::Greater},
+            };
+            const auto op = std::find_if(std::begin(ops), std::end(ops),
+                                         [&op_name](const auto& entry) { return op_name == entry.first; });
+            if (op == std::end(ops))
+                return false;
+
+            condition.op = op->second;
+            out = condition;
+            return true;
+        } catch (...) {
+            return false;
+        }
+    }
+
+    bool WarningProgram::compile(const std::vector<WarningRuleSpec>& rules,
+                                 WarningProgram& out, std::string& error) {
+        WarningProgram program;
+        constexpr float inf = std::numeric_limits<float>::infinity();
+
+        for (std::size_t r = 0; r < rules.size(); ++r) {
+            const WarningRuleSpec& spec = rules[r];
+            if (!spec.enabled)
+                continue;
+            const std::string label = "Warning rule " + ruleLabel(spec, r);
+            const bool lane_rule = spec.subject == WarningSubject::Lane;
+
+            if (spec.when.empty()) {
+                error = label + " has no conditions";
+                return false;
+            }
+
+            Rule rule{};
+            rule.first = static_cast<std::uint32_t>(program.instructions_.size());
+            rule.when_count = static_cast<std::uint32_t>(spec.when.size());
+            rule.critical_count = static_cast<std::uint32_t>(spec.critical_when.size());
+            rule.x_min = rule.y_min = -inf;
+            rule.x_max = rule.y_max = inf;
+            rule.min_duration_ms = spec.min_duration_ms;
+            rule.type = spec.type;
+            rule.severity = spec.severity;
+            rule.subject = spec.subject;
+            rule.marking_class = spec.marking_class;
+            rule.distance = spec.distance != WarningField::Count ? spec.distance
+                : lane_rule ? WarningField::AbsCenterOffset : WarningField::X;
+            rule.confidence = spec.confidence != WarningField::Count ? spec.confidence
+                : lane_rule ? WarningField::LaneQuality : WarningField::Confidence;
+
+            for (const auto& [field, margin] : spec.hysteresis) {
+                if (field >= WarningField::Count || !std::isfinite(margin) || margin < 0.0f) {
+                    error = label + ": hysteresis must be a non-negative number";
+                    return false;
+                }
+            }
+            const auto margin_for = [&spec](WarningField field) {
+                float margin = 0.0f;
+                for (const auto& entry : spec.hysteresis) {
+                    if (entry.first == field)
+                        margin = entry.second;
+                }
+                return margin;
+            };
+
+            for (const auto* conditions : {&spec.when, &spec.critical_when}) {
+                for (const WarningCondition& condition : *conditions) {
+                    if (condition.field >= WarningField::Count || !std::isfinite(condition.value)) {
+                        error = label + ": invalid condition";
+                        return false;
+                    }
+                    if (lane_rule && !isLaneField(condition.field)) {
+                        error = label + ": lane rules cannot test marking field "
+                                + warningFieldName(condition.field);
+                        return false;
+                    }
+                    const float hold = holdThreshold(condition.op, condition.value, margin_for(condition.field));
+                    program.instructions_.push_back({condition.field, static_cast<std::uint8_t>(condition.op),
+                                                     {condition.value, hold}});
+                }
+            }
+
+            if (!lane_rule) {
+                // Corridor from the looser thresholds, so objects still
+                // inside their hysteresis band are visited
+                for (std::uint32_t i = rule.first; i < rule.first + rule.when_count; ++i) {
+                    const Instruction& instruction = program.instructions_[i];
+                    const auto op = static_cast<WarningCompare>(instruction.accept);
+                    const float threshold = instruction.threshold[1];
+                    if (instruction.field == WarningField::X)
+                        narrow(op, threshold, rule.x_min, rule.x_max);
+                    else if (instruction.field == WarningField::Y)
+                        narrow(op, threshold, rule.y_min, rule.y_max);
+                    else if (instruction.field == WarningField::AbsY &&
+                             (op == WarningCompare::Less || op == WarningCompare::LessEqual)) {
+                        rule.y_min = std::max(rule.y_min, -threshold);
+                        rule.y_max = std::min(rule.y_max, threshold);
+                    }
+                }
+            }
+
+            if (rule.distance >= WarningField::Count || rule.confidence >= WarningField::Count ||
+                (lane_rule && (!isLaneField(rule.distance) || !isLaneField(rule.confidence)))) {
+                error = label + ": invalid distance or confidence field";
+                return false;
+            }
+
+            std::vector<std::string> names;
+            std::string message_error;
+            if (!WarningMessages::intern(spec.message, rule.message_id, names, message_error)) {
+                error = label + ": " + message_error;
+                return false;
+            }
+            rule.message_param_count = static_cast<std::uint8_t>(names.size());
+            for (std::size_t i = 0; i < names.size(); ++i) {
+                if (!warningFieldFromString(names[i], rule.message_params[i]) ||
+                    (lane_rule && !isLaneField(rule.message_params[i]))) {
+                    error = label + ": unknown field in message placeholder {" + names[i] + "}";
+                    return false;
+                }
+            }
+
+            program.rules_.push_back(rule);
+        }
+
+        program.states_.resize(program.rules_.size());
+        out = std::move(program);
+        return true;
+    }
+
+    void WarningProgram::resetState() noexcept {
+        for (auto& states : states_)
+            states.clear();
+        last_timestamp_ms_ = 0;
+    }
+
+    bool WarningProgram::test(std::uint32_t first, std::uint32_t count, int holding,
+                              const Values& values) const noexcept {
+        unsigned pass = 1;
+        for (std::uint32_t i = first; i < first + count; ++i) {
+            const Instruction& instruction = instructions_[i];
+            const float value = values[static_cast<std::size_t>(instruction.field)];
+            const float threshold = instruction.threshold[holding];
+            // 0 less, 1 equal, 2 greater; NaN fails every comparison
+            const unsigned outcome = unsigned(value >= threshold) + unsigned(value > threshold);
+            pass &= (instruction.accept >> outcome) & unsigned(value == value);
+        }
+        return pass != 0;
+    }
+
+    void WarningProgram::evaluate(std::uint32_t rule_index, std::uint32_t subject, bool stateful,
+                                  const Values& values, std::uint64_t timestamp_ms,
+                                  std::vector<Warning>& out) {
+        const Rule& rule = rules_[rule_index];
+        std::vector<SubjectState>& states = states_[rule_index];
+
+        // A state exists only while the rule held on the previous update
+        SubjectState* state = nullptr;
+        if (stateful) {
+            const auto found = std::find_if(states.begin(), states.end(),
+                [subject](const SubjectState& s) { return s.subject == subject; });
+            if (found != states.end())
+                state = &*found;
+        }
+        const int holding = state ? 1 : 0;
+
+        if (!test(rule.first, rule.when_count, holding, values))
+            return;
+
+        if (stateful && !state) {
+            states.push_back({subject, generation_, timestamp_ms});
+            state = &states.back();
+        }
+        if (state)
+            state->generation = generation_;
+
+        if (rule.min_duration_ms != 0 && (!state || timestamp_ms - state->since_ms < rule.min_duration_ms))
+            return;
+
+        const bool critical = rule.critical_count != 0 &&
+            test(rule.first + rule.when_count, rule.critical_count, holding, values);
+        const float confidence = values[static_cast<std::size_t>(rule.confidence)];
+
+        Warning warning{
+            rule.type,
+            critical ? WarningSeverity::Critical : rule.severity,
+            timestamp_ms,
+            values[static_cast<std::size_t>(rule.distance)],
+            static_cast<std::uint8_t>(std::isfinite(confidence) ? std::clamp(confidence, 0.0f, 255.0f) : 0.0f)
+        };
+        float params[WarningMessages::kMaxParams];
+        for (std::size_t i = 0; i < rule.message_param_count; ++i)
+            params[i] = values[static_cast<std::size_t>(rule.message_params[i])];
+        warning.setMessage(rule.message_id, params, rule.message_param_count);
+        warning.setSourceId(rule.subject == WarningSubject::Marking ? subject : 0);
+        warning.setRuleId(static_cast<std::uint16_t>(std::min<std::uint32_t>(rule_index + 1, UINT16_MAX)));
+        out.push_back(std::move(warning));
+    }
+
+    void WarningProgram::run(const LaneState& lane, const MarkingIndex& markings,
+                             std::uint64_t timestamp_ms, std::vector<Warning>& out) {
+        if (timestamp_ms < last_timestamp_ms_)
+            resetState();
+        last_timestamp_ms_ = timestamp_ms;
+        ++generation_;
+
+        Values values{};
+        const auto set = [&values](WarningField field, float value) {
+            values[static_cast<std::size_t>(field)] = value;
+        };
+        set(WarningField::LaneQuality, lane.qualityRaw());
+        set(WarningField::OffsetsValid, lane.hasValidOffsets() ? 1.0f : 0.0f);
+        set(WarningField::CenterOffset, lane.centerOffsetMeters());
+        set(WarningField::AbsCenterOffset, std::fabs(lane.centerOffsetMeters()));
+        set(WarningField::LeftOffset, lane.leftOffsetMeters());
+        set(WarningField::RightOffset, lane.rightOffsetMeters());
+        set(WarningField::LaneWidth, lane.laneWidthMeters());
+        set(WarningField::LaneTypeLeft, static_cast<float>(lane.laneTypeLeft()));
+        set(WarningField::LaneTypeRight, static_cast<float>(lane.laneTypeRight()));
+
+        for (std::uint32_t r = 0; r < rules_.size(); ++r) {
+            const Rule& rule = rules_[r];
+            if (rule.subject == WarningSubject::Lane) {
+                if (lane.isValid())
+                    evaluate(r, 0, true, values, timestamp_ms, out);
+            } else {
+                markings.forEachInCorridor(rule.marking_class, rule.x_min, rule.x_max, rule.y_min, rule.y_max,
+                                           [&](const MarkingObject& obj) {
+                    set(WarningField::X, obj.xMeters());
+                    set(WarningField::Y, obj.yMeters());
+                    set(WarningField::AbsY, std::fabs(obj.yMeters()));
+                    set(WarningField::Length, obj.lengthMeters());
+                    set(WarningField::Width, obj.widthMeters());
+                    set(WarningField::Yaw, obj.yawDeg());
+                    set(WarningField::Confidence, obj.confidence());
+                    set(WarningField::Area, obj.area());
+                    set(WarningField::TrackId, static_cast<float>(obj.trackId()));
+                    evaluate(r, obj.trackId(), obj.trackId() != 0, values, timestamp_ms, out);
+                });
+            }
+
+            // Subjects the rule no longer holds for lose their state
+            auto& states = states_[r];
+            states.erase(std::remove_if(states.begin(), states.end(),
+                             [this](const SubjectState& s) { return s.generation != generation_; }),
+                         states.end());
+        }
+    }
+
+}
@@ -0,0 +1,159 @@
+#pragma once
+
+#include "LaneState.h"
+#include "MarkingIndex.h"
+#include "Warning.h"
+#include <array>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace domain {
+
+    // Values a rule condition can test. Lane fields come from the current
+    // LaneState, marking fields from the object a marking rule is looking at.
+    enum class WarningField : std::uint8_t {
+        LaneQuality = 0,
+        OffsetsValid,           // 1 when both offsets are finite and ordered
+        CenterOffset,
+        AbsCenterOffset,
+        LeftOffset,
+        RightOffset,
+        LaneWidth,
+        LaneTypeLeft,
+        LaneTypeRight,
+
+        X,
+        Y,
+        AbsY,
+        Length,
+        Width,
+        Yaw,
+        Confidence,
+        Area,
+        TrackId,
+
+        Count
+    };
+
+    // One bit per outcome of value vs threshold: less, equal, greater
+    enum class WarningCompare : std::uint8_t {
+        Less = 1,
+        Equal = 2,
+        LessEqual = 3,
+        Greater = 4,
+        NotEqual = 5,
+        GreaterEqual = 6,
+    };
+
+    enum class WarningSubject : std::uint8_t {
+        Lane,                   // evaluated once per update while the lane is valid
+        Marking,                // evaluated per object of one class
+    };
+
+    struct WarningCondition {
+        WarningField field = WarningField::X;
+        WarningCompare op = WarningCompare::Less;
+        float value = 0.0f;
+    };
+
+    struct WarningRuleSpec {
+        std::string name;
+        bool enabled = true;
+        WarningType type = WarningType::Custom;
+        WarningSeverity severity = WarningSeverity::Warning;
+        WarningSubject subject = WarningSubject::Lane;
+        laneproto::MarkingClassId marking_class{};
+        std::vector<WarningCondition> when;             // all must hold
+        std::vector<WarningCondition> critical_when;    // all hold: raised as Critical
+        // Once a rule holds for a subject its thresholds on the field are
+        // relaxed by the margin, so values near a threshold don't flicker
+        std::vector<std::pair<WarningField, float>> hysteresis;
+        std::uint32_t min_duration_ms = 0;              // conditions must hold this long first
+        WarningField distance = WarningField::Count;    // Count: x, or |center offset| for lane rules
+        WarningField confidence = WarningField::Count;  // Count: confidence, or lane quality
+        std::string message;                            // {field} or {field*scale}, see WarningMessages
+    };
+
+    const char* warningFieldName(WarningField field) noexcept;
+    bool warningFieldFromString(const std::string& name, WarningField& out) noexcept;
+    const char* warningTypeName(WarningType type) noexcept;
+    bool warningTypeFromString(const std::string& name, WarningType& out) noexcept;
+    const char* warningSeverityName(WarningSeverity severity) noexcept;
+    bool warningSeverityFromString(const std::string& name, WarningSeverity& out) noexcept;
+    // "lane", or a marking class: "crosswalk", "arrow", "unknown"
+    bool warningSubjectFromString(const std::string& name, WarningSubject& subject,
+                                  laneproto::MarkingClassId& marking_class) noexcept;
+    // "<field> <op> <number>", op one of < <= == != >= >
+    bool parseWarningCondition(const std::string& text, WarningCondition& out) noexcept;
+
+    // Rules compiled into flat instruction arrays. Each condition becomes a
+    // field slot, an accepted-outcome mask and a threshold pair (as written,
+    // relaxed by hysteresis); evaluation compares without branching on the
+    // operator. Marking rules turn their bounds on x and y into a corridor
+    // query on the MarkingIndex, so only objects that can pass are visited.
+    //
+    // Keeps per-rule hysteresis and duration state, keyed by track id for
+    // marking rules; objects without a track id are evaluated statelessly.
+    // Messages are interned at compile time, so once the output and state
+    // vectors have grown, run() does not allocate.
+    class WarningProgram {
+    public:
+        // Returns false with error set if a rule is invalid; out is left
+        // untouched then
+        static bool compile(const std::vector<WarningRuleSpec>& rules,
+                            WarningProgram& out, std::string& error);
+
+        std::size_t ruleCount() const noexcept { return rules_.size(); }
+
+        void run(const LaneState& lane, const MarkingIndex& markings,
+                 std::uint64_t timestamp_ms, std::vector<Warning>& out);
+
+        void resetState() noexcept;
+
+    private:
+        struct Instruction {
+            WarningField field;
+            std::uint8_t accept;            // WarningCompare bits
+            float threshold[2];             // [holding]
+        };
+
+        struct Rule {
+            std::uint32_t first;            // when, then critical_when
+            std::uint32_t when_count;
+            std::uint32_t critical_count;
+            float x_min, x_max, y_min, y_max;
+            std::uint32_t min_duration_ms;
+            WarningType type;
+            WarningSeverity severity;
+            WarningSubject subject;
+            laneproto::MarkingClassId marking_class;
+            WarningField distance;
+            WarningField confidence;
+            std::uint16_t message_id;
+            std::uint8_t message_param_count;
+            std::array<WarningField, WarningMessages::kMaxParams> message_params;
+        };
+
+        struct SubjectState {
+            std::uint32_t subject;          // track id; 0 for lane rules
+            std::uint32_t generation;       // last update it held
+            std::uint64_t since_ms;
+        };
+
+        using Values = float[static_cast<std::size_t>(WarningField::Count)];
+
+        bool test(std::uint32_t first, std::uint32_t count, int holding, const Values& values) const noexcept;
+        void evaluate(std::uint32_t rule_index, std::uint32_t subject, bool stateful,
+                      const Values& values, std::uint64_t timestamp_ms, std::vector<Warning>& out);
+
+        std::vector<Rule> rules_;
+        std::vector<Instruction> instructions_;
+
+        std::vector<std::vector<SubjectState>> states_;     // per rule
+        std::uint32_t generation_ = 0;
+        std::uint64_t last_timestamp_ms_ = 0;
+    };
+
+}
@@ -0,0 +1,244 @@
+#include "BinaryLog.hpp"
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace {
+    using namespace logger::binlog;
+
+    // Room for a definition with maximal strings and the largest record
+    constexpr std::size_t kMinFileBytes = 64 * 1024;
+
+    std::uint64_t steady_ns() noexcept {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    std::uint64_t wall_clock_ns() noexcept {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count());
+    }
+
+    std::uint16_t thread_number() noexcept {
+        static std::atomic<std::uint32_t> next{0};
+        thread_local const std::uint16_t number = static_cast<std::uint16_t>(next.fetch_add(1, std::memory_order_relaxed));
+        return number;
+    }
+
+    std::string system_error(const char* what, const std::string& path, int code) {
+        return std::string(what) + " " + path + ": " + std::strerror(code);
+    }
+
+    std::size_t encoded_size(const char* text) noexcept {
+        return sizeof(std::uint16_t) + std::min(std::strlen(text ? text : ""), kMaxStringBytes);
+    }
+
+    char* encode(char* out, const char* text) noexcept {
+        const std::uint16_t length = static_cast<std::uint16_t>(std::min(std::strlen(text ? text : ""), kMaxStringBytes));
+        std::memcpy(out, &length, sizeof(length));
+        if (length > 0)
+            std::memcpy(out + sizeof(length), text, length);
+        return out + sizeof(length) + length;
+    }
+
+    template<typename T>
+    char* encode(char* out, T value) noexcept {
+        std::memcpy(out, &value, sizeof(T));
+        return out + sizeof(T);
+    }
+}
+
+namespace logger {
+
+    BinaryLog& BinaryLog::instance() noexcept {
+        static BinaryLog log;
+        return log;
+    }
+
+    BinaryLog::~BinaryLog() {
+        close();
+    }
+
+    bool BinaryLog::open(const std::string& path, std::size_t file_bytes, std::uint32_t max_files, std::string& error) {
+        std::lock_guard<std::mutex> guard(mutex_);
+
+        open_.store(false);
+        close_file();
+
+        if (path.empty()) {
+            error = "binary log path is empty";
+            return false;
+        }
+        if (file_bytes < kMinFileBytes) {
+            error = "binary log files must be at least " + std::to_string(kMinFileBytes) + " bytes";
+            return false;
+        }
+
+        path_ = path;
+        capacity_ = file_bytes;
+        max_files_ = std::max<std::uint32_t>(max_files, 1);
+
+        // Whatever the previous run left becomes path.1
+        if (!rotate(error))
+            return false;
+
+        open_.store(true);
+        return true;
+    }
+
+    void BinaryLog::close() {
+        std::lock_guard<std::mutex> guard(mutex_);
+        open_.store(false);
+        close_file();
+    }
+
+    BinaryLogStats BinaryLog::stats() const {
+        std::lock_guard<std::mutex> guard(mutex_);
+        return stats_;
+    }
+
+    void BinaryLog::commit(BinaryLogSite& site, const char* signature, const binlog::RecordBuffer& payload) noexcept {
+        const std::uint64_t now_ns = steady_ns();
+        const std::uint16_t thread = thread_number();
+
+        std::lock_guard<std::mutex> guard(mutex_);
+        if (!mapping_)
+            return;     // closed after the caller's enabled() check
+
+        if (payload.overflow()) {
+            ++stats_.dropped;
+            return;
+        }
+
+        const std::size_t record_size = sizeof(RecordHeader) + payload.size();
+        bool defined = site.generation == generation_;
+        std::size_t needed = record_size + (defined ? 0 : definition_size(site, signature));
+
+        if (cursor_ + needed > capacity_) {
+            std::string error;
+            if (!rotate(error)) {
+                ++stats_.dropped;
+                open_.store(false);
+                Logger::instance().error() << "[BinaryLog] rotation failed, binary logging stopped: " << error;
+                return;
+            }
+            ++stats_.rotations;
+            defined = false;
+        }
+
+        const std::uint64_t timestamp_ns = now_ns > steady_base_ns_ ? now_ns - steady_base_ns_ : 0;
+        if (!defined)
+            append_definition(site, signature, thread, timestamp_ns);
+
+        // Payload before header: a record whose size is still zero is where
+        // a reader of a crashed run's file stops
+        char* out = mapping_ + cursor_;
+        std::memcpy(out + sizeof(RecordHeader), payload.data(), payload.size());
+        const RecordHeader header{static_cast<std::uint16_t>(record_size), thread, site.id, timestamp_ns};
+        std::memcpy(out, &header, sizeof(header));
+
+        cursor_ += record_size;
+        ++stats_.records;
+        stats_.bytes += record_size;
+    }
+
+    std::size_t BinaryLog::definition_size(const BinaryLogSite& site, const char* signature) const noexcept {
+        return sizeof(RecordHeader) + sizeof(std::uint32_t) + sizeof(std::uint8_t) + sizeof(std::uint32_t) +
+               encoded_size(site.file) + encoded_size(site.function) + encoded_size(site.format) +
+               encoded_size(signature);
+    }
+
+    void BinaryLog::append_definition(BinaryLogSite& site, const char* signature, std::uint16_t thread,
+                                      std::uint64_t timestamp_ns) noexcept {
+        site.id = next_id_++;
+        site.generation = generation_;
+
+        const std::size_t size = definition_size(site, signature);
+        char* out = mapping_ + cursor_ + sizeof(RecordHeader);
+        out = encode(out, site.id);
+        out = encode(out, static_cast<std::uint8_t>(site.level));
+        out = encode(out, site.line);
+        out = encode(out, site.file);
+        out = encode(out, site.function);
+        out = encode(out, site.format);
+        encode(out, signature);
+
+        const RecordHeader header{static_cast<std::uint16_t>(size), thread, kDefinitionId, timestamp_ns};
+        std::memcpy(mapping_ + cursor_, &header, sizeof(header));
+        cursor_ += size;
+        stats_.bytes += size;
+    }
+
+    bool BinaryLog::rotate(std::string& error) {
+        close_file();
+
+        // path.(n-2) -> path.(n-1), ..., path -> path.1; with a single file
+        // the old one is simply truncated
+        for (std::uint32_t index = max_files_ - 1; index >= 1; --index) {
+            const std::string from = index == 1 ? path_ : path_ + "." + std::to_string(index - 1);
+            const std::string to = path_ + "." + std::to_string(index);
+            if (std::rename(from.c_str(), to.c_str()) != 0 && errno != ENOENT) {
+                error = system_error("cannot rename", from, errno);
+                return false;
+            }
+        }
+
+        return open_file(error);
+    }
+
+    bool BinaryLog::open_file(std::string& error) {
+        fd_ = ::open(path_.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd_ < 0) {
+            error = system_error("cannot open", path_, errno);
+            return false;
+        }
+
+        // Allocate the blocks up front: a store into a mapping the disk
+        // cannot back would be SIGBUS, not an error code
+        const int result = ::posix_fallocate(fd_, 0, static_cast<off_t>(capacity_));
+        if (result != 0) {
+            error = system_error("cannot allocate", path_, result);
+            close_file();
+            return false;
+        }
+
+        void* mapping = ::mmap(nullptr, capacity_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (mapping == MAP_FAILED) {
+            error = system_error("cannot map", path_, errno);
+            close_file();
+            return false;
+        }
+        mapping_ = static_cast<char*>(mapping);
+
+        FileHeader header{};
+        std::memcpy(header.magic, kMagic, sizeof(kMagic));
+        header.byte_order = kByteOrderMark;
+        header.header_size = sizeof(FileHeader);
+        header.wall_clock_ns = wall_clock_ns();
+        std::memcpy(mapping_, &header, sizeof(header));
+
+        steady_base_ns_ = steady_ns();
+        cursor_ = sizeof(FileHeader);
+        ++generation_;
+        next_id_ = kDefinitionId + 1;
+        return true;
+    }
+
+    void BinaryLog::close_file() noexcept {
+        if (mapping_) {
+            ::munmap(mapping_, capacity_);
+            mapping_ = nullptr;
+        }
+        if (fd_ >= 0) {
+            // Give back the unused preallocation
+            if (cursor_ > 0 && ::ftruncate(fd_, static_cast<off_t>(cursor_)) != 0)
+                Logger::instance().warn() << "[BinaryLog] cannot trim " << path_ << ": " << std::strerror(errno);
+            ::close(fd_);
+            fd_ = -1;
+        }
+        cursor_ = 0;
+    }
+}
@@ -0,0 +1,228 @@
+#pragma once
+
+#include "BinaryLogFormat.hpp"
+#include "Logger.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace logger {
+
+    // One BLOG_* call site. The macros make it a function-local static that
+    // is constant-initialized, so the format table costs no start-up work;
+    // id and generation are assigned when the site first writes to a file.
+    struct BinaryLogSite {
+        LogLevel level;
+        const char* file;
+        std::uint32_t line;
+        const char* function;
+        const char* format;
+
+        // Under BinaryLog's lock
+        std::uint32_t id = 0;
+        std::uint64_t generation = 0;   // file the id was defined in
+
+        constexpr BinaryLogSite(LogLevel level, const char* file, std::uint32_t line,
+                                const char* function, const char* format) noexcept
+            : level(level), file(file), line(line), function(function), format(format) {}
+    };
+
+    struct BinaryLogStats {
+        std::uint64_t records = 0;
+        std::uint64_t bytes = 0;
+        std::uint64_t dropped = 0;      // no room even in a fresh file, or rotation failed
+        std::uint32_t rotations = 0;
+    };
+
+    namespace binlog {
+
+        template<typename>
+        inline constexpr bool kUnsupported = false;
+
+        template<typename T>
+        inline constexpr bool kIsString = std::is_same_v<T, const char*> || std::is_same_v<T, char*> ||
+                                          std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view>;
+
+        template<typename T>
+        constexpr char arg_tag() noexcept {
+            if constexpr (std::is_same_v<T, bool>)
+                return 'b';
+            else if constexpr (std::is_same_v<T, char>)
+                return 'c';
+            else if constexpr (std::is_enum_v<T>)
+                return std::is_signed_v<std::underlying_type_t<T>> ? 'i' : 'u';
+            else if constexpr (std::is_integral_v<T>)
+                return std::is_signed_v<T> ? 'i' : 'u';
+            else if constexpr (std::is_floating_point_v<T>)
+                return 'd';
+            else if constexpr (kIsString<T>)
+                return 's';
+            else if constexpr (std::is_pointer_v<T> || std::is_null_pointer_v<T>)
+                return 'p';
+            else
+                static_assert(kUnsupported<T>, "binary log arguments must be numbers, enums, strings or pointers");
+        }
+
+        // Payload of one record, filled on the logging thread before the
+        // file lock is taken
+        class RecordBuffer {
+        public:
+            static constexpr std::size_t kCapacity = kMaxRecordBytes - sizeof(RecordHeader);
+
+            void reset() noexcept { size_ = 0; overflow_ = false; }
+
+            const char* data() const noexcept { return data_; }
+            std::size_t size() const noexcept { return size_; }
+            bool overflow() const noexcept { return overflow_; }
+
+            template<typename T>
+            void put(const T& value) noexcept {
+                using U = std::decay_t<T>;
+                if constexpr (std::is_same_v<U, bool> || std::is_same_v<U, char>) {
+                    put_raw(static_cast<std::uint8_t>(value));
+                } else if constexpr (std::is_enum_v<U>) {
+                    put(static_cast<std::underlying_type_t<U>>(value));
+                } else if constexpr (std::is_integral_v<U>) {
+                    if constexpr (std::is_signed_v<U>)
+                        put_raw(static_cast<std::int64_t>(value));
+                    else
+                        put_raw(static_cast<std::uint64_t>(value));
+                } else if constexpr (std::is_floating_point_v<U>) {
+                    put_raw(static_cast<double>(value));
+                } else if constexpr (kIsString<U>) {
+                    put_string(as_view(value));
+                } else if constexpr (std::is_null_pointer_v<U>) {
+                    put_raw(std::uint64_t{0});
+                } else {
+                    put_raw(static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(value)));
+                }
+            }
+
+        private:
+            char data_[kCapacity];
+            std::size_t size_ = 0;
+            bool overflow_ = false;
+
+            template<typename T>
+            void put_raw(const T& value) noexcept {
+                if (size_ + sizeof(T) > kCapacity) {
+                    overflow_ = true;
+                    return;
+                }
+                std::memcpy(data_ + size_, &value, sizeof(T));
+                size_ += sizeof(T);
+            }
+
+            void put_string(std::string_view text) noexcept {
+                const std::uint16_t length = static_cast<std::uint16_t>(std::min(text.size(), kMaxStringBytes));
+                put_raw(length);
+                if (overflow_ || size_ + length > kCapacity) {
+                    overflow_ = true;
+                    return;
+                }
+                std::memcpy(data_ + size_, text.data(), length);
+                size_ += length;
+            }
+
+            static std::string_view as_view(const char* text) noexcept {
+                return text ? std::string_view(text) : std::string_view("(null)");
+            }
+            static std::string_view as_view(std::string_view text) noexcept { return text; }
+        };
+
+        constexpr std::size_t placeholder_count(const char* format) noexcept {
+            std::size_t count = 0;
+            for (; *format; ++format) {
+                if (format[0] == '{' && format[1] == '}') {
+                    ++count;
+                    ++format;
+                }
+            }
+            return count;
+        }
+
+        // Only used in decltype by the macros, to count arguments without
+        // evaluating them
+        template<typename... Args>
+        std::integral_constant<std::size_t, sizeof...(Args)> arity(const Args&...);
+    }
+
+    // Binary logging for high-rate diagnostics. A record holds the id of its
+    // call site, a timestamp, a thread number and the raw arguments; format
+    // strings are written once per file as definition records, so the text
+    // is produced only when BinaryLogReader decodes the file.
+    //
+    // Records go into a memory-mapped, preallocated file that rotates to
+    // path.1 ... path.(max_files - 1) when full. Arguments are encoded on the
+    // calling thread; the lock covers only the copy into the mapping. Data
+    // in the mapping survives a crash of the process.
+    //
+    // Use through the BLOG_* macros in LoggerMacros.hpp.
+    class BinaryLog {
+    public:
+        static BinaryLog& instance() noexcept;
+
+        // Starts a new file at path, rotating an existing one away first.
+        // On failure binary logging stays off and error says why.
+        bool open(const std::string& path, std::size_t file_bytes, std::uint32_t max_files, std::string& error);
+        void close();
+
+        bool is_open() const noexcept { return open_.load(std::memory_order_relaxed); }
+
+        void set_level(LogLevel level) noexcept { level_.store(level, std::memory_order_relaxed); }
+        LogLevel level() const noexcept { return level_.load(std::memory_order_relaxed); }
+
+        bool enabled(LogLevel level) const noexcept {
+            return is_open() && static_cast<int>(level) >= static_cast<int>(this->level());
+        }
+
+        template<typename... Args>
+        void write(BinaryLogSite& site, const char* /*format*/, const Args&... args) noexcept {
+            static constexpr char signature[] = {binlog::arg_tag<std::decay_t<Args>>()..., '\0'};
+            thread_local binlog::RecordBuffer buffer;
+            buffer.reset();
+            (buffer.put(args), ...);
+            commit(site, signature, buffer);
+        }
+
+        BinaryLogStats stats() const;
+
+    private:
+        std::atomic<bool> open_{false};
+        std::atomic<LogLevel> level_{LogLevel::Trace};
+
+        mutable std::mutex mutex_;
+        std::string path_;
+        std::size_t capacity_ = 0;
+        std::uint32_t max_files_ = 1;
+        int fd_ = -1;
+        char* mapping_ = nullptr;
+        std::size_t cursor_ = 0;
+        std::uint64_t steady_base_ns_ = 0;
+        std::uint64_t generation_ = 0;
+        std::uint32_t next_id_ = 0;
+        BinaryLogStats stats_;
+
+        BinaryLog() = default;
+        ~BinaryLog();
+
+        BinaryLog(const BinaryLog&) = delete;
+        BinaryLog& operator=(const BinaryLog&) = delete;
+
+        void commit(BinaryLogSite& site, const char* signature, const binlog::RecordBuffer& payload) noexcept;
+
+        bool open_file(std::string& error);
+        void close_file() noexcept;
+        bool rotate(std::string& error);
+        std::size_t definition_size(const BinaryLogSite& site, const char* signature) const noexcept;
+        void append_definition(BinaryLogSite& site, const char* signature, std::uint16_t thread,
+                               std::uint64_t timestamp_ns) noexcept;
+    };
+}
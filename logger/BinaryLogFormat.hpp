@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// On-disk layout of binary log files, shared by BinaryLog and
+// BinaryLogReader. All fields are in host byte order; byte_order lets the
+// reader refuse a file written on a machine with the other one.
+//
+// A file is a FileHeader followed by records. Each record starts with a
+// RecordHeader whose size covers the header and the payload. Records with
+// format_id kDefinitionId describe a call site:
+//
+//   u32 id, u8 level, u32 line, str file, str function, str format, str signature
+//
+// Every other record carries the arguments of a site defined earlier in
+// the same file, encoded in the order of its signature. The first record
+// with size 0 ends the file; the writer preallocates, so a file that was
+// not closed cleanly ends in zeros.
+namespace logger::binlog {
+
+    inline constexpr char kMagic[8] = {'D', 'B', 'L', 'O', 'G', '0', '0', '1'};
+    inline constexpr std::uint32_t kByteOrderMark = 0x01020304;
+
+    inline constexpr std::uint32_t kDefinitionId = 0;
+
+    // Record size limit; strings are cut to kMaxStringBytes
+    inline constexpr std::size_t kMaxRecordBytes = 4096;
+    inline constexpr std::size_t kMaxStringBytes = 1024;
+
+    // Argument tags in a site's signature:
+    //   'i' int64, 'u' uint64, 'd' double, 'b' uint8, 'c' char,
+    //   'p' uint64 address, 's' str
+    // str is a u16 byte count followed by the bytes.
+
+    struct FileHeader {
+        char magic[8];
+        std::uint32_t byte_order;
+        std::uint32_t header_size;
+        std::uint64_t wall_clock_ns;    // system clock when the file was opened
+        std::uint64_t reserved;
+    };
+    static_assert(sizeof(FileHeader) == 32, "FileHeader is part of the file format");
+
+    struct RecordHeader {
+        std::uint16_t size;
+        std::uint16_t thread;           // small per-process thread number
+        std::uint32_t format_id;
+        std::uint64_t timestamp_ns;     // since FileHeader::wall_clock_ns, monotonic
+    };
+    static_assert(sizeof(RecordHeader) == 16, "RecordHeader is part of the file format");
+    static_assert(kMaxRecordBytes <= UINT16_MAX, "record size must fit RecordHeader::size");
+}
@@ -0,0 +1,230 @@
+#include "BinaryLogReader.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iterator>
+#include <utility>
+
+namespace {
+    using namespace logger::binlog;
+
+    // Bounds-checked reads from a record payload
+    class Cursor {
+    public:
+        Cursor(const char* data, std::size_t size) : data_(data), size_(size) {}
+
+        bool ok() const noexcept { return ok_; }
+
+        template<typename T>
+        T get() {
+            T value{};
+            if (!take(sizeof(T)))
+                return value;
+            std::memcpy(&value, data_ + offset_ - sizeof(T), sizeof(T));
+            return value;
+        }
+
+        std::string get_string() {
+            const auto length = get<std::uint16_t>();
+            if (!take(length))
+                return {};
+            return std::string(data_ + offset_ - length, length);
+        }
+
+    private:
+        const char* data_;
+        std::size_t size_;
+        std::size_t offset_ = 0;
+        bool ok_ = true;
+
+        bool take(std::size_t count) {
+            if (!ok_ || size_ - offset_ < count) {
+                ok_ = false;
+                return false;
+            }
+            offset_ += count;
+            return true;
+        }
+    };
+
+    std::string argument_text(char tag, Cursor& cursor) {
+        switch (tag) {
+        case 'i': return std::to_string(cursor.get<std::int64_t>());
+        case 'u': return std::to_string(cursor.get<std::uint64_t>());
+        case 'b': return cursor.get<std::uint8_t>() ? "true" : "false";
+        case 'c': return std::string(1, static_cast<char>(cursor.get<std::uint8_t>()));
+        case 's': return cursor.get_string();
+        case 'd': {
+            char text[32];
+            std::snprintf(text, sizeof(text), "%g", cursor.get<double>());
+            return text;
+        }
+        case 'p': {
+            char text[32];
+            std::snprintf(text, sizeof(text), "0x%llx", static_cast<unsigned long long>(cursor.get<std::uint64_t>()));
+            return text;
+        }
+        default:
+            return "<?>";
+        }
+    }
+}
+
+namespace logger {
+
+    bool BinaryLogReader::open(const std::string& path) {
+        data_.clear();
+        formats_.clear();
+        cursor_ = 0;
+        damaged_ = false;
+        error_.clear();
+
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            error_ = "cannot open " + path;
+            return false;
+        }
+        data_.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+        FileHeader header{};
+        if (data_.size() < sizeof(header)) {
+            error_ = path + " is too short for a binary log";
+            return false;
+        }
+        std::memcpy(&header, data_.data(), sizeof(header));
+        if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) {
+            error_ = path + " is not a binary log";
+            return false;
+        }
+        if (header.byte_order != kByteOrderMark) {
+            error_ = path + " was written with the other byte order";
+            return false;
+        }
+        if (header.header_size < sizeof(header) || header.header_size > data_.size()) {
+            error_ = path + " has a damaged header";
+            return false;
+        }
+
+        wall_clock_ns_ = header.wall_clock_ns;
+        cursor_ = header.header_size;
+        return true;
+    }
+
+    bool BinaryLogReader::next(BinaryLogEntry& entry) {
+        while (data_.size() - cursor_ >= sizeof(RecordHeader)) {
+            RecordHeader header{};
+            std::memcpy(&header, data_.data() + cursor_, sizeof(header));
+            if (header.size == 0)
+                return false;   // preallocated tail of a file that was not closed
+            if (header.size < sizeof(header) || header.size > data_.size() - cursor_) {
+                damaged_ = true;
+                return false;
+            }
+
+            const char* payload = data_.data() + cursor_ + sizeof(header);
+            const std::size_t payload_size = header.size - sizeof(header);
+            cursor_ += header.size;
+
+            if (header.format_id == kDefinitionId) {
+                if (!read_definition(payload, payload_size)) {
+                    damaged_ = true;
+                    return false;
+                }
+                continue;
+            }
+
+            entry.wall_clock_ns = wall_clock_ns_ + header.timestamp_ns;
+            entry.thread = header.thread;
+
+            const auto it = formats_.find(header.format_id);
+            if (it == formats_.end()) {
+                entry.level = LogLevel::Warn;
+                entry.file.clear();
+                entry.line = 0;
+                entry.function.clear();
+                entry.message = "<record of undefined format " + std::to_string(header.format_id) + ">";
+                return true;
+            }
+
+            const Format& format = it->second;
+            entry.level = format.level;
+            entry.file = format.file;
+            entry.line = format.line;
+            entry.function = format.function;
+            entry.message = format_message(format, payload, payload_size);
+            return true;
+        }
+        return false;
+    }
+
+    bool BinaryLogReader::read_definition(const char* payload, std::size_t size) {
+        Cursor cursor(payload, size);
+        const auto id = cursor.get<std::uint32_t>();
+        const auto level = cursor.get<std::uint8_t>();
+
+        Format format;
+        format.level = static_cast<LogLevel>(std::min<int>(level, static_cast<int>(LogLevel::Fatal)));
+        format.line = cursor.get<std::uint32_t>();
+        format.file = cursor.get_string();
+        format.function = cursor.get_string();
+        format.format = cursor.get_string();
+        format.signature = cursor.get_string();
+        if (!cursor.ok())
+            return false;
+
+        formats_[id] = std::move(format);
+        return true;
+    }
+
+    std::string BinaryLogReader::format_message(const Format& format, const char* payload, std::size_t size) const {
+        Cursor cursor(payload, size);
+        std::vector<std::string> arguments;
+        arguments.reserve(format.signature.size());
+        for (char tag : format.signature)
+            arguments.push_back(argument_text(tag, cursor));
+        if (!cursor.ok())
+            return format.format + " <truncated arguments>";
+
+        std::string message;
+        message.reserve(format.format.size() + 16 * arguments.size());
+        std::size_t next = 0;
+        for (std::size_t i = 0; i < format.format.size(); ++i) {
+            if (format.format[i] == '{' && i + 1 < format.format.size() && format.format[i + 1] == '}' &&
+                next < arguments.size()) {
+                message += arguments[next++];
+                ++i;
+            } else {
+                message += format.format[i];
+            }
+        }
+        return message;
+    }
+
+    std::string to_text(const BinaryLogEntry& entry) {
+        const std::time_t seconds = static_cast<std::time_t>(entry.wall_clock_ns / 1000000000ULL);
+        const unsigned long micros = static_cast<unsigned long>((entry.wall_clock_ns % 1000000000ULL) / 1000);
+
+        std::tm local{};
+        localtime_r(&seconds, &local);
+        char time[32];
+        std::strftime(time, sizeof(time), "%Y-%m-%d %H:%M:%S", &local);
+
+        char prefix[64];
+        std::snprintf(prefix, sizeof(prefix), "%s.%06lu T%u ", time, micros, static_cast<unsigned>(entry.thread));
+
+        std::string text = prefix;
+        text += "[";
+        text += level_name(entry.level);
+        text += "] [";
+        text += entry.file;
+        text += ":";
+        text += std::to_string(entry.line);
+        text += " ";
+        text += entry.function;
+        text += "] ";
+        text += entry.message;
+        return text;
+    }
+}
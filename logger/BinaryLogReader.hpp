@@ -0,0 +1,60 @@
+#pragma once
+
+#include "BinaryLogFormat.hpp"
+#include "Logger.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace logger {
+
+    struct BinaryLogEntry {
+        std::uint64_t wall_clock_ns = 0;
+        std::uint16_t thread = 0;
+        LogLevel level = LogLevel::Trace;
+        std::string file;
+        std::uint32_t line = 0;
+        std::string function;
+        std::string message;    // format with the arguments substituted
+    };
+
+    // Decodes a file written by BinaryLog. Reads the whole file on open();
+    // next() then returns the records one by one.
+    class BinaryLogReader {
+    public:
+        bool open(const std::string& path);
+        const std::string& error() const noexcept { return error_; }
+
+        bool next(BinaryLogEntry& entry);
+
+        // next() stopped at a record that does not fit the file, not at
+        // the end of the data
+        bool damaged() const noexcept { return damaged_; }
+
+    private:
+        struct Format {
+            LogLevel level = LogLevel::Trace;
+            std::string file;
+            std::uint32_t line = 0;
+            std::string function;
+            std::string format;
+            std::string signature;
+        };
+
+        std::vector<char> data_;
+        std::size_t cursor_ = 0;
+        std::uint64_t wall_clock_ns_ = 0;
+        std::unordered_map<std::uint32_t, Format> formats_;
+        std::string error_;
+        bool damaged_ = false;
+
+        bool read_definition(const char* payload, std::size_t size);
+        std::string format_message(const Format& format, const char* payload, std::size_t size) const;
+    };
+
+    // "2026-01-31 12:34:56.789012 T3 [Debug] [file:line function] message"
+    std::string to_text(const BinaryLogEntry& entry);
+}
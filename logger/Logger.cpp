@@ -1,6 +1,8 @@
 #include "Logger.hpp"
 #include <algorithm>
+#include <array>
 #include <cctype>
+#include <chrono>
 #include <iostream>
 #include <iterator>
 #include <mutex>
@@ -30,10 +32,127 @@ std::optional<logger::LogLevel> upper(std::string_view level){
             return std::nullopt;
         }
     }
+
+    constexpr std::size_t kQueueCapacity = 1024;        // records per thread, power of two
+    constexpr std::size_t kMaxRecordBytes = 8 * 1024;   // longer messages are cut
+    constexpr std::size_t kSlotKeepBytes = 1024;        // slots that grew past this give the memory back
+    constexpr std::size_t kBatchBytes = 64 * 1024;      // one write to std::clog
+    constexpr std::chrono::milliseconds kIdleWait{50};
+
+    std::string_view level_prefix(logger::LogLevel level) noexcept {
+        switch (level) {
+        case logger::LogLevel::Trace: return "[Trace] ";
+        case logger::LogLevel::Debug: return "[Debug] ";
+        case logger::LogLevel::Info:  return "[Info] ";
+        case logger::LogLevel::Warn:  return "[Warn] ";
+        case logger::LogLevel::Error: return "[Error] ";
+        case logger::LogLevel::Fatal: return "[Fatal] ";
+        }
+        return "";
+    }
+
+    void write_batch(std::string& batch) {
+        if (batch.empty())
+            return;
+        std::clog.write(batch.data(), static_cast<std::streamsize>(batch.size()));
+        std::clog.flush();
+        batch.clear();
+    }
 }
 
 namespace  logger {
 
+    std::string_view level_name(LogLevel level) noexcept {
+        switch (level) {
+        case LogLevel::Trace: return "Trace";
+        case LogLevel::Debug: return "Debug";
+        case LogLevel::Info:  return "Info";
+        case LogLevel::Warn:  return "Warn";
+        case LogLevel::Error: return "Error";
+        case LogLevel::Fatal: return "Fatal";
+        }
+        return "";
+    }
+
+    bool level_from_string(std::string_view name, LogLevel& level) noexcept {
+        const auto parsed = upper(name);
+        if (!parsed)
+            return false;
+        level = *parsed;
+        return true;
+    }
+
+    // Lamport ring: the owning thread is the only producer, the writer the
+    // only consumer. Slots keep their capacity, so once a thread's queue has
+    // warmed up a record costs a copy and two atomic stores.
+    class Logger::ThreadQueue {
+    public:
+        std::atomic<bool> orphaned{false};          // owning thread has exited
+        std::atomic<std::uint64_t> dropped{0};
+
+        bool push(LogLevel level, const std::string& message) {
+            const std::size_t tail = tail_.load(std::memory_order_relaxed);
+            if (tail - head_.load(std::memory_order_acquire) == kQueueCapacity) {
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+
+            std::string& slot = slots_[tail & (kQueueCapacity - 1)];
+            const std::string_view prefix = level_prefix(level);
+            slot.clear();
+            slot.reserve(prefix.size() + std::min(message.size(), kMaxRecordBytes) + 16);
+            slot.append(prefix);
+            if (message.size() > kMaxRecordBytes) {
+                slot.append(message, 0, kMaxRecordBytes);
+                slot.append(" [truncated]");
+            } else {
+                slot.append(message);
+            }
+            slot.push_back('\n');
+
+            tail_.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool pop_into(std::string& out) {
+            const std::size_t head = head_.load(std::memory_order_relaxed);
+            if (head == tail_.load(std::memory_order_acquire))
+                return false;
+
+            std::string& slot = slots_[head & (kQueueCapacity - 1)];
+            out.append(slot);
+            if (slot.capacity() > kSlotKeepBytes)
+                std::string().swap(slot);
+            else
+                slot.clear();
+
+            head_.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        std::size_t size() const noexcept {
+            return tail_.load(std::memory_order_relaxed) - head_.load(std::memory_order_relaxed);
+        }
+
+    private:
+        alignas(64) std::atomic<std::size_t> head_{0};
+        alignas(64) std::atomic<std::size_t> tail_{0};
+        std::array<std::string, kQueueCapacity> slots_;
+    };
+
+    Logger::Logger() : writer_(&Logger::writer_loop, this) {}
+
+    Logger::~Logger() {
+        {
+            std::lock_guard<std::mutex> guard(wake_mutex_);
+            stop_.store(true);
+        }
+        wake_.notify_one();
+        flushed_.notify_all();
+        if (writer_.joinable())
+            writer_.join();
+    }
+
     Logger& Logger::instance() noexcept {
         static Logger log;
         return log;
@@ -68,41 +187,150 @@ namespace  logger {
 
 
     void Logger::write(LogLevel level, const std::string& message){
-        LogLevel current_level = level_.load();
-        
+        LogLevel current_level = level_.load(std::memory_order_relaxed);
+
         if (static_cast<int>(level) < static_cast<int>(current_level))
             return;
-        std::string level_string;
-        std::lock_guard<std::mutex> guard(mutex_);
-        switch (level) {
-        case LogLevel::Trace:
-            level_string = "[Trace] ";
-            break;
-        case LogLevel::Debug:
-            level_string = "[Debug] ";
-            break;
-        case LogLevel::Info:
-            level_string = "[Info] ";
-            break;
-        case LogLevel::Warn:
-            level_string = "[Warn] ";
-            break;
-        case LogLevel::Error:
-            level_string = "[Error] ";
-            break;
-        case LogLevel::Fatal:
-            level_string = "[Fatal] ";
-            break;
+
+        ThreadQueue& queue = local_queue();
+        const bool pushed = queue.push(level, message);
+
+        // A backlog past half the ring or an error is worth waking the writer
+        // for; everything else waits for its next idle tick
+        if (!pushed || static_cast<int>(level) >= static_cast<int>(LogLevel::Error) ||
+            queue.size() > kQueueCapacity / 2)
+            wake_writer();
+
+        if (level == LogLevel::Fatal)
+            flush();
+    }
+
+    Logger::ThreadQueue& Logger::local_queue() {
+        // Keeps the queue registered while the thread lives; after the thread
+        // exits the writer drains what is left and forgets the queue
+        struct Handle {
+            std::shared_ptr<ThreadQueue> queue;
+            ~Handle() {
+                if (queue)
+                    queue->orphaned.store(true, std::memory_order_release);
+            }
+        };
+        thread_local Handle handle;
+
+        if (!handle.queue) {
+            handle.queue = std::make_shared<ThreadQueue>();
+            std::lock_guard<std::mutex> guard(queues_mutex_);
+            queues_.push_back(handle.queue);
+        }
+        return *handle.queue;
+    }
+
+    void Logger::wake_writer() noexcept {
+        // No lock: a notification lost to the race with the writer going to
+        // sleep only delays the batch until the idle tick
+        if (!wake_pending_.exchange(true, std::memory_order_acq_rel))
+            wake_.notify_one();
+    }
+
+    void Logger::writer_loop() {
+        std::string batch;
+        batch.reserve(kBatchBytes + kMaxRecordBytes);
+
+        for (;;) {
+            std::uint64_t ticket = 0;
+            bool stopping = false;
+            {
+                std::unique_lock<std::mutex> lock(wake_mutex_);
+                wake_.wait_for(lock, kIdleWait, [this] {
+                    return stop_.load() || wake_pending_.load() || flush_requested_ != flush_done_;
+                });
+                wake_pending_.store(false);
+                ticket = flush_requested_;
+                stopping = stop_.load();
+            }
+
+            written_.fetch_add(drain_queues(batch), std::memory_order_relaxed);
+
+            {
+                std::lock_guard<std::mutex> guard(wake_mutex_);
+                flush_done_ = ticket;
+            }
+            flushed_.notify_all();
+
+            if (stopping)
+                return;
         }
-        std::clog<< level_string << message <<"\n";
+    }
+
+    std::uint64_t Logger::drain_queues(std::string& batch) {
+        std::uint64_t records = 0;
+        std::lock_guard<std::mutex> guard(queues_mutex_);
+
+        std::uint64_t dropped = retired_dropped_;
+        for (auto it = queues_.begin(); it != queues_.end();) {
+            ThreadQueue& queue = **it;
+            // Read before draining: everything the thread pushed is then visible
+            const bool orphaned = queue.orphaned.load(std::memory_order_acquire);
+
+            while (queue.pop_into(batch)) {
+                ++records;
+                if (batch.size() >= kBatchBytes)
+                    write_batch(batch);
+            }
+
+            const std::uint64_t queue_dropped = queue.dropped.load(std::memory_order_relaxed);
+            dropped += queue_dropped;
+            if (orphaned) {
+                retired_dropped_ += queue_dropped;
+                it = queues_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        if (dropped > reported_dropped_) {
+            batch.append(level_prefix(LogLevel::Warn));
+            batch.append("[logger] ");
+            batch.append(std::to_string(dropped - reported_dropped_));
+            batch.append(" log records dropped, queues full (");
+            batch.append(std::to_string(dropped));
+            batch.append(" total)\n");
+            reported_dropped_ = dropped;
+        }
+
+        write_batch(batch);
+        return records;
+    }
+
+    void Logger::flush() {
+        if (std::this_thread::get_id() == writer_.get_id())
+            return;
+
+        std::unique_lock<std::mutex> lock(wake_mutex_);
+        const std::uint64_t ticket = ++flush_requested_;
+        wake_.notify_one();
+        flushed_.wait(lock, [this, ticket] { return flush_done_ >= ticket || stop_.load(); });
+    }
+
+    LoggerStats Logger::stats() const {
+        LoggerStats stats;
+        stats.written = written_.load(std::memory_order_relaxed);
+
+        std::lock_guard<std::mutex> guard(queues_mutex_);
+        stats.dropped = retired_dropped_;
+        for (const auto& queue : queues_)
+            stats.dropped += queue->dropped.load(std::memory_order_relaxed);
+        stats.threads = queues_.size();
+        return stats;
     }
 
     bool Logger::load_env_level() noexcept{
         char* env_level = std::getenv("LOG_LEVEL");
         if(env_level != nullptr){
-            std::string_view str_level(env_level);
-            auto new_log_level = upper(str_level);
-            set_level(new_log_level.value());
+            LogLevel new_log_level = level();
+            if (!level_from_string(env_level, new_log_level))
+                return false;
+            set_level(new_log_level);
             return true;
         }
         return false;
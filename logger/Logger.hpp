@@ -1,9 +1,16 @@
 #pragma once
 
 #include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <mutex>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
 
 namespace logger {
 
@@ -16,18 +23,53 @@ namespace logger {
         Fatal
     };
 
+    // "Trace", "Debug", ...
+    std::string_view level_name(LogLevel level) noexcept;
+    // Case-insensitive; false leaves level untouched
+    bool level_from_string(std::string_view name, LogLevel& level) noexcept;
+
+    struct LoggerStats {
+        std::uint64_t written = 0;      // records handed to std::clog
+        std::uint64_t dropped = 0;      // records lost to full thread queues
+        std::size_t threads = 0;        // threads with a live queue
+    };
+
     class LogStream;
 
+    // Records are formatted on the logging thread and pushed into that
+    // thread's own bounded single-producer queue; a background writer drains
+    // all queues and writes to std::clog in batches. Logging threads never
+    // share a lock or wait for the terminal. A record that does not fit in
+    // its queue is dropped and counted, and the writer reports the count.
+    // Fatal records are flushed before the call returns.
     class Logger {
 
     private:
-        std::mutex mutex_;
+        class ThreadQueue;
 
         friend class LogStream;
 
         std::atomic<LogLevel> level_ = LogLevel::Info;
 
-        Logger () noexcept = default;
+        mutable std::mutex queues_mutex_;       // registration and the writer's pass only
+        std::vector<std::shared_ptr<ThreadQueue>> queues_;
+        std::uint64_t retired_dropped_ = 0;     // from queues of exited threads
+
+        std::mutex wake_mutex_;
+        std::condition_variable wake_;
+        std::condition_variable flushed_;
+        std::atomic<bool> wake_pending_{false};
+        std::atomic<bool> stop_{false};
+        std::uint64_t flush_requested_ = 0;     // under wake_mutex_
+        std::uint64_t flush_done_ = 0;
+
+        std::atomic<std::uint64_t> written_{0};
+        std::uint64_t reported_dropped_ = 0;    // writer thread only
+
+        std::thread writer_;
+
+        Logger();
+        ~Logger();
 
         Logger(const Logger&) = delete;
         Logger& operator=(const Logger&) = delete;
@@ -36,7 +78,12 @@ namespace logger {
 
         void write(LogLevel level, const std::string& message);
 
-    public: 
+        ThreadQueue& local_queue();
+        void wake_writer() noexcept;
+        void writer_loop();
+        std::uint64_t drain_queues(std::string& batch);
+
+    public:
 
         static Logger& instance() noexcept;
 
@@ -44,20 +91,29 @@ namespace logger {
 
         LogLevel level() const noexcept;
 
+        // What the macros check before building a record
+        bool enabled(LogLevel level) const noexcept {
+            return static_cast<int>(level) >= static_cast<int>(level_.load(std::memory_order_relaxed));
+        }
 
         LogStream trace() noexcept;
         LogStream debug() noexcept;
         LogStream info() noexcept;
         LogStream warn() noexcept;
         LogStream error() noexcept;
-        LogStream fatal() noexcept;   
-        
+        LogStream fatal() noexcept;
+
         bool load_env_level() noexcept;
 
+        // Blocks until everything logged before the call has been written
+        void flush();
+
+        LoggerStats stats() const;
+
     };
 
     class LogStream{
-    private: 
+    private:
         Logger& logger_;
         LogLevel level_;
 
@@ -73,4 +129,10 @@ namespace logger {
             return *this;
         };
     };
-}
\ No newline at end of file
+
+    // Turns a LogStream expression into void so the macros can put it in
+    // the false branch of ?: next to (void)0
+    struct LogVoidify {
+        void operator&(const LogStream&) const noexcept {}
+    };
+}
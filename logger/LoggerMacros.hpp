@@ -1,10 +1,54 @@
 #pragma once
 
 #include "Logger.hpp"
+#include "BinaryLog.hpp"
 
-#define LOG_TRACE logger::Logger::instance().trace() << "[" << __FILE__ << ":" << __LINE__ << " " << __func__ << "] "
-#define LOG_DEBUG logger::Logger::instance().debug() << "[" << __FILE__ << ":" << __LINE__ << " " << __func__ << "] "
-#define LOG_INFO logger::Logger::instance().info()   << "[" << __FILE__ << ":" << __LINE__ << " " << __func__ << "] "
-#define LOG_WARN logger::Logger::instance().warn()   << "[" << __FILE__ << ":" << __LINE__ << " " << __func__ << "] "
-#define LOG_ERROR logger::Logger::instance().error() << "[" << __FILE__ << ":" << __LINE__ << " " << __func__ << "] "
-#define LOG_FATAL logger::Logger::instance().fatal() << "[" << __FILE__ << ":" << __LINE__ << " " << __func__ << "] "
\ No newline at end of file
+// Levels below this are compiled out: 0 = Trace ... 5 = Fatal. Set from the
+// LOG_COMPILE_MIN_LEVEL CMake option.
+#ifndef LOG_COMPILE_MIN_LEVEL
+#define LOG_COMPILE_MIN_LEVEL 0
+#endif
+
+// The level is checked before the LogStream is constructed, so operands of a
+// disabled statement are never evaluated. Below LOG_COMPILE_MIN_LEVEL the
+// condition is constant and the compiler drops the statement; its operands
+// are still type-checked.
+#define LOG_AT_LEVEL_(level, stream) \
+    (static_cast<int>(level) < LOG_COMPILE_MIN_LEVEL || !logger::Logger::instance().enabled(level)) \
+        ? static_cast<void>(0) \
+        : logger::LogVoidify() & logger::Logger::instance().stream() \
+            << "[" << __FILE__ << ":" << __LINE__ << " " << __func__ << "] "
+
+#define LOG_TRACE LOG_AT_LEVEL_(logger::LogLevel::Trace, trace)
+#define LOG_DEBUG LOG_AT_LEVEL_(logger::LogLevel::Debug, debug)
+#define LOG_INFO  LOG_AT_LEVEL_(logger::LogLevel::Info, info)
+#define LOG_WARN  LOG_AT_LEVEL_(logger::LogLevel::Warn, warn)
+#define LOG_ERROR LOG_AT_LEVEL_(logger::LogLevel::Error, error)
+#define LOG_FATAL LOG_AT_LEVEL_(logger::LogLevel::Fatal, fatal)
+
+// Binary log statements for high-rate diagnostics, written only while
+// BinaryLog is open:
+//
+//     BLOG_TRACE("parsed {} bytes, state {}", size, state);
+//
+// The format must be a string literal with one {} per argument; that is
+// checked at compile time. Arguments are stored raw and the text is built
+// only when the file is decoded (tools/blog_decode).
+#define BLOG_FORMAT_(format, ...) format
+
+#define BLOG_AT_LEVEL_(level, ...) \
+    do { \
+        static_assert(logger::binlog::placeholder_count(BLOG_FORMAT_(__VA_ARGS__, 0)) + 1 == \
+                          decltype(logger::binlog::arity(__VA_ARGS__))::value, \
+                      "binary log format needs one {} per argument"); \
+        if (static_cast<int>(level) >= LOG_COMPILE_MIN_LEVEL && logger::BinaryLog::instance().enabled(level)) { \
+            static logger::BinaryLogSite blog_site_(level, __FILE__, __LINE__, __func__, BLOG_FORMAT_(__VA_ARGS__, 0)); \
+            logger::BinaryLog::instance().write(blog_site_, __VA_ARGS__); \
+        } \
+    } while (false)
+
+#define BLOG_TRACE(...) BLOG_AT_LEVEL_(logger::LogLevel::Trace, __VA_ARGS__)
+#define BLOG_DEBUG(...) BLOG_AT_LEVEL_(logger::LogLevel::Debug, __VA_ARGS__)
+#define BLOG_INFO(...)  BLOG_AT_LEVEL_(logger::LogLevel::Info, __VA_ARGS__)
+#define BLOG_WARN(...)  BLOG_AT_LEVEL_(logger::LogLevel::Warn, __VA_ARGS__)
+#define BLOG_ERROR(...) BLOG_AT_LEVEL_(logger::LogLevel::Error, __VA_ARGS__)
@@ -4,17 +4,28 @@
 #include <qnamespace.h>
 #include <qobjectdefs.h>
 #include <QTimer>
+#include <algorithm>
+#include <utility>
 
 namespace network {
     ConnectionManager::ConnectionManager(QObject* parent)
         : QObject(parent)
         , reconnect_timer_(new QTimer(this))
+        , update_timer_(new QTimer(this))
         , lane_view_model_(new viewmodels::LaneStateViewModel(this))
         , marking_list_model_(new viewmodels::MarkingObjectListModel(this))
         , warning_list_model_(new viewmodels::WarningListModel(this))
     {
         reconnect_timer_->setSingleShot(true);
         connect(reconnect_timer_, &QTimer::timeout, this, &ConnectionManager::attemptReconnect);
+
+        update_timer_->setSingleShot(true);
+        update_timer_->setTimerType(Qt::PreciseTimer);
+        update_timer_->setInterval(update_interval_ms_);
+        connect(update_timer_, &QTimer::timeout, this, &ConnectionManager::applyPendingUpdates);
+
+        pending_markings_.objects.reserve(
+            (laneproto::kMaxPayloadLength - 1) / laneproto::kMarkingObjectRecordSize);
     }
 
     ConnectionManager::~ConnectionManager(){
@@ -22,12 +33,76 @@ namespace network {
     }
 
     void ConnectionManager::setWarningEngineConfig(const domain::WarningEngineConfig& config) {
-        warning_engine_.setConfig(config);
+        std::string error;
+        if (!warning_engine_.setConfig(config, &error))
+            LOG_WARN << "Invalid warning rules, using the built-in ones: " << error;
         LOG_INFO << "WarningEngine configuration updated: "
+                 << warning_engine_.ruleCount() << (config.rules.empty() ? " built-in" : " configured") << " rules, "
                  << "lane_departure_threshold=" << config.lane_departure_offset_threshold_m << "m, "
                  << "crosswalk_threshold=" << config.crosswalk_distance_threshold_m << "m";
     }
 
+    void ConnectionManager::setMessageQueueConfig(std::size_t capacity, OverflowPolicy policy) {
+        message_queue_capacity_ = capacity;
+        message_queue_policy_ = policy;
+        LOG_INFO << "Message queue configuration updated: capacity=" << capacity
+                 << ", overflow=" << overflowPolicyName(policy);
+    }
+
+    void ConnectionManager::setIngestBackend(IngestBackend backend) {
+        ingest_backend_ = backend;
+        LOG_INFO << "Ingest backend set to " << (backend == IngestBackend::Epoll ? "epoll" : "qt");
+    }
+
+    MessageQueueStats ConnectionManager::messageQueueStats() const {
+        return message_queue_ ? message_queue_->stats() : MessageQueueStats{};
+    }
+
+    bool ConnectionManager::updateModeFromString(const QString& name, UpdateMode& out) {
+        if (name == "immediate") {
+            out = UpdateMode::Immediate;
+        } else if (name == "timer") {
+            out = UpdateMode::Timer;
+        } else if (name == "frame") {
+            out = UpdateMode::FrameSync;
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+    bool ConnectionManager::ingestBackendFromString(const QString& name, IngestBackend& out) {
+        if (name == "epoll") {
+            out = IngestBackend::Epoll;
+        } else if (name == "qt") {
+            out = IngestBackend::QtSocket;
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+    void ConnectionManager::setUpdateMode(UpdateMode mode, int interval_ms) {
+        if (interval_ms < 1 || interval_ms > 1000) {
+            LOG_WARN << "Invalid update interval: " << interval_ms
+                     << " (must be 1-1000ms), ignoring";
+            return;
+        }
+
+        update_mode_ = mode;
+        update_interval_ms_ = interval_ms;
+        update_timer_->setInterval(interval_ms);
+
+        // Nothing may be left behind in the slot when switching to Immediate
+        if (mode == UpdateMode::Immediate)
+            applyPendingUpdates();
+
+        LOG_INFO << "Update mode set to "
+                 << (mode == UpdateMode::Immediate ? "immediate"
+                     : mode == UpdateMode::Timer ? "timer" : "frame")
+                 << ", interval=" << interval_ms << "ms";
+    }
+
     void ConnectionManager::connectToHost(const QString& host, int port) {
         // Validate input parameters
         if (host.isEmpty()) {
@@ -60,13 +135,7 @@ namespace network {
         setLastError(QString{});
         setState(State::Connecting);
         createWorkerIfNeeded();
-
-        QMetaObject::invokeMethod(
-            worker_,
-            "start",
-            Qt::QueuedConnection,
-            Q_ARG(QString, host),
-            Q_ARG(quint16, static_cast<quint16>(port)));
+        startReader(host, static_cast<quint16>(port));
     }
 
     void ConnectionManager::disconnectFromHost() {
@@ -78,7 +147,12 @@ namespace network {
         resetReconnectState();
 
         setState(State::Disconnecting);
-        if (worker_){
+        if (ingest_engine_) {
+            // Finished by the stream's Removed notification
+            const StreamId stream = std::exchange(ingest_stream_, kInvalidStreamId);
+            if (stream == kInvalidStreamId || !ingest_engine_->isRunning() || !ingest_engine_->removeStream(stream))
+                setState(State::Disconnected);
+        } else if (worker_){
             QMetaObject::invokeMethod(worker_, "stop", Qt::QueuedConnection);
         } else {
             setState(State::Disconnected);
@@ -129,10 +203,14 @@ namespace network {
     }
 
     void ConnectionManager::createWorkerIfNeeded() {
-        if (worker_) return;
+        if (worker_ || ingest_engine_) return;
+
+        message_queue_ = std::make_shared<ParsedMessageQueue>(message_queue_capacity_, message_queue_policy_);
+        if (ingest_backend_ == IngestBackend::Epoll && createIngestEngine())
+            return;
 
         workerThread_ = new QThread(this);
-        worker_ = new TcpReaderWorker();
+        worker_ = new TcpReaderWorker(message_queue_);
 
         worker_->moveToThread(workerThread_);
 
@@ -154,17 +232,116 @@ namespace network {
             setState(State::Error);
             scheduleReconnect();
         });
-        connect(worker_, &TcpReaderWorker::laneSummaryParsed,
-                this, &ConnectionManager::laneSummaryReceived);
-        connect(worker_, &TcpReaderWorker::markingObjectsParsed,
-                this, &ConnectionManager::markingObjectsReceived);
+        connect(worker_, &TcpReaderWorker::messagesAvailable,
+                this, &ConnectionManager::drainMessages);
         connect(worker_, &TcpReaderWorker::parseErrorOccurred,
                 this, &ConnectionManager::parseErrorReceived);
 
         workerThread_->start();
     }
 
+    bool ConnectionManager::createIngestEngine() {
+        // The sink runs on the engine's loop thread; everything it reports is
+        // queued over to this thread
+        IngestQueueSink::Callbacks callbacks;
+        callbacks.messagesAvailable = [this]() {
+            QMetaObject::invokeMethod(this, [this]() { drainMessages(); }, Qt::QueuedConnection);
+        };
+        callbacks.streamStateChanged = [this](StreamId stream, StreamState state) {
+            QMetaObject::invokeMethod(this, [this, stream, state]() {
+                ingestStreamStateChanged(stream, state);
+            }, Qt::QueuedConnection);
+        };
+        callbacks.parseErrorOccurred = [this](StreamId, const laneproto::ParseError& error) {
+            QMetaObject::invokeMethod(this, [this, error]() {
+                emit parseErrorReceived(error);
+            }, Qt::QueuedConnection);
+        };
+
+        // One loop thread: the queue has a single producer. Reconnects are
+        // left to scheduleReconnect() so both backends follow the same policy.
+        IngestEngineConfig config;
+        config.thread_count = 1;
+        config.reconnect_interval_ms = 0;
+
+        ingest_sink_ = std::make_unique<IngestQueueSink>(message_queue_, std::move(callbacks));
+        ingest_engine_ = std::make_unique<IngestEngine>(*ingest_sink_, config);
+        if (!ingest_engine_->start()) {
+            LOG_WARN << "IngestEngine failed to start, falling back to the Qt socket reader";
+            ingest_engine_.reset();
+            ingest_sink_.reset();
+            return false;
+        }
+        return true;
+    }
+
+    void ConnectionManager::startReader(const QString& host, quint16 port) {
+        if (!ingest_engine_) {
+            QMetaObject::invokeMethod(
+                worker_,
+                "start",
+                Qt::QueuedConnection,
+                Q_ARG(QString, host),
+                Q_ARG(quint16, port));
+            return;
+        }
+
+        // A loop that failed has cleared isRunning(); bring it back first
+        if (!ingest_engine_->isRunning() && !ingest_engine_->start()) {
+            setLastError("Ingest engine failed to start");
+            setState(State::Error);
+            scheduleReconnect();
+            return;
+        }
+
+        // Each attempt is a fresh stream; events of the old one are ignored
+        if (ingest_stream_ != kInvalidStreamId)
+            ingest_engine_->removeStream(ingest_stream_);
+
+        // Resolved here, on this thread; the configured host is normally an address
+        ingest_stream_ = ingest_engine_->addStream(StreamEndpoint::tcp(host.toStdString(), port));
+        if (ingest_stream_ == kInvalidStreamId) {
+            setLastError(QString("Cannot resolve host %1").arg(host));
+            setState(State::Error);
+            scheduleReconnect();
+        }
+    }
+
+    void ConnectionManager::ingestStreamStateChanged(StreamId stream, StreamState state) {
+        if (stream != ingest_stream_) {
+            // A stream already replaced or removed; only its removal matters
+            if (state == StreamState::Removed && state_ == State::Disconnecting)
+                setState(State::Disconnected);
+            return;
+        }
+
+        switch (state) {
+            case StreamState::Connecting:
+            case StreamState::Removed:
+                break;
+            case StreamState::Connected:
+                setState(State::Connected);
+                break;
+            case StreamState::Disconnected:
+                // Same outcomes as TcpReaderWorker's errorOccurred/disconnected
+                if (state_ == State::Connecting) {
+                    setLastError(QString("Cannot connect to %1:%2").arg(saved_host_).arg(saved_port_));
+                    setState(State::Error);
+                    scheduleReconnect();
+                } else if (state_ == State::Connected) {
+                    setState(State::Disconnected);
+                    scheduleReconnect();
+                }
+                break;
+        }
+    }
+
     void ConnectionManager::destroyWorker(){
+        // Stops and joins the loop thread before the sink goes
+        ingest_engine_.reset();
+        ingest_sink_.reset();
+        ingest_stream_ = kInvalidStreamId;
+
         if (!workerThread_)
             return;
 
@@ -218,13 +395,7 @@ namespace network {
 
         setState(State::Connecting);
         createWorkerIfNeeded();
-
-        QMetaObject::invokeMethod(
-            worker_,
-            "start",
-            Qt::QueuedConnection,
-            Q_ARG(QString, saved_host_),
-            Q_ARG(quint16, saved_port_));
+        startReader(saved_host_, saved_port_);
     }
 
     void ConnectionManager::resetReconnectState() {
@@ -292,12 +463,10 @@ namespace network {
     }
 
     void ConnectionManager::updateWarnings(const std::uint64_t timestamp_ms) {
-        auto warnings = warning_engine_.update(lane_state_, marking_model_, timestamp_ms);
-        warning_model_.clear();
-        warning_model_.reserve(warnings.size());
-        for (auto& w : warnings) {
-            warning_model_.addWarning(std::move(w));
-        }
+        // The engine fills the buffer, which then trades storage with the
+        // model; neither allocates once both have grown
+        warning_engine_.update(lane_state_, marking_index_, timestamp_ms, warning_buffer_);
+        warning_model_.swapWarnings(warning_buffer_);
         warning_model_.setLastUpdateMs(timestamp_ms);
         LOG_DEBUG << "WarningModel updated: " << warning_model_;
 
@@ -307,8 +476,130 @@ namespace network {
         emit warningModelUpdated();
     }
 
+    void ConnectionManager::drainMessages() {
+        if (!message_queue_)
+            return;
+
+        const std::size_t count = message_queue_->drain([this](const ParsedMessage& msg) {
+            std::uint64_t sensor_ms = 0;
+            switch (msg.kind) {
+                case ParsedMessage::Kind::LaneSummary:
+                    observeTimestamp(msg.lane_summary.timestamp_ms, msg.received_ms, sensor_ms);
+                    laneSummaryReceived(msg.lane_summary, sensor_ms);
+                    break;
+                case ParsedMessage::Kind::MarkingObjects:
+                    observeTimestamp(msg.marking_objects.timestamp_ms, msg.received_ms, sensor_ms);
+                    markingObjectsReceived(msg.marking_objects, sensor_ms);
+                    break;
+            }
+        });
+        BLOG_TRACE("Drained {} queued messages", count);
+    }
+
+    void ConnectionManager::observeTimestamp(std::uint32_t sensor_ms, std::uint64_t received_ms,
+                                             std::uint64_t& unwrapped_ms) {
+        const std::uint32_t restarts = timebase_.restarts();
+        unwrapped_ms = timebase_.observe(sensor_ms, received_ms);
+
+        if (timebase_.restarts() != restarts) {
+            timebase_has_drift_ = false;
+            LOG_WARN << "Sensor clock discontinuity at ts=" << sensor_ms << ", timebase restarted";
+        } else if (!timebase_has_drift_ && timebase_.hasDrift()) {
+            timebase_has_drift_ = true;
+            LOG_INFO << "Sensor timebase locked: offset=" << timebase_.offsetMs()
+                     << "ms, drift=" << timebase_.driftPpm() << "ppm, residual=" << timebase_.residualMs() << "ms";
+        }
+    }
+
+    void ConnectionManager::laneSummaryReceived(const laneproto::LaneSummary& summary, std::uint64_t sensor_ms){
+        ++update_stats_.received;
+
+        if (update_mode_ != UpdateMode::Immediate) {
+            if (lane_dirty_)
+                ++update_stats_.coalesced;
+            pending_lane_ = summary;
+            pending_lane_sensor_ms_ = sensor_ms;
+            lane_dirty_ = true;
+            schedulePendingUpdate();
+            return;
+        }
+
+        applyLaneSummary(summary, sensor_ms);
+        updateWarnings(lane_sensor_ms_);
+        publishSnapshot();
+    }
+
+    void ConnectionManager::markingObjectsReceived(const laneproto::MarkingObjects& objects, std::uint64_t sensor_ms){
+        ++update_stats_.received;
 
-    void ConnectionManager::laneSummaryReceived(const laneproto::LaneSummary& summary){
+        if (update_mode_ != UpdateMode::Immediate) {
+            if (markings_dirty_)
+                ++update_stats_.coalesced;
+            pending_markings_ = objects;
+            pending_markings_sensor_ms_ = sensor_ms;
+            markings_dirty_ = true;
+            schedulePendingUpdate();
+            return;
+        }
+
+        applyMarkingObjects(objects, sensor_ms);
+        if (lane_state_.isValid()) {
+            updateWarnings(markings_sensor_ms_);
+        }
+        publishSnapshot();
+    }
+
+    void ConnectionManager::schedulePendingUpdate() {
+        if (!update_timer_->isActive())
+            update_timer_->start();
+    }
+
+    void ConnectionManager::applyPendingUpdates() {
+        update_timer_->stop();
+        if (!lane_dirty_ && !markings_dirty_)
+            return;
+
+        ++update_stats_.ticks;
+
+        const bool lane_applied = lane_dirty_;
+        if (lane_dirty_) {
+            lane_dirty_ = false;
+            applyLaneSummary(pending_lane_, pending_lane_sensor_ms_);
+        }
+        if (markings_dirty_) {
+            markings_dirty_ = false;
+            applyMarkingObjects(pending_markings_, pending_markings_sensor_ms_);
+        }
+
+        if (lane_applied || lane_state_.isValid()) {
+            updateWarnings(std::max(lane_sensor_ms_, markings_sensor_ms_));
+        }
+        publishSnapshot();
+
+        LOG_TRACE << "Applied pending updates: received=" << update_stats_.received
+                  << ", applied=" << update_stats_.applied
+                  << ", coalesced=" << update_stats_.coalesced;
+    }
+
+    void ConnectionManager::publishSnapshot() {
+        std::shared_ptr<domain::DomainSnapshot> snapshot = snapshot_publisher_.acquire();
+        snapshot->lane = lane_state_;
+        snapshot->markings = marking_model_;
+        snapshot->warnings = warning_model_;
+        const std::uint64_t newest_ms = std::max(lane_sensor_ms_, markings_sensor_ms_);
+        snapshot->timestamp_ms = newest_ms != 0 ? timebase_.toHostMs(newest_ms) : 0;
+        snapshot->lane_host_ms = laneHostTimestampMs();
+        snapshot_publisher_.publish(std::move(snapshot));
+        emit snapshotPublished(snapshot_publisher_.current());
+    }
+
+    std::uint64_t ConnectionManager::laneHostTimestampMs() const noexcept {
+        return lane_sensor_ms_ != 0 ? timebase_.toHostMs(lane_sensor_ms_) : 0;
+    }
+
+    void ConnectionManager::applyLaneSummary(const laneproto::LaneSummary& summary, std::uint64_t sensor_ms){
+        ++update_stats_.applied;
+        lane_sensor_ms_ = sensor_ms;
         lane_state_.updateFromProto(summary);
         LOG_DEBUG << "LaneState updated: " << lane_state_;
 
@@ -316,22 +607,20 @@ namespace network {
         lane_view_model_->updateFromDomain(lane_state_);
 
         emit laneStateUpdated();
-        const std::uint64_t timestamp_ms = lane_state_.timestampMs();
-        updateWarnings(timestamp_ms);
     }
 
-    void ConnectionManager::markingObjectsReceived(const laneproto::MarkingObjects& objects){
+    void ConnectionManager::applyMarkingObjects(const laneproto::MarkingObjects& objects, std::uint64_t sensor_ms){
+        ++update_stats_.applied;
+        markings_sensor_ms_ = sensor_ms;
         marking_model_.updateFromProto(objects);
+        marking_tracker_.update(marking_model_, sensor_ms);
+        marking_index_.build(marking_model_);
         LOG_DEBUG << "MarkingObjectModel updated: " << marking_model_;
 
         // Update ViewModel
         marking_list_model_->updateFromDomain(marking_model_);
 
         emit markingModelUpdated();
-        if (lane_state_.isValid()) {
-            const std::uint64_t timestamp_ms = marking_model_.timestampMs();
-            updateWarnings(timestamp_ms);
-        }
     }
 
 }
\ No newline at end of file
@@ -4,18 +4,33 @@
 #include <QString>
 #include <QTimer>
 #include <QThread>
+#include <memory>
 #include "TcpReaderWorker.h"
+#include "IngestEngine.h"
+#include "IngestQueueSink.h"
+#include "MessageQueue.h"
 #include "proto_parser.h"
 #include "MarkingObject.h"
+#include "MarkingIndex.h"
+#include "MarkingTracker.h"
 #include "Warning.h"
 #include "WarningEngine.h"
 #include "LaneState.h"
+#include "DomainSnapshot.h"
+#include "SensorTimebase.h"
 #include "LaneStateViewModel.h"
 #include "MarkingObjectListModel.h"
 #include "WarningListModel.h"
 
 namespace network {
 
+    struct UpdateCoalescingStats {
+        std::uint64_t received = 0;     // lane + marking messages taken off the queue
+        std::uint64_t applied = 0;      // messages applied to the domain/view models
+        std::uint64_t coalesced = 0;    // messages overwritten before a tick applied them
+        std::uint64_t ticks = 0;        // ticks that applied at least one message
+    };
+
     class ConnectionManager : public QObject
     {
         Q_OBJECT
@@ -41,6 +56,33 @@ namespace network {
         };
         Q_ENUM(State)
 
+        // Immediate: every message updates models and warnings as it arrives.
+        // Timer:     messages overwrite a "latest" slot; the newest state is
+        //            applied once per interval, starting from the first dirty one.
+        // FrameSync: as Timer, but applied on applyPendingUpdates() (e.g. on
+        //            every displayed video frame); the interval is a fallback
+        //            for when no frames arrive.
+        enum class UpdateMode {
+            Immediate,
+            Timer,
+            FrameSync
+        };
+        Q_ENUM(UpdateMode)
+
+        // Epoll:    IngestEngine, one event-loop thread parsing in place.
+        // QtSocket: TcpReaderWorker on a QThread; also the fallback when the
+        //           engine cannot start.
+        enum class IngestBackend {
+            Epoll,
+            QtSocket
+        };
+        Q_ENUM(IngestBackend)
+
+        // Accepts "immediate", "timer", "frame"
+        static bool updateModeFromString(const QString& name, UpdateMode& out);
+        // Accepts "epoll", "qt"
+        static bool ingestBackendFromString(const QString& name, IngestBackend& out);
+
         explicit ConnectionManager(QObject* parent = nullptr);
         ~ConnectionManager() override;
 
@@ -65,6 +107,15 @@ namespace network {
         const domain::MarkingObjectModel& markingModel() const noexcept { return marking_model_; }
         const domain::WarningModel& warningModel() const noexcept { return warning_model_; }
 
+        // Thread-safe; republished after every applied lane/marking update
+        domain::DomainSnapshotPtr snapshot() const noexcept { return snapshot_publisher_.current(); }
+        const domain::SnapshotPublisher& snapshotPublisher() const noexcept { return snapshot_publisher_; }
+
+        // Sensor timestamps unwrapped and mapped onto domain::hostClockMs();
+        // snapshot timestamps are already in host time
+        const domain::SensorTimebase& sensorTimebase() const noexcept { return timebase_; }
+        std::uint64_t laneHostTimestampMs() const noexcept;
+
         viewmodels::LaneStateViewModel* laneViewModel() const noexcept { return lane_view_model_; }
         viewmodels::MarkingObjectListModel* markingListModel() const noexcept { return marking_list_model_; }
         viewmodels::WarningListModel* warningListModel() const noexcept { return warning_list_model_; }
@@ -74,6 +125,20 @@ namespace network {
 
         void setWarningEngineConfig(const domain::WarningEngineConfig& config);
 
+        // Take effect when the reader is created (first connect).
+        void setMessageQueueConfig(std::size_t capacity, OverflowPolicy policy);
+        void setIngestBackend(IngestBackend backend);
+        [[nodiscard]] IngestBackend ingestBackend() const noexcept { return ingest_backend_; }
+        [[nodiscard]] MessageQueueStats messageQueueStats() const;
+
+        void setUpdateMode(UpdateMode mode, int interval_ms);
+        [[nodiscard]] UpdateMode updateMode() const noexcept { return update_mode_; }
+        [[nodiscard]] const UpdateCoalescingStats& updateCoalescingStats() const noexcept { return update_stats_; }
+
+    public slots:
+        // Applies the newest pending lane/marking state, recomputes warnings
+        // once and notifies views once. No-op when nothing is pending.
+        void applyPendingUpdates();
 
     signals:
         void lastErrorChanged(const QString& error);
@@ -84,6 +149,8 @@ namespace network {
         void laneStateUpdated();
         void markingModelUpdated();
         void warningModelUpdated();
+        // After every publish; direct connections only
+        void snapshotPublished(const domain::DomainSnapshotPtr& snapshot);
 
 
     private:
@@ -92,16 +159,26 @@ namespace network {
         void setLastError(const QString& error);
 
         void createWorkerIfNeeded();
+        bool createIngestEngine();
         void destroyWorker();
+        void startReader(const QString& host, quint16 port);
+        void ingestStreamStateChanged(StreamId stream, StreamState state);
 
         void scheduleReconnect();
         void attemptReconnect();
         void resetReconnectState();
 
-        void laneSummaryReceived(const laneproto::LaneSummary& summary);
-        void markingObjectsReceived(const laneproto::MarkingObjects& objects);
+        void drainMessages();
+        void laneSummaryReceived(const laneproto::LaneSummary& summary, std::uint64_t sensor_ms);
+        void markingObjectsReceived(const laneproto::MarkingObjects& objects, std::uint64_t sensor_ms);
+        void observeTimestamp(std::uint32_t sensor_ms, std::uint64_t received_ms, std::uint64_t& unwrapped_ms);
+
+        void applyLaneSummary(const laneproto::LaneSummary& summary, std::uint64_t sensor_ms);
+        void applyMarkingObjects(const laneproto::MarkingObjects& objects, std::uint64_t sensor_ms);
+        void schedulePendingUpdate();
 
         void updateWarnings(std::uint64_t timestamp_ms);
+        void publishSnapshot();
 
         State state_{State::Disconnected};
         bool connected_{false};
@@ -109,6 +186,13 @@ namespace network {
 
         QThread* workerThread_{nullptr};
         TcpReaderWorker* worker_{nullptr};
+        IngestBackend ingest_backend_{IngestBackend::Epoll};
+        std::unique_ptr<IngestQueueSink> ingest_sink_;
+        std::unique_ptr<IngestEngine> ingest_engine_;     // declared after its sink
+        StreamId ingest_stream_{kInvalidStreamId};
+        std::shared_ptr<ParsedMessageQueue> message_queue_;
+        std::size_t message_queue_capacity_{256};
+        OverflowPolicy message_queue_policy_{OverflowPolicy::DropOldest};
 
         bool auto_reconnect_{true};
         int reconnect_interval_{5000};  
@@ -118,10 +202,30 @@ namespace network {
         quint16 saved_port_{0};
         QTimer* reconnect_timer_{nullptr};
 
+        UpdateMode update_mode_{UpdateMode::Immediate};
+        int update_interval_ms_{16};
+        QTimer* update_timer_{nullptr};
+        laneproto::LaneSummary pending_lane_;
+        laneproto::MarkingObjects pending_markings_;
+        std::uint64_t pending_lane_sensor_ms_{0};
+        std::uint64_t pending_markings_sensor_ms_{0};
+        bool lane_dirty_{false};
+        bool markings_dirty_{false};
+        UpdateCoalescingStats update_stats_;
+
         domain::LaneState lane_state_;
         domain::MarkingObjectModel marking_model_;
+        domain::MarkingTracker marking_tracker_;
+        domain::MarkingIndex marking_index_;    // over marking_model_
         domain::WarningModel warning_model_;
+        std::vector<domain::Warning> warning_buffer_;
         domain::WarningEngine warning_engine_;
+        domain::SnapshotPublisher snapshot_publisher_;
+
+        domain::SensorTimebase timebase_;
+        std::uint64_t lane_sensor_ms_{0};       // unwrapped timestamps of the applied state
+        std::uint64_t markings_sensor_ms_{0};
+        bool timebase_has_drift_{false};
 
         viewmodels::LaneStateViewModel* lane_view_model_{nullptr};
         viewmodels::MarkingObjectListModel* marking_list_model_{nullptr};
@@ -0,0 +1,557 @@
+#include "IngestEngine.h"
+#include "LoggerMacros.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+#include <netdb.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    constexpr int kMaxEpollEvents = 256;
+
+    // epoll_event.data.u64 for the loop's own wakeup eventfd; streams use their id
+    constexpr std::uint64_t kWakeToken = ~std::uint64_t{0};
+
+    std::string errnoString(int err) {
+        return std::strerror(err);
+    }
+}
+
+namespace network {
+
+    StreamEndpoint StreamEndpoint::tcp(std::string host, std::uint16_t port) {
+        StreamEndpoint endpoint;
+        endpoint.kind = Kind::Tcp;
+        endpoint.host = std::move(host);
+        endpoint.port = port;
+        return endpoint;
+    }
+
+    StreamEndpoint StreamEndpoint::unixSocket(std::string path) {
+        StreamEndpoint endpoint;
+        endpoint.kind = Kind::Unix;
+        endpoint.path = std::move(path);
+        return endpoint;
+    }
+
+    std::string StreamEndpoint::toString() const {
+        if (kind == Kind::Unix)
+            return "unix:" + path;
+        return host + ":" + std::to_string(port);
+    }
+
+    struct IngestEngine::Stream final : laneproto::IMessageViewHandler {
+        Stream(StreamId stream_id, const StreamEndpoint& ep, IIngestSink& stream_sink)
+            : id(stream_id), endpoint(ep), sink(stream_sink) {}
+
+        const StreamId id;
+        const StreamEndpoint endpoint;
+        IIngestSink& sink;
+
+        sockaddr_storage addr{};
+        socklen_t addr_len = 0;
+
+        // owned by the event loop thread
+        int fd = -1;
+        StreamState state = StreamState::Disconnected;
+        bool retry_pending = false;
+        Clock::time_point retry_at{};
+        laneproto::ProtoParser parser{static_cast<laneproto::IMessageViewHandler&>(*this)};
+
+        std::atomic<std::uint64_t> bytes_received{0};
+        std::atomic<std::uint64_t> lane_summaries{0};
+        std::atomic<std::uint64_t> marking_objects{0};
+        std::atomic<std::uint64_t> parse_errors{0};
+        std::atomic<std::uint64_t> reconnects{0};
+
+        void onLaneSummary(const laneproto::LaneSummaryView& msg) override {
+            lane_summaries.fetch_add(1, std::memory_order_relaxed);
+            sink.onLaneSummary(id, msg);
+        }
+
+        void onMarkingObjects(const laneproto::MarkingObjectsView& msg) override {
+            marking_objects.fetch_add(1, std::memory_order_relaxed);
+            sink.onMarkingObjects(id, msg);
+        }
+
+        void onParseError(const laneproto::ParseError& error) override {
+            parse_errors.fetch_add(1, std::memory_order_relaxed);
+            sink.onParseError(id, error);
+        }
+    };
+
+    class IngestEngine::EventLoop {
+    public:
+        EventLoop(const IngestEngineConfig& config, std::size_t index, std::atomic<bool>& engine_running)
+            : config_(config)
+            , index_(index)
+            , engine_running_(engine_running)
+            , read_buf_(std::max<std::size_t>(config.read_buffer_size, 1))
+        {
+            epoll_fd_ = ::epoll_create1(EPOLL_CLOEXEC);
+            wake_fd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+            if (epoll_fd_ < 0 || wake_fd_ < 0) {
+                LOG_ERROR << "IngestEngine loop " << index_ << ": failed to create epoll/eventfd: "
+                          << errnoString(errno);
+                return;
+            }
+
+            epoll_event ev{};
+            ev.events = EPOLLIN;
+            ev.data.u64 = kWakeToken;
+            ::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wake_fd_, &ev);
+        }
+
+        ~EventLoop() {
+            stop();
+            if (wake_fd_ >= 0) ::close(wake_fd_);
+            if (epoll_fd_ >= 0) ::close(epoll_fd_);
+        }
+
+        bool isValid() const noexcept { return epoll_fd_ >= 0 && wake_fd_ >= 0; }
+
+        void start() {
+            {
+                // Commands posted while the loop was down are superseded by
+                // the engine re-adding every stream
+                std::lock_guard<std::mutex> guard(mutex_);
+                pending_.clear();
+            }
+            stop_requested_.store(false);
+            thread_ = std::thread([this]() { run(); });
+        }
+
+        void stop() {
+            if (!thread_.joinable())
+                return;
+            stop_requested_.store(true);
+            wake();
+            thread_.join();
+        }
+
+        void postAdd(const std::shared_ptr<Stream>& stream) {
+            {
+                std::lock_guard<std::mutex> guard(mutex_);
+                pending_.push_back(Command{Command::Type::Add, stream, stream->id});
+            }
+            wake();
+        }
+
+        void postRemove(StreamId id) {
+            {
+                std::lock_guard<std::mutex> guard(mutex_);
+                pending_.push_back(Command{Command::Type::Remove, nullptr, id});
+            }
+            wake();
+        }
+
+    private:
+        struct Command {
+            enum class Type { Add, Remove };
+            Type type;
+            std::shared_ptr<Stream> stream;
+            StreamId id;
+        };
+
+        const IngestEngineConfig& config_;
+        const std::size_t index_;
+        std::atomic<bool>& engine_running_;
+
+        int epoll_fd_ = -1;
+        int wake_fd_ = -1;
+        std::thread thread_;
+        std::atomic<bool> stop_requested_{false};
+
+        std::mutex mutex_;
+        std::vector<Command> pending_;
+        std::vector<Command> draining_;
+
+        std::unordered_map<StreamId, std::shared_ptr<Stream>> streams_;
+        std::vector<std::uint8_t> read_buf_;
+
+        void wake() {
+            const std::uint64_t one = 1;
+            [[maybe_unused]] const auto written = ::write(wake_fd_, &one, sizeof(one));
+        }
+
+        void run() {
+            LOG_DEBUG << "IngestEngine loop " << index_ << " started";
+            epoll_event events[kMaxEpollEvents];
+
+            while (!stop_requested_.load()) {
+                const int n = ::epoll_wait(epoll_fd_, events, kMaxEpollEvents, nextTimeoutMs());
+                if (n < 0 && errno != EINTR) {
+                    // Not transient, so retrying would only spin. The engine
+                    // reports itself stopped and start() brings it back.
+                    LOG_ERROR << "IngestEngine loop " << index_ << ": epoll_wait failed: "
+                              << errnoString(errno);
+                    engine_running_.store(false);
+                    break;
+                }
+
+                bool woken = false;
+                for (int i = 0; i < n; ++i) {
+                    if (events[i].data.u64 == kWakeToken) {
+                        woken = true;
+                        continue;
+                    }
+                    auto it = streams_.find(static_cast<StreamId>(events[i].data.u64));
+                    if (it != streams_.end()) {
+                        handleEvent(*it->second, events[i].events);
+                    }
+                }
+
+                // Commands run after the batch so no event refers to a stream
+                // that was removed (or whose fd was reused) mid-batch.
+                if (woken) {
+                    std::uint64_t counter = 0;
+                    [[maybe_unused]] const auto read = ::read(wake_fd_, &counter, sizeof(counter));
+                    drainCommands();
+                }
+                processRetries();
+            }
+
+            // The streams outlive the loop and are re-added on the next start,
+            // so leave them Disconnected and tell the sink, as on any other close
+            for (auto& [id, stream] : streams_) {
+                closeSocket(*stream);
+                stream->retry_pending = false;
+                setState(*stream, StreamState::Disconnected);
+            }
+            streams_.clear();
+            {
+                std::lock_guard<std::mutex> guard(mutex_);
+                pending_.clear();
+            }
+            LOG_DEBUG << "IngestEngine loop " << index_ << " stopped";
+        }
+
+        void drainCommands() {
+            {
+                std::lock_guard<std::mutex> guard(mutex_);
+                draining_.swap(pending_);
+            }
+            for (auto& cmd : draining_) {
+                switch (cmd.type) {
+                    case Command::Type::Add:
+                        streams_[cmd.id] = cmd.stream;
+                        openStream(*cmd.stream);
+                        break;
+                    case Command::Type::Remove: {
+                        auto it = streams_.find(cmd.id);
+                        if (it == streams_.end())
+                            break;
+                        closeSocket(*it->second);
+                        setState(*it->second, StreamState::Removed);
+                        streams_.erase(it);
+                        break;
+                    }
+                }
+            }
+            draining_.clear();
+        }
+
+        void setState(Stream& stream, StreamState state) {
+            if (stream.state == state)
+                return;
+            stream.state = state;
+            stream.sink.onStreamStateChanged(stream.id, state);
+        }
+
+        void openStream(Stream& stream) {
+            stream.retry_pending = false;
+            stream.parser.reset();
+            // Before connect(), so an immediate failure is still reported as
+            // a Connecting -> Disconnected change
+            setState(stream, StreamState::Connecting);
+
+            const int fd = ::socket(stream.addr.ss_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+            if (fd < 0) {
+                LOG_ERROR << "Stream " << stream.id << ": socket() failed: " << errnoString(errno);
+                scheduleRetry(stream);
+                return;
+            }
+
+            stream.fd = fd;
+            const int rc = ::connect(fd, reinterpret_cast<const sockaddr*>(&stream.addr), stream.addr_len);
+            if (rc != 0 && errno != EINPROGRESS) {
+                LOG_WARN << "Stream " << stream.id << " (" << stream.endpoint.toString()
+                         << "): connect failed: " << errnoString(errno);
+                closeSocket(stream);
+                scheduleRetry(stream);
+                return;
+            }
+
+            epoll_event ev{};
+            ev.events = rc == 0 ? (EPOLLIN | EPOLLRDHUP) : EPOLLOUT;
+            ev.data.u64 = stream.id;
+            if (::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &ev) != 0) {
+                LOG_ERROR << "Stream " << stream.id << ": epoll_ctl failed: " << errnoString(errno);
+                closeSocket(stream);
+                scheduleRetry(stream);
+                return;
+            }
+
+            if (rc == 0)
+                onConnected(stream);
+        }
+
+        void onConnected(Stream& stream) {
+            LOG_INFO << "Stream " << stream.id << " connected to " << stream.endpoint.toString();
+            setState(stream, StreamState::Connected);
+        }
+
+        void closeSocket(Stream& stream) {
+            if (stream.fd < 0)
+                return;
+            ::epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, stream.fd, nullptr);
+            ::close(stream.fd);
+            stream.fd = -1;
+        }
+
+        void disconnect(Stream& stream, const char* reason) {
+            LOG_WARN << "Stream " << stream.id << " (" << stream.endpoint.toString()
+                     << ") disconnected: " << reason;
+            closeSocket(stream);
+            scheduleRetry(stream);
+        }
+
+        void scheduleRetry(Stream& stream) {
+            setState(stream, StreamState::Disconnected);
+            if (config_.reconnect_interval_ms <= 0 || stop_requested_.load())
+                return;
+            stream.retry_pending = true;
+            stream.retry_at = Clock::now() + std::chrono::milliseconds(config_.reconnect_interval_ms);
+        }
+
+        void processRetries() {
+            const auto now = Clock::now();
+            for (auto& [id, stream] : streams_) {
+                if (stream->retry_pending && stream->retry_at <= now) {
+                    stream->reconnects.fetch_add(1, std::memory_order_relaxed);
+                    openStream(*stream);
+                }
+            }
+        }
+
+        int nextTimeoutMs() const {
+            bool any = false;
+            Clock::time_point earliest{};
+            for (const auto& [id, stream] : streams_) {
+                if (stream->retry_pending && (!any || stream->retry_at < earliest)) {
+                    earliest = stream->retry_at;
+                    any = true;
+                }
+            }
+            if (!any)
+                return -1;
+            const auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(earliest - Clock::now());
+            return static_cast<int>(std::max<std::chrono::milliseconds::rep>(wait.count(), 0));
+        }
+
+        void handleEvent(Stream& stream, std::uint32_t events) {
+            if (stream.fd < 0)
+                return;
+
+            if (stream.state == StreamState::Connecting) {
+                int err = 0;
+                socklen_t len = sizeof(err);
+                ::getsockopt(stream.fd, SOL_SOCKET, SO_ERROR, &err, &len);
+                if (err != 0) {
+                    disconnect(stream, std::strerror(err));
+                    return;
+                }
+                if (!(events & EPOLLOUT))
+                    return;
+
+                epoll_event ev{};
+                ev.events = EPOLLIN | EPOLLRDHUP;
+                ev.data.u64 = stream.id;
+                ::epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, stream.fd, &ev);
+                onConnected(stream);
+                return;
+            }
+
+            if (events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) {
+                readAvailable(stream);
+            }
+        }
+
+        void readAvailable(Stream& stream) {
+            for (int i = 0; i < config_.max_reads_per_event; ++i) {
+                const ssize_t n = ::recv(stream.fd, read_buf_.data(), read_buf_.size(), 0);
+                if (n > 0) {
+                    stream.bytes_received.fetch_add(static_cast<std::uint64_t>(n), std::memory_order_relaxed);
+                    stream.parser.feed(read_buf_.data(), static_cast<std::size_t>(n));
+                    if (static_cast<std::size_t>(n) < read_buf_.size())
+                        return;
+                    continue;
+                }
+                if (n == 0) {
+                    disconnect(stream, "closed by peer");
+                    return;
+                }
+                if (errno == EINTR)
+                    continue;
+                if (errno == EAGAIN || errno == EWOULDBLOCK)
+                    return;
+                disconnect(stream, std::strerror(errno));
+                return;
+            }
+            // Budget exhausted; level-triggered epoll reports the rest next round.
+        }
+    };
+
+    IngestEngine::IngestEngine(IIngestSink& sink, const IngestEngineConfig& config)
+        : sink_(sink)
+        , config_(config)
+    {
+        config_.thread_count = std::max<std::size_t>(config_.thread_count, 1);
+        config_.max_reads_per_event = std::max(config_.max_reads_per_event, 1);
+
+        loops_.reserve(config_.thread_count);
+        for (std::size_t i = 0; i < config_.thread_count; ++i) {
+            loops_.push_back(std::make_unique<EventLoop>(config_, i, running_));
+        }
+    }
+
+    IngestEngine::~IngestEngine() {
+        stop();
+    }
+
+    IngestEngine::EventLoop& IngestEngine::loopFor(StreamId id) {
+        return *loops_[id % loops_.size()];
+    }
+
+    bool IngestEngine::start() {
+        if (running_.load())
+            return true;
+
+        for (const auto& loop : loops_) {
+            if (!loop->isValid()) {
+                LOG_ERROR << "IngestEngine cannot start: event loop initialisation failed";
+                return false;
+            }
+        }
+
+        // After a loop failure the others are still running; join them all
+        // before starting over
+        for (const auto& loop : loops_) {
+            loop->stop();
+        }
+
+        std::lock_guard<std::mutex> guard(mutex_);
+        running_.store(true);
+        for (const auto& loop : loops_) {
+            loop->start();
+        }
+        for (const auto& [id, stream] : streams_) {
+            loopFor(id).postAdd(stream);
+        }
+        LOG_INFO << "IngestEngine started: threads=" << loops_.size() << ", streams=" << streams_.size();
+        return true;
+    }
+
+    void IngestEngine::stop() {
+        // Loops may still be running after a failure already cleared running_
+        const bool was_running = running_.exchange(false);
+        for (const auto& loop : loops_) {
+            loop->stop();
+        }
+        if (was_running)
+            LOG_INFO << "IngestEngine stopped";
+    }
+
+    bool IngestEngine::isRunning() const noexcept {
+        return running_.load();
+    }
+
+    StreamId IngestEngine::addStream(const StreamEndpoint& endpoint) {
+        sockaddr_storage addr{};
+        socklen_t addr_len = 0;
+
+        if (endpoint.kind == StreamEndpoint::Kind::Unix) {
+            sockaddr_un un{};
+            if (endpoint.path.empty() || endpoint.path.size() >= sizeof(un.sun_path)) {
+                LOG_ERROR << "Invalid unix socket path: '" << endpoint.path << "'";
+                return kInvalidStreamId;
+            }
+            un.sun_family = AF_UNIX;
+            std::memcpy(un.sun_path, endpoint.path.c_str(), endpoint.path.size() + 1);
+            std::memcpy(&addr, &un, sizeof(un));
+            addr_len = static_cast<socklen_t>(sizeof(un));
+        } else {
+            addrinfo hints{};
+            hints.ai_family = AF_UNSPEC;
+            hints.ai_socktype = SOCK_STREAM;
+            hints.ai_flags = AI_NUMERICSERV;
+
+            addrinfo* result = nullptr;
+            const std::string port = std::to_string(endpoint.port);
+            const int rc = ::getaddrinfo(endpoint.host.c_str(), port.c_str(), &hints, &result);
+            if (rc != 0 || result == nullptr) {
+                LOG_ERROR << "Cannot resolve " << endpoint.toString() << ": " << ::gai_strerror(rc);
+                return kInvalidStreamId;
+            }
+            std::memcpy(&addr, result->ai_addr, result->ai_addrlen);
+            addr_len = result->ai_addrlen;
+            ::freeaddrinfo(result);
+        }
+
+        std::lock_guard<std::mutex> guard(mutex_);
+        const StreamId id = next_id_++;
+        auto stream = std::make_shared<Stream>(id, endpoint, sink_);
+        stream->addr = addr;
+        stream->addr_len = addr_len;
+        streams_.emplace(id, stream);
+
+        if (running_.load()) {
+            loopFor(id).postAdd(stream);
+        }
+        LOG_INFO << "Stream " << id << " added: " << endpoint.toString();
+        return id;
+    }
+
+    bool IngestEngine::removeStream(StreamId id) {
+        std::lock_guard<std::mutex> guard(mutex_);
+        if (streams_.erase(id) == 0)
+            return false;
+
+        if (running_.load()) {
+            loopFor(id).postRemove(id);
+        }
+        LOG_INFO << "Stream " << id << " removed";
+        return true;
+    }
+
+    bool IngestEngine::streamStats(StreamId id, StreamStats& out) const {
+        std::lock_guard<std::mutex> guard(mutex_);
+        auto it = streams_.find(id);
+        if (it == streams_.end())
+            return false;
+
+        const Stream& stream = *it->second;
+        out.bytes_received = stream.bytes_received.load(std::memory_order_relaxed);
+        out.lane_summaries = stream.lane_summaries.load(std::memory_order_relaxed);
+        out.marking_objects = stream.marking_objects.load(std::memory_order_relaxed);
+        out.parse_errors = stream.parse_errors.load(std::memory_order_relaxed);
+        out.reconnects = stream.reconnects.load(std::memory_order_relaxed);
+        return true;
+    }
+
+    std::size_t IngestEngine::streamCount() const {
+        std::lock_guard<std::mutex> guard(mutex_);
+        return streams_.size();
+    }
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "proto_parser.h"
+
+namespace network {
+
+    using StreamId = std::uint32_t;
+    constexpr StreamId kInvalidStreamId = 0;
+
+    struct StreamEndpoint {
+        enum class Kind {
+            Tcp,
+            Unix,
+        };
+
+        Kind kind = Kind::Tcp;
+        std::string host;           // Tcp: host name or address
+        std::uint16_t port = 0;     // Tcp
+        std::string path;           // Unix: filesystem socket path
+
+        static StreamEndpoint tcp(std::string host, std::uint16_t port);
+        static StreamEndpoint unixSocket(std::string path);
+
+        std::string toString() const;
+    };
+
+    enum class StreamState {
+        Connecting,
+        Connected,
+        Disconnected,   // waiting for the reconnect timer (or given up)
+        Removed,
+    };
+
+    struct StreamStats {
+        std::uint64_t bytes_received = 0;
+        std::uint64_t lane_summaries = 0;
+        std::uint64_t marking_objects = 0;
+        std::uint64_t parse_errors = 0;
+        std::uint64_t reconnects = 0;
+    };
+
+    // Receives everything the engine parses. Called on the engine's event-loop
+    // threads; views are only valid for the duration of the call.
+    class IIngestSink {
+    public:
+        virtual ~IIngestSink() = default;
+
+        virtual void onLaneSummary(StreamId stream, const laneproto::LaneSummaryView& msg) = 0;
+        virtual void onMarkingObjects(StreamId stream, const laneproto::MarkingObjectsView& msg) = 0;
+        virtual void onParseError(StreamId stream, const laneproto::ParseError& error) = 0;
+        virtual void onStreamStateChanged(StreamId stream, StreamState state) = 0;
+    };
+
+    struct IngestEngineConfig {
+        std::size_t thread_count = 1;
+        std::size_t read_buffer_size = 64 * 1024;
+        int reconnect_interval_ms = 1000;       // 0 = do not reconnect
+        int max_reads_per_event = 4;            // fairness between streams of one loop
+    };
+
+    // Multiplexes many sensor streams (TCP or Unix sockets) over a small,
+    // fixed number of epoll threads. Each stream owns a ProtoParser; each
+    // loop owns one preallocated read buffer that every recv() lands in, so
+    // steady-state ingest does not allocate. Linux only.
+    class IngestEngine {
+    public:
+        explicit IngestEngine(IIngestSink& sink, const IngestEngineConfig& config = {});
+        ~IngestEngine();
+
+        IngestEngine(const IngestEngine&) = delete;
+        IngestEngine& operator=(const IngestEngine&) = delete;
+        IngestEngine(IngestEngine&&) = delete;
+        IngestEngine& operator=(IngestEngine&&) = delete;
+
+        // start() also restarts an engine whose event loop failed; isRunning()
+        // turns false as soon as one does.
+        bool start();
+        void stop();
+        [[nodiscard]] bool isRunning() const noexcept;
+
+        // Thread-safe. Streams added before start() connect once it is called.
+        StreamId addStream(const StreamEndpoint& endpoint);
+        bool removeStream(StreamId id);
+
+        [[nodiscard]] bool streamStats(StreamId id, StreamStats& out) const;
+        [[nodiscard]] std::size_t streamCount() const;
+        [[nodiscard]] const IngestEngineConfig& config() const noexcept { return config_; }
+
+    private:
+        struct Stream;
+        class EventLoop;
+
+        IIngestSink& sink_;
+        IngestEngineConfig config_;
+
+        std::vector<std::unique_ptr<EventLoop>> loops_;
+
+        mutable std::mutex mutex_;
+        std::unordered_map<StreamId, std::shared_ptr<Stream>> streams_;
+        StreamId next_id_ = 1;
+        std::atomic<bool> running_{false};
+
+        EventLoop& loopFor(StreamId id);
+    };
+}
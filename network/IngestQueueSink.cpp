@@ -0,0 +1,57 @@
+#include "IngestQueueSink.h"
+#include "LoggerMacros.hpp"
+#include "SensorTimebase.h"
+#include <utility>
+
+namespace {
+    constexpr std::uint64_t kDropReportIntervalMs = 1000;
+}
+
+namespace network {
+    IngestQueueSink::IngestQueueSink(std::shared_ptr<ParsedMessageQueue> queue, Callbacks callbacks)
+        : queue_(std::move(queue))
+        , callbacks_(std::move(callbacks))
+    {
+    }
+
+    void IngestQueueSink::onLaneSummary(StreamId stream, const laneproto::LaneSummaryView& msg) {
+        const std::uint64_t now_ms = domain::hostClockMs();
+        BLOG_TRACE("Stream {}: LaneSummary seq={}", stream, msg.seq());
+        queue_->push(msg, now_ms);
+        queued(now_ms);
+    }
+
+    void IngestQueueSink::onMarkingObjects(StreamId stream, const laneproto::MarkingObjectsView& msg) {
+        const std::uint64_t now_ms = domain::hostClockMs();
+        BLOG_TRACE("Stream {}: MarkingObjects seq={}, objects={}", stream, msg.seq(), msg.size());
+        queue_->push(msg, now_ms);
+        queued(now_ms);
+    }
+
+    void IngestQueueSink::onParseError(StreamId stream, const laneproto::ParseError& error) {
+        LOG_ERROR << "Stream " << stream << ": parse error: " << error.message;
+        if (callbacks_.parseErrorOccurred)
+            callbacks_.parseErrorOccurred(stream, error);
+    }
+
+    void IngestQueueSink::onStreamStateChanged(StreamId stream, StreamState state) {
+        if (callbacks_.streamStateChanged)
+            callbacks_.streamStateChanged(stream, state);
+    }
+
+    // Same drop summary as TcpReaderWorker: at most one line per interval
+    void IngestQueueSink::queued(std::uint64_t now_ms) {
+        if (now_ms - drop_report_ms_ >= kDropReportIntervalMs) {
+            const std::uint64_t dropped = queue_->stats().dropped;
+            if (dropped != reported_drops_) {
+                LOG_WARN << "Message queue full (" << overflowPolicyName(queue_->policy()) << "): "
+                         << (dropped - reported_drops_) << " messages dropped, " << dropped << " in total";
+                reported_drops_ = dropped;
+            }
+            drop_report_ms_ = now_ms;
+        }
+
+        if (queue_->armWakeup() && callbacks_.messagesAvailable)
+            callbacks_.messagesAvailable();
+    }
+}
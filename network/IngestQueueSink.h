@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include "IngestEngine.h"
+#include "MessageQueue.h"
+
+namespace network {
+
+    // Hands what IngestEngine parses to the consumer the way TcpReaderWorker
+    // does: messages are decoded straight into ParsedMessageQueue slots and
+    // messagesAvailable runs once per batch, when the consumer has drained
+    // the last one. The callbacks run on the engine's event-loop thread.
+    //
+    // The queue has a single producer, so the engine must run with one
+    // event-loop thread (IngestEngineConfig::thread_count = 1); any number of
+    // streams may share it.
+    class IngestQueueSink : public IIngestSink {
+    public:
+        struct Callbacks {
+            std::function<void()> messagesAvailable;
+            std::function<void(StreamId, StreamState)> streamStateChanged;
+            std::function<void(StreamId, const laneproto::ParseError&)> parseErrorOccurred;
+        };
+
+        IngestQueueSink(std::shared_ptr<ParsedMessageQueue> queue, Callbacks callbacks);
+
+        void onLaneSummary(StreamId stream, const laneproto::LaneSummaryView& msg) override;
+        void onMarkingObjects(StreamId stream, const laneproto::MarkingObjectsView& msg) override;
+        void onParseError(StreamId stream, const laneproto::ParseError& error) override;
+        void onStreamStateChanged(StreamId stream, StreamState state) override;
+
+    private:
+        std::shared_ptr<ParsedMessageQueue> queue_;
+        Callbacks callbacks_;
+        std::uint64_t reported_drops_ = 0;  // queue drops already logged
+        std::uint64_t drop_report_ms_ = 0;  // when they were
+
+        void queued(std::uint64_t now_ms);
+    };
+}
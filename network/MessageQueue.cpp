@@ -0,0 +1,125 @@
+#include "MessageQueue.h"
+
+namespace {
+
+    constexpr std::size_t kMaxMarkingObjects =
+        (laneproto::kMaxPayloadLength - 1) / laneproto::kMarkingObjectRecordSize;
+
+    // Marking vectors are sized once for the protocol maximum; vector copy
+    // assignment then reuses that storage for every later message.
+    void reserveMessage(network::ParsedMessage& msg) {
+        msg.marking_objects.objects.reserve(kMaxMarkingObjects);
+    }
+}
+
+namespace network {
+
+    const char* overflowPolicyName(OverflowPolicy policy) noexcept {
+        switch (policy) {
+            case OverflowPolicy::DropOldest:
+                return "drop_oldest";
+            case OverflowPolicy::DropNewest:
+                return "drop_newest";
+            case OverflowPolicy::CoalesceLatest:
+                return "coalesce_latest";
+        }
+        return "unknown";
+    }
+
+    bool overflowPolicyFromString(const std::string& name, OverflowPolicy& out) noexcept {
+        for (auto policy : {OverflowPolicy::DropOldest, OverflowPolicy::DropNewest,
+                            OverflowPolicy::CoalesceLatest}) {
+            if (name == overflowPolicyName(policy)) {
+                out = policy;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    ParsedMessageQueue::ParsedMessageQueue(std::size_t capacity, OverflowPolicy policy)
+        : policy_(policy)
+        , ring_(policy == OverflowPolicy::CoalesceLatest ? 2 : capacity,
+                policy == OverflowPolicy::CoalesceLatest ? std::function<void(ParsedMessage&)>{}
+                                                         : reserveMessage)
+        , latest_lane_()
+        , latest_markings_(policy == OverflowPolicy::CoalesceLatest ? reserveMessage
+                                                                    : std::function<void(ParsedMessage&)>{})
+    {
+    }
+
+    template <typename Fill>
+    bool ParsedMessageQueue::pushImpl(LatestValue<ParsedMessage>& latest, Fill&& fill) {
+        pushed_.fetch_add(1, std::memory_order_relaxed);
+
+        if (policy_ == OverflowPolicy::CoalesceLatest) {
+            if (latest.publish(fill))
+                coalesced_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        if (ring_.tryPush(fill))
+            return true;
+
+        // The ring is full. Dropping the oldest only frees room when the
+        // consumer is not reading that very slot; otherwise fall through and
+        // drop the incoming message instead.
+        if (policy_ == OverflowPolicy::DropOldest && ring_.dropOldest()) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            if (ring_.tryPush(fill))
+                return true;
+        }
+
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    bool ParsedMessageQueue::push(const laneproto::LaneSummary& msg, std::uint64_t received_ms) {
+        return pushImpl(latest_lane_, [&msg, received_ms](ParsedMessage& slot) {
+            slot.kind = ParsedMessage::Kind::LaneSummary;
+            slot.received_ms = received_ms;
+            slot.lane_summary = msg;
+        });
+    }
+
+    bool ParsedMessageQueue::push(const laneproto::MarkingObjects& msg, std::uint64_t received_ms) {
+        return pushImpl(latest_markings_, [&msg, received_ms](ParsedMessage& slot) {
+            slot.kind = ParsedMessage::Kind::MarkingObjects;
+            slot.received_ms = received_ms;
+            slot.marking_objects = msg;
+        });
+    }
+
+    bool ParsedMessageQueue::push(const laneproto::LaneSummaryView& msg, std::uint64_t received_ms) {
+        return pushImpl(latest_lane_, [&msg, received_ms](ParsedMessage& slot) {
+            slot.kind = ParsedMessage::Kind::LaneSummary;
+            slot.received_ms = received_ms;
+            slot.lane_summary = msg.decode();
+        });
+    }
+
+    bool ParsedMessageQueue::push(const laneproto::MarkingObjectsView& msg, std::uint64_t received_ms) {
+        return pushImpl(latest_markings_, [&msg, received_ms](ParsedMessage& slot) {
+            slot.kind = ParsedMessage::Kind::MarkingObjects;
+            slot.received_ms = received_ms;
+            msg.decodeInto(slot.marking_objects);
+        });
+    }
+
+    bool ParsedMessageQueue::armWakeup() noexcept {
+        // Orders the slot publication in push() before the flag load; see drain()
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (wakeup_armed_.load(std::memory_order_relaxed))
+            return false;
+        return !wakeup_armed_.exchange(true, std::memory_order_acq_rel);
+    }
+
+    MessageQueueStats ParsedMessageQueue::stats() const noexcept {
+        MessageQueueStats stats;
+        stats.pushed = pushed_.load(std::memory_order_relaxed);
+        stats.delivered = delivered_.load(std::memory_order_relaxed);
+        stats.dropped = dropped_.load(std::memory_order_relaxed);
+        stats.coalesced = coalesced_.load(std::memory_order_relaxed);
+        return stats;
+    }
+}
@@ -0,0 +1,231 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include "proto_parser.h"
+
+namespace network {
+
+    // Bounded single-producer/single-consumer ring of preallocated slots.
+    // Every slot carries a sequence number: a slot at position `pos` is free
+    // for the producer when seq == pos, readable when seq == pos + 1, and is
+    // released by storing pos + capacity. The consumer claims with a CAS on
+    // head_, which lets the producer discard the oldest element (dropOldest)
+    // without ever touching a slot the consumer is still reading.
+    template <typename T>
+    class SpscRing {
+    public:
+        explicit SpscRing(std::size_t capacity, const std::function<void(T&)>& init = {})
+        {
+            std::size_t size = 2;
+            while (size < capacity)
+                size <<= 1;
+            mask_ = size - 1;
+            slots_.reset(new Slot[size]);
+            for (std::size_t i = 0; i < size; ++i) {
+                slots_[i].seq.store(i, std::memory_order_relaxed);
+                if (init)
+                    init(slots_[i].value);
+            }
+        }
+
+        SpscRing(const SpscRing&) = delete;
+        SpscRing& operator=(const SpscRing&) = delete;
+
+        std::size_t capacity() const noexcept { return mask_ + 1; }
+
+        // Producer. `fill(T&)` writes the element in place; returns false if full.
+        template <typename Fill>
+        bool tryPush(Fill&& fill) {
+            Slot& slot = slots_[tail_ & mask_];
+            if (slot.seq.load(std::memory_order_acquire) != tail_)
+                return false;
+            fill(slot.value);
+            slot.seq.store(tail_ + 1, std::memory_order_release);
+            ++tail_;
+            return true;
+        }
+
+        // Producer. Discards the oldest unclaimed element; false if there is none.
+        bool dropOldest() {
+            return claim([](const T&) {});
+        }
+
+        // Consumer. `consume(const T&)` reads the element in place.
+        template <typename Consume>
+        bool tryPop(Consume&& consume) {
+            return claim(std::forward<Consume>(consume));
+        }
+
+    private:
+        struct Slot {
+            std::atomic<std::size_t> seq{0};
+            T value{};
+        };
+
+        template <typename Consume>
+        bool claim(Consume&& consume) {
+            std::size_t pos = head_.load(std::memory_order_relaxed);
+            for (;;) {
+                Slot& slot = slots_[pos & mask_];
+                if (slot.seq.load(std::memory_order_acquire) != pos + 1)
+                    return false;
+                if (head_.compare_exchange_weak(pos, pos + 1,
+                                                std::memory_order_acq_rel,
+                                                std::memory_order_relaxed)) {
+                    consume(static_cast<const T&>(slot.value));
+                    slot.seq.store(pos + capacity(), std::memory_order_release);
+                    return true;
+                }
+            }
+        }
+
+        std::unique_ptr<Slot[]> slots_;
+        std::size_t mask_ = 0;
+        alignas(64) std::atomic<std::size_t> head_{0};
+        alignas(64) std::size_t tail_ = 0;
+    };
+
+    // Single-producer/single-consumer "latest value" mailbox (triple buffer).
+    // publish() never blocks and never fails; an unread value is overwritten.
+    template <typename T>
+    class LatestValue {
+    public:
+        explicit LatestValue(const std::function<void(T&)>& init = {}) {
+            if (init) {
+                for (auto& buffer : buffers_)
+                    init(buffer);
+            }
+        }
+
+        LatestValue(const LatestValue&) = delete;
+        LatestValue& operator=(const LatestValue&) = delete;
+
+        // Producer. Returns true if an unconsumed value was replaced.
+        template <typename Fill>
+        bool publish(Fill&& fill) {
+            fill(buffers_[back_]);
+            const std::uint8_t prev = middle_.exchange(
+                static_cast<std::uint8_t>(back_ | kDirty), std::memory_order_acq_rel);
+            back_ = prev & kIndexMask;
+            return (prev & kDirty) != 0;
+        }
+
+        // Consumer. Calls `consume(const T&)` if a new value was published.
+        template <typename Consume>
+        bool consume(Consume&& consume) {
+            if ((middle_.load(std::memory_order_relaxed) & kDirty) == 0)
+                return false;
+            const std::uint8_t prev = middle_.exchange(front_, std::memory_order_acq_rel);
+            front_ = prev & kIndexMask;
+            consume(static_cast<const T&>(buffers_[front_]));
+            return true;
+        }
+
+    private:
+        static constexpr std::uint8_t kIndexMask = 0x03;
+        static constexpr std::uint8_t kDirty = 0x04;
+
+        T buffers_[3]{};
+        std::atomic<std::uint8_t> middle_{1};
+        alignas(64) std::uint8_t back_ = 0;     // producer
+        alignas(64) std::uint8_t front_ = 2;    // consumer
+    };
+
+    enum class OverflowPolicy {
+        DropOldest,
+        DropNewest,
+        CoalesceLatest,     // keep only the newest message of each kind
+    };
+
+    const char* overflowPolicyName(OverflowPolicy policy) noexcept;
+    // Accepts "drop_oldest", "drop_newest", "coalesce_latest"
+    bool overflowPolicyFromString(const std::string& name, OverflowPolicy& out) noexcept;
+
+    struct ParsedMessage {
+        enum class Kind : std::uint8_t {
+            LaneSummary,
+            MarkingObjects,
+        };
+
+        Kind kind = Kind::LaneSummary;
+        std::uint64_t received_ms = 0;      // domain::hostClockMs() when read off the socket
+        laneproto::LaneSummary lane_summary;
+        laneproto::MarkingObjects marking_objects;
+    };
+
+    struct MessageQueueStats {
+        std::uint64_t pushed = 0;
+        std::uint64_t delivered = 0;
+        std::uint64_t dropped = 0;
+        std::uint64_t coalesced = 0;
+    };
+
+    // Hand-off of parsed messages from the reader thread to the GUI thread.
+    // Slots are preallocated (marking vectors reserve the protocol maximum),
+    // so steady-state pushes do not allocate. The producer asks armWakeup()
+    // after pushing and signals the consumer only when it returns true, so a
+    // burst costs one cross-thread wakeup; the consumer drains everything.
+    class ParsedMessageQueue {
+    public:
+        ParsedMessageQueue(std::size_t capacity, OverflowPolicy policy);
+
+        ParsedMessageQueue(const ParsedMessageQueue&) = delete;
+        ParsedMessageQueue& operator=(const ParsedMessageQueue&) = delete;
+
+        OverflowPolicy policy() const noexcept { return policy_; }
+        std::size_t capacity() const noexcept { return ring_.capacity(); }
+
+        // Producer side. Return false if the incoming message was dropped.
+        bool push(const laneproto::LaneSummary& msg, std::uint64_t received_ms);
+        bool push(const laneproto::MarkingObjects& msg, std::uint64_t received_ms);
+        // Decode straight into the slot
+        bool push(const laneproto::LaneSummaryView& msg, std::uint64_t received_ms);
+        bool push(const laneproto::MarkingObjectsView& msg, std::uint64_t received_ms);
+        bool armWakeup() noexcept;
+
+        // Consumer side. Calls `handler(const ParsedMessage&)` for every
+        // pending message; returns the number delivered.
+        template <typename Handler>
+        std::size_t drain(Handler&& handler) {
+            wakeup_armed_.store(false, std::memory_order_release);
+            // Pairs with the fence in armWakeup(): either the producer sees
+            // the flag cleared and queues a drain, or this drain sees its slot
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            std::size_t count = 0;
+            if (policy_ == OverflowPolicy::CoalesceLatest) {
+                count += latest_lane_.consume(handler) ? 1 : 0;
+                count += latest_markings_.consume(handler) ? 1 : 0;
+            } else {
+                while (ring_.tryPop(handler))
+                    ++count;
+            }
+            delivered_.fetch_add(count, std::memory_order_relaxed);
+            return count;
+        }
+
+        MessageQueueStats stats() const noexcept;
+
+    private:
+        template <typename Fill>
+        bool pushImpl(LatestValue<ParsedMessage>& latest, Fill&& fill);
+
+        const OverflowPolicy policy_;
+
+        SpscRing<ParsedMessage> ring_;
+        LatestValue<ParsedMessage> latest_lane_;
+        LatestValue<ParsedMessage> latest_markings_;
+
+        std::atomic<bool> wakeup_armed_{false};
+
+        std::atomic<std::uint64_t> pushed_{0};
+        std::atomic<std::uint64_t> delivered_{0};
+        std::atomic<std::uint64_t> dropped_{0};
+        std::atomic<std::uint64_t> coalesced_{0};
+    };
+}
@@ -1,13 +1,20 @@
 #include "TcpReaderWorker.h"
 #include "LoggerMacros.hpp"
+#include "SensorTimebase.h"
 #include <QByteArray>
 #include <cstdint>
 #include <cstddef>
+#include <utility>
+
+namespace {
+    constexpr std::uint64_t kDropReportIntervalMs = 1000;
+}
 
 namespace network {
-    TcpReaderWorker::TcpReaderWorker(QObject* parent)
+    TcpReaderWorker::TcpReaderWorker(std::shared_ptr<ParsedMessageQueue> queue, QObject* parent)
         : QObject(parent)
         , socket_(new QTcpSocket(this))
+        , queue_(std::move(queue))
     {
         connect(socket_, &QTcpSocket::connected, this, &TcpReaderWorker::onSocketConnected);
         connect(socket_, &QTcpSocket::disconnected, this, &TcpReaderWorker::onSocketDisconnected);
@@ -67,7 +74,10 @@ namespace network {
         if (data.isEmpty())
             return;
 
-        LOG_TRACE << "Received " << data.size() << " bytes from socket";
+        BLOG_TRACE("Received {} bytes from socket", data.size());
+
+        // Arrival time for every message in this read, for the sensor timebase
+        read_time_ms_ = domain::hostClockMs();
 
         const auto* raw = reinterpret_cast<const std::uint8_t*>(data.constData());
         const std::size_t size = static_cast<std::size_t>(data.size());
@@ -75,19 +85,45 @@ namespace network {
         parser_.feed(raw, size);
     }
 
+    void TcpReaderWorker::notifyQueued()
+    {
+        if (queue_->armWakeup())
+            emit messagesAvailable();
+    }
+
+    // Under sustained overflow drops happen at message rate, so log the
+    // queue's own drop count at most once per interval instead of each one
+    void TcpReaderWorker::reportDrops()
+    {
+        if (read_time_ms_ - drop_report_ms_ < kDropReportIntervalMs)
+            return;
+
+        const std::uint64_t dropped = queue_->stats().dropped;
+        if (dropped != reported_drops_) {
+            LOG_WARN << "Message queue full (" << overflowPolicyName(queue_->policy()) << "): "
+                     << (dropped - reported_drops_) << " messages dropped, " << dropped << " in total";
+            reported_drops_ = dropped;
+        }
+        drop_report_ms_ = read_time_ms_;
+    }
+
     void TcpReaderWorker::MessageHandler::onLaneSummary(const laneproto::LaneSummary& msg){
         LOG_DEBUG << "LaneSummary received: seq=" << static_cast<int>(msg.seq)
                   << ", timestamp=" << msg.timestamp_ms
                   << ", left_offset=" << msg.left_offset_m
                   << ", right_offset=" << msg.right_offset_m;
-        owner_.laneSummaryParsed(msg);
+        owner_.queue_->push(msg, owner_.read_time_ms_);
+        owner_.reportDrops();
+        owner_.notifyQueued();
     }
 
     void TcpReaderWorker::MessageHandler::onMarkingObjects(const laneproto::MarkingObjects& msg){
         LOG_DEBUG << "MarkingObjects received: seq=" << static_cast<int>(msg.seq)
                   << ", timestamp=" << msg.timestamp_ms
                   << ", objects=" << msg.objects.size();
-        owner_.markingObjectsParsed(msg);
+        owner_.queue_->push(msg, owner_.read_time_ms_);
+        owner_.reportDrops();
+        owner_.notifyQueued();
     }
 
     void TcpReaderWorker::MessageHandler::onParseError(const laneproto::ParseError& error){
@@ -2,14 +2,20 @@
 
 #include <QObject>
 #include <QTcpSocket>
+#include <memory>
 #include "proto_parser.h"
+#include "MessageQueue.h"
 
 namespace network {
+    // QTcpSocket reader on its own QThread. ConnectionManager uses it when
+    // the ingest backend is "qt" or IngestEngine cannot start.
     class TcpReaderWorker : public QObject 
     {
         Q_OBJECT
     public:
-        explicit TcpReaderWorker(QObject* parent = nullptr);
+        // Parsed messages are pushed into `queue`; messagesAvailable() is
+        // emitted once per batch, when the consumer has drained the last one.
+        explicit TcpReaderWorker(std::shared_ptr<ParsedMessageQueue> queue, QObject* parent = nullptr);
         ~TcpReaderWorker() override;
     
     public slots: 
@@ -20,8 +26,7 @@ namespace network {
         void connected();
         void disconnected();
         void errorOccurred(const QString& message);  
-        void laneSummaryParsed (const laneproto::LaneSummary& msg);
-        void markingObjectsParsed(const laneproto::MarkingObjects& msg);
+        void messagesAvailable();
         void parseErrorOccurred(const laneproto::ParseError& error);
     
     private slots: 
@@ -34,6 +39,13 @@ namespace network {
         QString host_;
         quint16 port_{0};
         QTcpSocket* socket_{nullptr};
+        std::shared_ptr<ParsedMessageQueue> queue_;
+        std::uint64_t read_time_ms_{0};     // hostClockMs() of the read being parsed
+        std::uint64_t reported_drops_{0};   // queue drops already logged
+        std::uint64_t drop_report_ms_{0};   // when they were
+
+        void notifyQueued();
+        void reportDrops();
 
         // для переброса из парсера в воркер
         class MessageHandler : public laneproto::IMessageHandler{
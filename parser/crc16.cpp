@@ -0,0 +1,294 @@
+#include "crc16.h"
+#include "LoggerMacros.hpp"
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define LANEPROTO_CRC16_HAVE_CLMUL 1
+#include <immintrin.h>
+#else
+#define LANEPROTO_CRC16_HAVE_CLMUL 0
+#endif
+
+namespace {
+
+    using laneproto::Crc16Engine;
+
+    using Crc16Fn = std::uint16_t (*)(std::uint16_t, const std::uint8_t*, std::size_t) noexcept;
+
+    constexpr std::uint16_t kPolyReflected = 0xA001;    // x^16 + x^15 + x^2 + 1, bit-reversed
+    constexpr std::uint32_t kPolyNormal    = 0x18005;
+
+    struct Crc16Tables {
+        // t[k][i] - CRC of byte i followed by k zero bytes (zero init)
+        std::uint16_t t[8][256];
+    };
+
+    constexpr Crc16Tables makeTables() {
+        Crc16Tables tables{};
+        for (unsigned i = 0; i < 256; ++i) {
+            std::uint16_t crc = static_cast<std::uint16_t>(i);
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc & 0x0001) ? static_cast<std::uint16_t>((crc >> 1) ^ kPolyReflected)
+                                     : static_cast<std::uint16_t>(crc >> 1);
+            }
+            tables.t[0][i] = crc;
+        }
+        for (int k = 1; k < 8; ++k) {
+            for (unsigned i = 0; i < 256; ++i) {
+                const std::uint16_t prev = tables.t[k - 1][i];
+                tables.t[k][i] = static_cast<std::uint16_t>((prev >> 8) ^ tables.t[0][prev & 0xFF]);
+            }
+        }
+        return tables;
+    }
+
+    constexpr Crc16Tables kTables = makeTables();
+
+    std::uint16_t crc16_bitwise(std::uint16_t crc, const std::uint8_t* data, std::size_t len) noexcept {
+        for (std::size_t i = 0; i < len; ++i){
+            crc ^= data[i];
+            for (int bit = 0; bit < 8; ++bit){
+                if (crc & 0x0001) crc = (crc >> 1) ^ kPolyReflected;
+                else crc >>=1;
+            }
+        }
+        return crc;
+    }
+
+    std::uint16_t crc16_table(std::uint16_t crc, const std::uint8_t* data, std::size_t len) noexcept {
+        for (std::size_t i = 0; i < len; ++i) {
+            crc = static_cast<std::uint16_t>((crc >> 8) ^ kTables.t[0][(crc ^ data[i]) & 0xFF]);
+        }
+        return crc;
+    }
+
+    std::uint16_t crc16_slicing8(std::uint16_t crc, const std::uint8_t* data, std::size_t len) noexcept {
+        const auto& t = kTables.t;
+        while (len >= 8) {
+            crc = static_cast<std::uint16_t>(
+                  t[7][(data[0] ^ crc) & 0xFF]
+                ^ t[6][(data[1] ^ (crc >> 8)) & 0xFF]
+                ^ t[5][data[2]] ^ t[4][data[3]]
+                ^ t[3][data[4]] ^ t[2][data[5]]
+                ^ t[1][data[6]] ^ t[0][data[7]]);
+            data += 8;
+            len -= 8;
+        }
+        return crc16_table(crc, data, len);
+    }
+
+#if LANEPROTO_CRC16_HAVE_CLMUL
+    // x^n mod P in normal (non-reflected) bit order
+    constexpr std::uint32_t xpowMod(unsigned n) {
+        std::uint32_t r = 1;
+        for (unsigned i = 0; i < n; ++i) {
+            r <<= 1;
+            if (r & 0x10000) r ^= kPolyNormal;
+        }
+        return r;
+    }
+
+    // Places a degree < 16 polynomial into a 64-bit reflected operand
+    // (coefficient of x^d goes to bit 63 - d).
+    constexpr std::uint64_t reflect64(std::uint32_t poly) {
+        std::uint64_t r = 0;
+        for (unsigned d = 0; d < 16; ++d) {
+            if (poly & (1u << d)) r |= std::uint64_t{1} << (63 - d);
+        }
+        return r;
+    }
+
+    // Folding a 128-bit block forward by 128 bits: the low qword holds the
+    // high-degree half (x^64..x^127) and the high qword the low-degree half.
+    // A reflected carry-less product carries an extra factor x, hence the -1.
+    constexpr std::uint64_t kFoldLo = reflect64(xpowMod(128 + 64 - 1));
+    constexpr std::uint64_t kFoldHi = reflect64(xpowMod(128 - 1));
+
+    constexpr std::size_t kClmulMinLength = 32;
+
+    __attribute__((target("pclmul,sse2")))
+    std::uint16_t crc16_clmul(std::uint16_t crc, const std::uint8_t* data, std::size_t len) noexcept {
+        if (len < kClmulMinLength) {
+            return crc16_slicing8(crc, data, len);
+        }
+
+        // Initial CRC value is equivalent to xoring it into the first two bytes.
+        __m128i acc = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+        acc = _mm_xor_si128(acc, _mm_cvtsi32_si128(crc));
+        data += 16;
+        len -= 16;
+
+        const __m128i k = _mm_set_epi64x(static_cast<long long>(kFoldHi),
+                                         static_cast<long long>(kFoldLo));
+        while (len >= 16) {
+            const __m128i lo = _mm_clmulepi64_si128(acc, k, 0x00);
+            const __m128i hi = _mm_clmulepi64_si128(acc, k, 0x11);
+            const __m128i next = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+            acc = _mm_xor_si128(_mm_xor_si128(lo, hi), next);
+            data += 16;
+            len -= 16;
+        }
+
+        // The accumulator is congruent to the folded prefix, so its CRC with a
+        // zero init is the CRC of everything consumed so far.
+        alignas(16) std::uint8_t folded[16];
+        _mm_store_si128(reinterpret_cast<__m128i*>(folded), acc);
+        crc = crc16_slicing8(0, folded, sizeof(folded));
+        return crc16_slicing8(crc, data, len);
+    }
+#endif
+
+    Crc16Fn engineFunction(Crc16Engine engine) noexcept {
+        switch (engine) {
+            case Crc16Engine::Bitwise:
+                return &crc16_bitwise;
+            case Crc16Engine::Table:
+                return &crc16_table;
+            case Crc16Engine::Slicing8:
+                return &crc16_slicing8;
+            case Crc16Engine::Clmul:
+#if LANEPROTO_CRC16_HAVE_CLMUL
+                if (laneproto::isCrc16EngineSupported(Crc16Engine::Clmul))
+                    return &crc16_clmul;
+#endif
+                break;
+        }
+        return &crc16_table;
+    }
+
+    bool selfTestEngine(Crc16Engine engine) {
+        const Crc16Fn fn = engineFunction(engine);
+
+        static const std::uint8_t kCheckInput[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+        constexpr std::uint16_t kCheckValue = 0x4B37;
+        if (fn(laneproto::kCrc16Init, kCheckInput, sizeof(kCheckInput)) != kCheckValue) {
+            return false;
+        }
+
+        // Largest frame body (header + max payload) plus room for misalignment.
+        constexpr std::size_t kMaxLen = 9 + 1024;
+        std::vector<std::uint8_t> buf(kMaxLen + 8);
+        std::uint32_t seed = 0x12345678u;
+        for (auto& b : buf) {
+            seed = seed * 1664525u + 1013904223u;
+            b = static_cast<std::uint8_t>(seed >> 24);
+        }
+
+        for (std::size_t offset = 0; offset < 8; ++offset) {
+            for (std::size_t len = 0; len <= kMaxLen; len += (len < 96 ? 1 : 37)) {
+                const std::uint8_t* p = buf.data() + offset;
+                const std::uint16_t init = static_cast<std::uint16_t>(len * 0x9E37u);
+                if (fn(init, p, len) != crc16_bitwise(init, p, len)) {
+                    return false;
+                }
+            }
+            const std::uint8_t* p = buf.data() + offset;
+            if (fn(laneproto::kCrc16Init, p, kMaxLen)
+                != crc16_bitwise(laneproto::kCrc16Init, p, kMaxLen)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    struct ActiveEngine {
+        std::atomic<Crc16Engine> engine{Crc16Engine::Table};
+        std::atomic<Crc16Fn> fn{&crc16_table};
+
+        ActiveEngine() {
+            for (Crc16Engine candidate : {Crc16Engine::Clmul, Crc16Engine::Slicing8}) {
+                if (!laneproto::isCrc16EngineSupported(candidate))
+                    continue;
+                if (!selfTestEngine(candidate)) {
+                    LOG_WARN << "CRC16 engine " << laneproto::crc16EngineName(candidate)
+                             << " failed self-test, skipping";
+                    continue;
+                }
+                engine.store(candidate);
+                fn.store(engineFunction(candidate));
+                break;
+            }
+            LOG_INFO << "CRC16 engine selected: " << laneproto::crc16EngineName(engine.load());
+        }
+    };
+
+    ActiveEngine& activeEngine() noexcept {
+        static ActiveEngine active;
+        return active;
+    }
+}
+
+namespace laneproto {
+
+    const char* crc16EngineName(Crc16Engine engine) noexcept {
+        switch (engine) {
+            case Crc16Engine::Bitwise:
+                return "Bitwise";
+            case Crc16Engine::Table:
+                return "Table";
+            case Crc16Engine::Slicing8:
+                return "Slicing8";
+            case Crc16Engine::Clmul:
+                return "Clmul";
+        }
+        return "Unknown";
+    }
+
+    bool isCrc16EngineSupported(Crc16Engine engine) noexcept {
+        switch (engine) {
+            case Crc16Engine::Bitwise:
+            case Crc16Engine::Table:
+            case Crc16Engine::Slicing8:
+                return true;
+            case Crc16Engine::Clmul:
+#if LANEPROTO_CRC16_HAVE_CLMUL
+                return __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("sse2");
+#else
+                return false;
+#endif
+        }
+        return false;
+    }
+
+    Crc16Engine crc16Engine() noexcept {
+        return activeEngine().engine.load(std::memory_order_relaxed);
+    }
+
+    bool setCrc16Engine(Crc16Engine engine) noexcept {
+        if (!isCrc16EngineSupported(engine)) {
+            LOG_WARN << "CRC16 engine " << crc16EngineName(engine) << " is not supported on this CPU";
+            return false;
+        }
+        auto& active = activeEngine();
+        active.engine.store(engine);
+        active.fn.store(engineFunction(engine));
+        LOG_INFO << "CRC16 engine set to " << crc16EngineName(engine);
+        return true;
+    }
+
+    std::uint16_t crc16_ibm_update(std::uint16_t crc, const std::uint8_t* data, std::size_t len) noexcept {
+        return activeEngine().fn.load(std::memory_order_relaxed)(crc, data, len);
+    }
+
+    std::uint16_t crc16_ibm_update(Crc16Engine engine, std::uint16_t crc,
+                                   const std::uint8_t* data, std::size_t len) noexcept {
+        return engineFunction(engine)(crc, data, len);
+    }
+
+    bool crc16SelfTest() noexcept {
+        bool ok = true;
+        for (Crc16Engine engine : {Crc16Engine::Table, Crc16Engine::Slicing8, Crc16Engine::Clmul}) {
+            if (!isCrc16EngineSupported(engine))
+                continue;
+            if (!selfTestEngine(engine)) {
+                LOG_ERROR << "CRC16 self-test failed for engine " << crc16EngineName(engine);
+                ok = false;
+            }
+        }
+        return ok;
+    }
+
+} // namespace laneproto
@@ -0,0 +1,40 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+namespace laneproto {
+
+    // CRC-16/IBM (reflected poly 0xA001, init 0xFFFF, no final xor) used to
+    // protect every frame. Several interchangeable kernels are provided; the
+    // fastest one supported by the CPU is picked on first use.
+    constexpr std::uint16_t kCrc16Init = 0xFFFF;
+
+    enum class Crc16Engine : std::uint8_t {
+        Bitwise,    // reference implementation, one bit per iteration
+        Table,      // 256-entry lookup table, one byte per iteration
+        Slicing8,   // 8 x 256 tables, eight bytes per iteration
+        Clmul,      // PCLMULQDQ 128-bit folding (x86 only)
+    };
+
+    const char* crc16EngineName(Crc16Engine engine) noexcept;
+    bool isCrc16EngineSupported(Crc16Engine engine) noexcept;
+
+    Crc16Engine crc16Engine() noexcept;
+    // Returns false (and keeps the current engine) if the engine is not supported.
+    bool setCrc16Engine(Crc16Engine engine) noexcept;
+
+    // Folds `len` bytes into a running CRC using the active engine.
+    std::uint16_t crc16_ibm_update(std::uint16_t crc, const std::uint8_t* data, std::size_t len) noexcept;
+    // Same, but with an explicitly chosen engine (falls back to Table if unsupported).
+    std::uint16_t crc16_ibm_update(Crc16Engine engine, std::uint16_t crc,
+                                   const std::uint8_t* data, std::size_t len) noexcept;
+
+    inline std::uint16_t crc16_ibm(const std::uint8_t* data, std::size_t len) noexcept {
+        return crc16_ibm_update(kCrc16Init, data, len);
+    }
+
+    // Cross-checks every supported engine against the bitwise reference on
+    // the standard check vector and on buffers of varying length/alignment.
+    bool crc16SelfTest() noexcept;
+
+} // namespace laneproto
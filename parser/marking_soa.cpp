@@ -0,0 +1,150 @@
+#include "marking_soa.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define LANEPROTO_MARKING_HAVE_AVX2 1
+#include <immintrin.h>
+#else
+#define LANEPROTO_MARKING_HAVE_AVX2 0
+#endif
+
+namespace {
+
+    using laneproto::kMarkingObjectRecordSize;
+    using laneproto::MarkingObjectsSoA;
+
+    // Field offsets inside a 13-byte record
+    constexpr std::size_t kClassOffset      = 0;
+    constexpr std::size_t kXOffset          = 1;
+    constexpr std::size_t kYOffset          = 3;
+    constexpr std::size_t kLengthOffset     = 5;
+    constexpr std::size_t kWidthOffset      = 7;
+    constexpr std::size_t kYawOffset        = 9;
+    constexpr std::size_t kConfidenceOffset = 11;
+    constexpr std::size_t kFlagsOffset      = 12;
+
+    void decodeScalar(const std::uint8_t* records, std::size_t first, std::size_t count,
+                      MarkingObjectsSoA& out) noexcept {
+        using laneproto::detail::read_le_s16_decim;
+        using laneproto::detail::read_le_u16_decim;
+
+        for (std::size_t i = first; i < count; ++i) {
+            const std::uint8_t* p = records + i * kMarkingObjectRecordSize;
+            out.x_m[i]      = read_le_s16_decim(p + kXOffset);
+            out.y_m[i]      = read_le_s16_decim(p + kYOffset);
+            out.length_m[i] = read_le_u16_decim(p + kLengthOffset);
+            out.width_m[i]  = read_le_u16_decim(p + kWidthOffset);
+            out.yaw_deg[i]  = read_le_s16_decim(p + kYawOffset);
+        }
+    }
+
+    void decodeBytes(const std::uint8_t* records, std::size_t count, MarkingObjectsSoA& out) noexcept {
+        for (std::size_t i = 0; i < count; ++i) {
+            const std::uint8_t* p = records + i * kMarkingObjectRecordSize;
+            out.class_id[i]   = static_cast<laneproto::MarkingClassId>(p[kClassOffset]);
+            out.confidence[i] = p[kConfidenceOffset];
+            out.flags[i]      = p[kFlagsOffset];
+        }
+    }
+
+#if LANEPROTO_MARKING_HAVE_AVX2
+    // Each gather lane reads 4 bytes starting at the 16-bit field, i.e. at
+    // most record offset 9 + 3 = 12, so a full group of 8 records never
+    // reads past its own 104 bytes.
+    __attribute__((target("avx2")))
+    inline __m256 gatherDecimSigned(const std::uint8_t* base, __m256i index, __m256 scale) noexcept {
+        __m256i v = _mm256_i32gather_epi32(reinterpret_cast<const int*>(base), index, 1);
+        v = _mm256_srai_epi32(_mm256_slli_epi32(v, 16), 16);
+        return _mm256_mul_ps(_mm256_cvtepi32_ps(v), scale);
+    }
+
+    __attribute__((target("avx2")))
+    inline __m256 gatherDecimUnsigned(const std::uint8_t* base, __m256i index, __m256 scale) noexcept {
+        __m256i v = _mm256_i32gather_epi32(reinterpret_cast<const int*>(base), index, 1);
+        v = _mm256_and_si256(v, _mm256_set1_epi32(0xFFFF));
+        return _mm256_mul_ps(_mm256_cvtepi32_ps(v), scale);
+    }
+
+    __attribute__((target("avx2")))
+    std::size_t decodeAvx2(const std::uint8_t* records, std::size_t count,
+                           MarkingObjectsSoA& out) noexcept {
+        constexpr int kStride = static_cast<int>(kMarkingObjectRecordSize);
+        const __m256i record_index = _mm256_setr_epi32(0, kStride, 2 * kStride, 3 * kStride,
+                                                       4 * kStride, 5 * kStride, 6 * kStride, 7 * kStride);
+        const __m256 scale = _mm256_set1_ps(laneproto::detail::kDecimToUnit);
+
+        std::size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            const std::uint8_t* group = records + i * kMarkingObjectRecordSize;
+            _mm256_store_ps(out.x_m + i, gatherDecimSigned(group + kXOffset, record_index, scale));
+            _mm256_store_ps(out.y_m + i, gatherDecimSigned(group + kYOffset, record_index, scale));
+            _mm256_store_ps(out.length_m + i, gatherDecimUnsigned(group + kLengthOffset, record_index, scale));
+            _mm256_store_ps(out.width_m + i, gatherDecimUnsigned(group + kWidthOffset, record_index, scale));
+            _mm256_store_ps(out.yaw_deg + i, gatherDecimSigned(group + kYawOffset, record_index, scale));
+        }
+        return i;
+    }
+#endif
+
+    laneproto::MarkingDecodeKernel detectKernel() noexcept {
+        if (laneproto::isMarkingDecodeKernelSupported(laneproto::MarkingDecodeKernel::Avx2))
+            return laneproto::MarkingDecodeKernel::Avx2;
+        return laneproto::MarkingDecodeKernel::Scalar;
+    }
+}
+
+namespace laneproto {
+
+    const char* markingDecodeKernelName(MarkingDecodeKernel kernel) noexcept {
+        switch (kernel) {
+            case MarkingDecodeKernel::Scalar:
+                return "Scalar";
+            case MarkingDecodeKernel::Avx2:
+                return "Avx2";
+        }
+        return "Unknown";
+    }
+
+    bool isMarkingDecodeKernelSupported(MarkingDecodeKernel kernel) noexcept {
+        switch (kernel) {
+            case MarkingDecodeKernel::Scalar:
+                return true;
+            case MarkingDecodeKernel::Avx2:
+#if LANEPROTO_MARKING_HAVE_AVX2
+                return __builtin_cpu_supports("avx2");
+#else
+                return false;
+#endif
+        }
+        return false;
+    }
+
+    void decodeMarkingObjects(const MarkingObjectsView& view, MarkingObjectsSoA& out) noexcept {
+        static const MarkingDecodeKernel kernel = detectKernel();
+        decodeMarkingObjects(kernel, view, out);
+    }
+
+    void decodeMarkingObjects(MarkingDecodeKernel kernel, const MarkingObjectsView& view,
+                              MarkingObjectsSoA& out) noexcept {
+        const std::size_t count = std::min(view.size(), MarkingObjectsSoA::kCapacity);
+        const std::uint8_t* records = view.data();
+
+        out.timestamp_ms = view.timestampMs();
+        out.seq = view.seq();
+        out.size = count;
+
+        std::size_t done = 0;
+#if LANEPROTO_MARKING_HAVE_AVX2
+        if (kernel == MarkingDecodeKernel::Avx2 && isMarkingDecodeKernelSupported(kernel)) {
+            done = decodeAvx2(records, count, out);
+        }
+#else
+        (void)kernel;
+#endif
+        decodeScalar(records, done, count, out);
+        decodeBytes(records, count, out);
+    }
+
+} // namespace laneproto
@@ -0,0 +1,43 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include "proto_parser.h"
+
+namespace laneproto {
+
+    // Structure-of-arrays form of a MarkingObjects payload. Storage is fixed
+    // by the protocol limit (1024-byte payload -> at most 78 records), padded
+    // to a whole number of 8-lane vectors, so decoding never allocates.
+    struct MarkingObjectsSoA {
+        static constexpr std::size_t kCapacity = (kMaxPayloadLength - 1) / kMarkingObjectRecordSize;
+        static constexpr std::size_t kPaddedCapacity = (kCapacity + 7) & ~std::size_t{7};
+
+        TimestampMs timestamp_ms{};
+        SequenceNumber seq{};
+        std::size_t size = 0;
+
+        alignas(32) float x_m[kPaddedCapacity]{};
+        alignas(32) float y_m[kPaddedCapacity]{};
+        alignas(32) float length_m[kPaddedCapacity]{};
+        alignas(32) float width_m[kPaddedCapacity]{};
+        alignas(32) float yaw_deg[kPaddedCapacity]{};
+        alignas(32) MarkingClassId class_id[kPaddedCapacity]{};
+        alignas(32) std::uint8_t confidence[kPaddedCapacity]{};
+        alignas(32) std::uint8_t flags[kPaddedCapacity]{};
+    };
+
+    enum class MarkingDecodeKernel : std::uint8_t {
+        Scalar,
+        Avx2,       // 32-bit gathers + int->float conversion, 8 records per step
+    };
+
+    const char* markingDecodeKernelName(MarkingDecodeKernel kernel) noexcept;
+    bool isMarkingDecodeKernelSupported(MarkingDecodeKernel kernel) noexcept;
+
+    // Decodes every record of `view` into `out` with the best supported kernel.
+    // All kernels produce bit-identical output.
+    void decodeMarkingObjects(const MarkingObjectsView& view, MarkingObjectsSoA& out) noexcept;
+    void decodeMarkingObjects(MarkingDecodeKernel kernel, const MarkingObjectsView& view,
+                              MarkingObjectsSoA& out) noexcept;
+
+} // namespace laneproto
@@ -1,43 +1,79 @@
 #include "proto_parser.h"
+#include "crc16.h"
 #include "logger/Logger.hpp"
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <string>
 #include <vector>
 
 
 namespace {
 
-    inline std::uint16_t read_le_u16(const std::uint8_t* p){
-        return static_cast<std::uint16_t>(p[0]) 
-            | (static_cast<std::uint16_t>(p[1]) << 8);
-    }
+    using laneproto::detail::read_le_u16;
+    using laneproto::detail::read_le_u32;
+
+}
+
+namespace laneproto {
 
-    inline std::uint32_t read_le_u32(const std::uint8_t* p){
-        return static_cast<std::uint32_t>(p[0])
-            | (static_cast<std::uint32_t>(p[1]) << 8)
-            | (static_cast<std::uint32_t>(p[2]) << 16)
-            | (static_cast<std::uint32_t>(p[3]) << 24); 
+    LaneSummary LaneSummaryView::decode() const noexcept {
+        LaneSummary msg;
+        msg.timestamp_ms      = timestamp_ms_;
+        msg.seq               = seq_;
+        msg.left_offset_m     = leftOffsetMeters();
+        msg.right_offset_m    = rightOffsetMeters();
+        msg.lane_type_left    = laneTypeLeft();
+        msg.lane_type_right   = laneTypeRight();
+        msg.allowed_maneuvers = allowedManeuvers();
+        msg.quality           = quality();
+        return msg;
     }
 
-    inline std::uint16_t crc16_ibm (const std::uint8_t* data, std::size_t len){
-        std::uint16_t crc = 0xFFFF;
+    MarkingObject MarkingObjectView::decode() const noexcept {
+        MarkingObject obj;
+        obj.class_id   = classId();
+        obj.x_m        = xMeters();
+        obj.y_m        = yMeters();
+        obj.length_m   = lengthMeters();
+        obj.width_m    = widthMeters();
+        obj.yaw_deg    = yawDeg();
+        obj.confidence = confidence();
+        obj.flags      = flags();
+        return obj;
+    }
 
-        for (std::size_t i = 0; i < len; ++i){
-            crc ^= data[i];
-            for (int bit = 0; bit < 8; ++bit){
-                if (crc & 0x0001) crc = (crc >> 1) ^ 0xA001;
-                else crc >>=1;
-            }
+    void MarkingObjectsView::decodeInto(MarkingObjects& out) const {
+        out.timestamp_ms = timestamp_ms_;
+        out.seq = seq_;
+        out.objects.clear();
+        out.objects.reserve(count_);
+        for (const MarkingObjectView obj : *this) {
+            out.objects.push_back(obj.decode());
         }
-        return crc;
     }
-}
 
-namespace laneproto {
+    MarkingObjects MarkingObjectsView::decode() const {
+        MarkingObjects msg;
+        decodeInto(msg);
+        return msg;
+    }
 
     ProtoParser::ProtoParser(IMessageHandler& handler) noexcept
-        : handler_(handler) {
+        : handler_(&handler) {
+    }
+
+    ProtoParser::ProtoParser(IMessageViewHandler& handler) noexcept
+        : view_handler_(&handler) {
+    }
+
+    void ProtoParser::reportError(const ParseError& error) {
+        if (view_handler_) {
+            view_handler_->onParseError(error);
+        } else {
+            handler_->onParseError(error);
+        }
     }
 
     void ProtoParser::reset() noexcept {
@@ -46,6 +82,7 @@ namespace laneproto {
         crc_pos_ = 0;
         payload_pos_ = 0; 
         payload_buf_.clear(); 
+        running_crc_ = kCrc16Init;
         current_header_ = FrameHeader{};
     }
 
@@ -57,7 +94,7 @@ namespace laneproto {
             ParseError err;
             err.code = ParseErrorCode::BadVersion;
             err.message = "Unsupported protocol version: " + std::to_string(h.ver);
-            handler_.onParseError(err);
+            reportError(err);
             return false;
         }
 
@@ -68,7 +105,7 @@ namespace laneproto {
             err.code = ParseErrorCode::UnknownMsgType;
             err.message = "Unknown MSG_TYPE: " + std::to_string(
                 static_cast<std::uint8_t>(h.msg_type));
-            handler_.onParseError(err);
+            reportError(err);
             return false;
         }
 
@@ -79,7 +116,7 @@ namespace laneproto {
             ParseError err;
             err.code = ParseErrorCode::PayloadTooLong;
             err.message = "Payload too long: " + std::to_string(h.payload_len);
-            handler_.onParseError(err);
+            reportError(err);
             return false; 
         }
 
@@ -91,19 +128,11 @@ namespace laneproto {
     bool ProtoParser::verifyCrc(){
         std::uint16_t received_crc = read_le_u16(crc_buf_);
 
-        std::vector<std::uint8_t> tmp;
-        tmp.reserve(kHeaderSize + current_header_.payload_len);
-
-        tmp.insert(tmp.end(), header_buf_, header_buf_ + kHeaderSize);
-        tmp.insert(tmp.end(), payload_buf_.begin(), payload_buf_.end());
-
-        std::uint16_t calc_crc = crc16_ibm(tmp.data(), tmp.size());
-
-        if (calc_crc != received_crc){
+        if (running_crc_ != received_crc){
             ParseError err;
             err.code = ParseErrorCode::CrcMismatch;
             err.message = "CRC mismatch";
-            handler_.onParseError(err);
+            reportError(err);
             return false;
         }
 
@@ -115,72 +144,39 @@ namespace laneproto {
             ParseError err;
             err.code = ParseErrorCode::MarkingFormat;
             err.message = "Payload size mismatch for MarkingObjects";
-            handler_.onParseError(err);
+            reportError(err);
             return;
         }
         if (payload_buf_.empty()) {
             ParseError err;
             err.code = ParseErrorCode::MarkingFormat;
             err.message = "Empty payload for MarkingObjects";
-            handler_.onParseError(err);
+            reportError(err);
             return;
         }
 
         std::uint8_t num_objects = payload_buf_[0];
 
-        std::size_t expected_len = 1u + static_cast<std::size_t>(num_objects) * 13u;
+        std::size_t expected_len = 1u + static_cast<std::size_t>(num_objects) * kMarkingObjectRecordSize;
         if (current_header_.payload_len != expected_len){
             ParseError err;
             err.code = ParseErrorCode::MarkingFormat;
             err.message = "MarkingObjects LEN mismatch: expected "
                 + std::to_string(expected_len) + ", got "
                 + std::to_string(current_header_.payload_len);
-            handler_.onParseError(err);
+            reportError(err);
             return;
         }
 
-        MarkingObjects msg;
-        msg.timestamp_ms = current_header_.timestamp_ms;
-        msg.seq = current_header_.seq;
-        msg.objects.clear();
-        msg.objects.reserve(num_objects);
-
-        const std::size_t object_size = 13;
-        std::size_t offset = 1;
-
-        for (std::uint8_t i = 0; i < num_objects; ++i){
-            if (offset + object_size > payload_buf_.size()){
-                ParseError err;
-                err.code = ParseErrorCode::MarkingFormat;
-                err.message = "Truncated MarkingObject in payload";
-                handler_.onParseError(err);
-                return;
-            }
-
-            const std::uint8_t* p = payload_buf_.data() + offset;
-            MarkingObject obj;
-            obj.class_id = static_cast<MarkingClassId>(p[0]);
-
-            std::int16_t x_decim = static_cast<std::int16_t>(read_le_u16(p + 1));
-            std::int16_t y_decim = static_cast<std::int16_t>(read_le_u16(p + 3));
-            std::uint16_t length_decim = read_le_u16(p + 5);
-            std::uint16_t width_decim = read_le_u16(p + 7);
-            std::int16_t yaw_decideg = static_cast<std::int16_t>(read_le_u16(p + 9));
-
-            obj.x_m = static_cast<float>(x_decim) / 10.0f;
-            obj.y_m = static_cast<float>(y_decim) / 10.0f;
-            obj.length_m = static_cast<float>(length_decim) / 10.0f;
-            obj.width_m = static_cast<float>(width_decim) / 10.0f;
-            obj.yaw_deg = static_cast<float>(yaw_decideg) / 10.0f;
-
-            obj.confidence = p[11];
-            obj.flags = p[12];
-
-            msg.objects.push_back(obj);
-
-            offset += object_size;
+        MarkingObjectsView view(current_header_.timestamp_ms, current_header_.seq,
+                                payload_buf_.data() + 1, num_objects);
+        if (view_handler_) {
+            view_handler_->onMarkingObjects(view);
+            return;
         }
-        handler_.onMarkingObjects(msg);
+
+        view.decodeInto(marking_msg_);
+        handler_->onMarkingObjects(marking_msg_);
     }
 
     void ProtoParser::handleLaneSummary (){
@@ -188,43 +184,27 @@ namespace laneproto {
             ParseError err;
             err.code = ParseErrorCode::LaneSummaryFormat;
             err.message = "Payload size mismatch for LaneSummary";
-            handler_.onParseError(err);
+            reportError(err);
             return;
         }
 
-        if (current_header_.payload_len != 8u) {
+        if (current_header_.payload_len != kLaneSummaryPayloadSize) {
             ParseError err;
             err.code = ParseErrorCode::LaneSummaryFormat;
             err.message = "LaneSummary LEN must be 8, got "
                 + std::to_string(current_header_.payload_len);
-            handler_.onParseError(err);
+            reportError(err);
             return;
         }
 
-        const std::uint8_t* p = payload_buf_.data();
-
-        std::int16_t left_decim = static_cast<std::int16_t>(read_le_u16(p + 0));
-        std::int16_t right_decim = static_cast<std::int16_t>(read_le_u16(p + 2));
-        float left_m = static_cast<float>(left_decim) / 10.0f;
-        float right_m = static_cast<float>(right_decim) / 10.0f;
-
-        LaneType lane_left = static_cast<LaneType>(p[4]);
-        LaneType lane_right = static_cast<LaneType>(p[5]);
-
-        std::uint8_t allowed_maneuvers = p[6];      
-        std::uint8_t quality = p[7];
+        LaneSummaryView view(current_header_.timestamp_ms, current_header_.seq,
+                             payload_buf_.data());
+        if (view_handler_) {
+            view_handler_->onLaneSummary(view);
+            return;
+        }
 
-        LaneSummary msg;
-        msg.timestamp_ms    = current_header_.timestamp_ms;
-        msg.seq             = current_header_.seq;
-        msg.left_offset_m   = left_m;
-        msg.right_offset_m  = right_m;
-        msg.lane_type_left  = lane_left;
-        msg.lane_type_right = lane_right;
-        msg.allowed_maneuvers = allowed_maneuvers;
-        msg.quality           = quality;
-
-        handler_.onLaneSummary(msg);
+        handler_->onLaneSummary(view.decode());
     }
 
     void ProtoParser::feed(const std::vector<std::uint8_t>& data) {
@@ -232,40 +212,66 @@ namespace laneproto {
     }
 
     void ProtoParser::feed(const std::uint8_t* data, std::size_t size) {
-        for (std::size_t i = 0; i < size; ++i) {
-            std::uint8_t byte = data[i];
+        const std::uint8_t* p = data;
+        const std::uint8_t* const end = data + size;
+
+        // Each state consumes as many bytes as it can in one step: memchr for
+        // the sync byte, memcpy for fixed-length header/payload/CRC fields.
+        while (p < end) {
+            const std::size_t available = static_cast<std::size_t>(end - p);
 
             switch (state_) {
-                case State::WaitingSync:
-                    if (byte == kSyncByte){
-                        header_pos_ = 0;
-                        state_ = State::ReadingHeader;
+                case State::WaitingSync: {
+                    const void* sync = std::memchr(p, kSyncByte, available);
+                    if (sync == nullptr) {
+                        p = end;
+                        break;
                     }
+                    p = static_cast<const std::uint8_t*>(sync) + 1;
+                    header_pos_ = 0;
+                    state_ = State::ReadingHeader;
                     break;
-                case State::ReadingHeader:
-                    header_buf_[header_pos_++] = byte;
+                }
+                case State::ReadingHeader: {
+                    const std::size_t n = std::min(kHeaderSize - header_pos_, available);
+                    std::memcpy(header_buf_ + header_pos_, p, n);
+                    header_pos_ += n;
+                    p += n;
                     if (header_pos_ == kHeaderSize){
                         header_pos_ = 0;
                         if (!parseHeaderFromBuffer()){
                             reset();
                             break;
                         }
-                        payload_buf_.assign(current_header_.payload_len, 0);
+                        running_crc_ = crc16_ibm_update(kCrc16Init, header_buf_, kHeaderSize);
+                        payload_buf_.resize(current_header_.payload_len);
                         payload_pos_ = 0;
+                        crc_pos_ = 0;
 
-                        state_ = State::ReadingPayload;
+                        state_ = current_header_.payload_len == 0 ? State::ReadingCrc
+                                                                  : State::ReadingPayload;
                     }
                     break;
-                case State::ReadingPayload:
-                    payload_buf_[payload_pos_++] = byte;
+                }
+                case State::ReadingPayload: {
+                    const std::size_t n = std::min(
+                        static_cast<std::size_t>(current_header_.payload_len) - payload_pos_, available);
+                    std::memcpy(payload_buf_.data() + payload_pos_, p, n);
+                    running_crc_ = crc16_ibm_update(running_crc_, p, n);
+                    payload_pos_ += n;
+                    p += n;
                     if (payload_pos_ == current_header_.payload_len){
                         crc_pos_ = 0;
                         state_ = State::ReadingCrc;
                     }
                     break;
-                case State::ReadingCrc:
-                    crc_buf_[crc_pos_++] = byte;
-                    if (crc_pos_ == 2) {
+                }
+                case State::ReadingCrc: {
+                    const std::size_t n = std::min(sizeof(crc_buf_) - crc_pos_, available);
+                    std::memcpy(crc_buf_ + crc_pos_, p, n);
+                    crc_pos_ += n;
+                    p += n;
+                    if (crc_pos_ == sizeof(crc_buf_)) {
                         crc_pos_ = 0;
                         if (!verifyCrc()){
                             reset();
@@ -283,6 +289,7 @@ namespace laneproto {
                         reset();
                     }
                     break;
+                }
             }
         }
     }
@@ -1,9 +1,11 @@
 #pragma once
 #include <cstdint>
 #include <cstddef>
+#include <iterator>
 #include <vector>
 #include <string>
 #include "../logger/Logger.hpp"
+#include "crc16.h"
 
 namespace laneproto {
     using TimestampMs = std::uint32_t;
@@ -12,6 +14,8 @@ namespace laneproto {
     constexpr std::uint8_t kProtocolVersion = 0x01;
     constexpr std::uint8_t kSyncByte = 0xAA;
     constexpr std::size_t kMaxPayloadLength = 1024;
+    constexpr std::size_t kLaneSummaryPayloadSize = 8;
+    constexpr std::size_t kMarkingObjectRecordSize = 13;
 
     enum class MsgType : std::uint8_t {
         LaneSummary     = 0x01,
@@ -78,6 +82,136 @@ namespace laneproto {
         std::vector<MarkingObject> objects;
     };
 
+    namespace detail {
+        inline std::uint16_t read_le_u16(const std::uint8_t* p) noexcept {
+            return static_cast<std::uint16_t>(p[0])
+                | (static_cast<std::uint16_t>(p[1]) << 8);
+        }
+
+        inline std::uint32_t read_le_u32(const std::uint8_t* p) noexcept {
+            return static_cast<std::uint32_t>(p[0])
+                | (static_cast<std::uint32_t>(p[1]) << 8)
+                | (static_cast<std::uint32_t>(p[2]) << 16)
+                | (static_cast<std::uint32_t>(p[3]) << 24);
+        }
+
+        // Wire values are in 0.1 units. Every decoder (views, AoS, SoA/SIMD)
+        // scales with the same single multiply so results are bit-identical.
+        constexpr float kDecimToUnit = 0.1f;
+
+        inline float read_le_s16_decim(const std::uint8_t* p) noexcept {
+            return static_cast<float>(static_cast<std::int16_t>(read_le_u16(p))) * kDecimToUnit;
+        }
+
+        inline float read_le_u16_decim(const std::uint8_t* p) noexcept {
+            return static_cast<float>(read_le_u16(p)) * kDecimToUnit;
+        }
+    } // namespace detail
+
+    // Views over a validated payload. They do not own any memory and are only
+    // valid for the duration of the IMessageViewHandler callback; fields are
+    // decoded on access.
+    class LaneSummaryView {
+    public:
+        LaneSummaryView(TimestampMs timestamp_ms, SequenceNumber seq,
+                        const std::uint8_t* payload) noexcept
+            : timestamp_ms_(timestamp_ms), seq_(seq), p_(payload) {}
+
+        TimestampMs timestampMs() const noexcept { return timestamp_ms_; }
+        SequenceNumber seq() const noexcept { return seq_; }
+
+        float leftOffsetMeters() const noexcept { return detail::read_le_s16_decim(p_ + 0); }
+        float rightOffsetMeters() const noexcept { return detail::read_le_s16_decim(p_ + 2); }
+        LaneType laneTypeLeft() const noexcept { return static_cast<LaneType>(p_[4]); }
+        LaneType laneTypeRight() const noexcept { return static_cast<LaneType>(p_[5]); }
+        std::uint8_t allowedManeuvers() const noexcept { return p_[6]; }
+        std::uint8_t quality() const noexcept { return p_[7]; }
+
+        const std::uint8_t* data() const noexcept { return p_; }
+        LaneSummary decode() const noexcept;
+
+    private:
+        TimestampMs timestamp_ms_;
+        SequenceNumber seq_;
+        const std::uint8_t* p_;
+    };
+
+    class MarkingObjectView {
+    public:
+        explicit MarkingObjectView(const std::uint8_t* record) noexcept
+            : p_(record) {}
+
+        MarkingClassId classId() const noexcept { return static_cast<MarkingClassId>(p_[0]); }
+        float xMeters() const noexcept { return detail::read_le_s16_decim(p_ + 1); }
+        float yMeters() const noexcept { return detail::read_le_s16_decim(p_ + 3); }
+        float lengthMeters() const noexcept { return detail::read_le_u16_decim(p_ + 5); }
+        float widthMeters() const noexcept { return detail::read_le_u16_decim(p_ + 7); }
+        float yawDeg() const noexcept { return detail::read_le_s16_decim(p_ + 9); }
+        std::uint8_t confidence() const noexcept { return p_[11]; }
+        std::uint8_t flags() const noexcept { return p_[12]; }
+
+        const std::uint8_t* data() const noexcept { return p_; }
+        MarkingObject decode() const noexcept;
+
+    private:
+        const std::uint8_t* p_;
+    };
+
+    class MarkingObjectsView {
+    public:
+        class const_iterator {
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type = MarkingObjectView;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = MarkingObjectView;
+
+            explicit const_iterator(const std::uint8_t* p) noexcept : p_(p) {}
+
+            MarkingObjectView operator*() const noexcept { return MarkingObjectView(p_); }
+            const_iterator& operator++() noexcept { p_ += kMarkingObjectRecordSize; return *this; }
+            const_iterator operator++(int) noexcept { const_iterator tmp = *this; ++*this; return tmp; }
+            bool operator==(const const_iterator& other) const noexcept { return p_ == other.p_; }
+            bool operator!=(const const_iterator& other) const noexcept { return p_ != other.p_; }
+
+        private:
+            const std::uint8_t* p_;
+        };
+
+        // `records` points at the first 13-byte record (past the count byte).
+        MarkingObjectsView(TimestampMs timestamp_ms, SequenceNumber seq,
+                           const std::uint8_t* records, std::size_t count) noexcept
+            : timestamp_ms_(timestamp_ms), seq_(seq), records_(records), count_(count) {}
+
+        TimestampMs timestampMs() const noexcept { return timestamp_ms_; }
+        SequenceNumber seq() const noexcept { return seq_; }
+
+        std::size_t size() const noexcept { return count_; }
+        bool empty() const noexcept { return count_ == 0; }
+
+        MarkingObjectView operator[](std::size_t index) const noexcept {
+            return MarkingObjectView(records_ + index * kMarkingObjectRecordSize);
+        }
+
+        const_iterator begin() const noexcept { return const_iterator(records_); }
+        const_iterator end() const noexcept {
+            return const_iterator(records_ + count_ * kMarkingObjectRecordSize);
+        }
+
+        const std::uint8_t* data() const noexcept { return records_; }
+
+        // Full decode; `out` keeps its capacity so repeated calls do not allocate.
+        void decodeInto(MarkingObjects& out) const;
+        MarkingObjects decode() const;
+
+    private:
+        TimestampMs timestamp_ms_;
+        SequenceNumber seq_;
+        const std::uint8_t* records_;
+        std::size_t count_;
+    };
+
     class IMessageHandler {
     public: 
         virtual ~IMessageHandler() = default;
@@ -87,9 +221,21 @@ namespace laneproto {
         virtual void onParseError(const ParseError& error) = 0;
     };
 
+    // Zero-copy alternative to IMessageHandler for consumers that only need
+    // a few fields (filters, recorders, statistics).
+    class IMessageViewHandler {
+    public:
+        virtual ~IMessageViewHandler() = default;
+
+        virtual void onLaneSummary(const LaneSummaryView& msg) = 0;
+        virtual void onMarkingObjects(const MarkingObjectsView& msg) = 0;
+        virtual void onParseError(const ParseError& error) = 0;
+    };
+
     class ProtoParser {
     public:
         explicit ProtoParser(IMessageHandler& handler) noexcept;
+        explicit ProtoParser(IMessageViewHandler& handler) noexcept;
         ~ProtoParser() = default;
 
         void feed(const std::vector<std::uint8_t>& data);
@@ -117,7 +263,8 @@ namespace laneproto {
             std::uint16_t payload_len = 0;
         };
 
-        IMessageHandler& handler_;
+        IMessageHandler* handler_ = nullptr;
+        IMessageViewHandler* view_handler_ = nullptr;
 
         State state_{State::WaitingSync};
 
@@ -134,6 +281,13 @@ namespace laneproto {
         std::uint8_t crc_buf_[2]{};
         std::size_t  crc_pos_ = 0;
 
+        // CRC over header + payload, folded in as each part completes
+        std::uint16_t running_crc_ = kCrc16Init;
+
+        // reused between frames so the decoding path does not reallocate
+        MarkingObjects marking_msg_;
+
+        void reportError(const ParseError& error);
         bool parseHeaderFromBuffer();
         bool verifyCrc();
         void handleMarkingObjects();
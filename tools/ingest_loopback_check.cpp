@@ -0,0 +1,332 @@
+// Runs IngestEngine with the IngestQueueSink ConnectionManager uses against
+// local listeners: many TCP streams plus one Unix socket stream, all sending
+// the same recorded sequence in odd-sized writes, and checks that every
+// message reaches the queue consumer intact.
+//
+//     ingest_loopback_check [--streams N] [--messages N]
+//
+// Also checks that a refused connection is reported as Disconnected, that a
+// peer closing its end is reported as a disconnect, and that the engine
+// reconnects every stream after stop() and start(). Exits non-zero on any
+// failure.
+
+#include "IngestEngine.h"
+#include "IngestQueueSink.h"
+#include "crc16.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    constexpr std::size_t kObjectsPerMessage = 12;
+    constexpr std::size_t kWriteChunk = 777;    // splits frames across reads
+    constexpr auto kTimeout = std::chrono::seconds(10);
+
+    void putLe16(std::vector<std::uint8_t>& out, std::uint16_t value) {
+        out.push_back(static_cast<std::uint8_t>(value & 0xff));
+        out.push_back(static_cast<std::uint8_t>(value >> 8));
+    }
+
+    void appendFrame(std::vector<std::uint8_t>& out, laneproto::MsgType type, std::uint8_t seq,
+                     std::uint32_t timestamp_ms, const std::vector<std::uint8_t>& payload) {
+        const std::size_t start = out.size();
+        out.push_back(laneproto::kSyncByte);
+        out.push_back(laneproto::kProtocolVersion);
+        out.push_back(static_cast<std::uint8_t>(type));
+        out.push_back(seq);
+        for (int shift = 0; shift < 32; shift += 8)
+            out.push_back(static_cast<std::uint8_t>(timestamp_ms >> shift));
+        putLe16(out, static_cast<std::uint16_t>(payload.size()));
+        out.insert(out.end(), payload.begin(), payload.end());
+        putLe16(out, laneproto::crc16_ibm(out.data() + start + 1, out.size() - start - 1));
+    }
+
+    // Message i: a lane summary, then kObjectsPerMessage markings. The lane's
+    // left offset and every marking's x carry the sequence number, so the
+    // consumer can tell a frame stitched from two messages
+    std::vector<std::uint8_t> recording(int messages) {
+        std::vector<std::uint8_t> bytes;
+        for (int i = 0; i < messages; ++i) {
+            const auto seq = static_cast<std::uint8_t>(i);
+            const auto timestamp = static_cast<std::uint32_t>(1000 + 50 * i);
+
+            std::vector<std::uint8_t> lane;
+            putLe16(lane, static_cast<std::uint16_t>(-static_cast<int>(seq)));
+            putLe16(lane, static_cast<std::uint16_t>(35));
+            lane.insert(lane.end(), {1, 1, 0, 200});
+            appendFrame(bytes, laneproto::MsgType::LaneSummary, seq, timestamp, lane);
+
+            std::vector<std::uint8_t> markings{static_cast<std::uint8_t>(kObjectsPerMessage)};
+            for (std::size_t k = 0; k < kObjectsPerMessage; ++k) {
+                markings.push_back(static_cast<std::uint8_t>(laneproto::MarkingClassId::Arrow));
+                putLe16(markings, seq);
+                putLe16(markings, static_cast<std::uint16_t>(k));
+                for (int field = 0; field < 3; ++field)
+                    putLe16(markings, 10);
+                markings.push_back(90);
+                markings.push_back(0);
+            }
+            appendFrame(bytes, laneproto::MsgType::MarkingObjects, seq, timestamp, markings);
+        }
+        return bytes;
+    }
+
+    int listenTcp(std::uint16_t& port) {
+        const int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t len = sizeof(addr);
+        if (fd < 0 || ::bind(fd, reinterpret_cast<sockaddr*>(&addr), len) != 0 || ::listen(fd, 1024) != 0 ||
+            ::getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len) != 0)
+            return -1;
+        port = ntohs(addr.sin_port);
+        return fd;
+    }
+
+    int listenUnix(const std::string& path) {
+        ::unlink(path.c_str());
+        const int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+        if (fd < 0 || ::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || ::listen(fd, 16) != 0)
+            return -1;
+        return fd;
+    }
+
+    void writeAll(int fd, const std::vector<std::uint8_t>& bytes) {
+        for (std::size_t off = 0; off < bytes.size();) {
+            const ssize_t n = ::write(fd, bytes.data() + off, std::min(kWriteChunk, bytes.size() - off));
+            if (n <= 0)
+                return;
+            off += static_cast<std::size_t>(n);
+        }
+    }
+
+    template <typename Predicate>
+    bool waitFor(Predicate&& done) {
+        const auto deadline = Clock::now() + kTimeout;
+        while (!done()) {
+            if (Clock::now() > deadline)
+                return false;
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        return true;
+    }
+
+    // What the GUI thread does in ConnectionManager::drainMessages
+    class Consumer {
+    public:
+        explicit Consumer(std::shared_ptr<network::ParsedMessageQueue> queue)
+            : queue_(std::move(queue)), thread_([this]() { run(); }) {}
+
+        ~Consumer() {
+            {
+                std::lock_guard<std::mutex> guard(mutex_);
+                stopping_ = true;
+            }
+            cv_.notify_one();
+            thread_.join();
+        }
+
+        void wake() {
+            {
+                std::lock_guard<std::mutex> guard(mutex_);
+                wakeups_ = true;
+            }
+            cv_.notify_one();
+        }
+
+        std::atomic<std::uint64_t> lanes{0};
+        std::atomic<std::uint64_t> markings{0};
+        std::atomic<std::uint64_t> corrupt{0};
+
+    private:
+        std::shared_ptr<network::ParsedMessageQueue> queue_;
+        std::mutex mutex_;
+        std::condition_variable cv_;
+        bool wakeups_ = false;
+        bool stopping_ = false;
+        std::thread thread_;
+
+        void run() {
+            std::unique_lock<std::mutex> lock(mutex_);
+            while (!stopping_) {
+                cv_.wait(lock, [this]() { return wakeups_ || stopping_; });
+                wakeups_ = false;
+                lock.unlock();
+                queue_->drain([this](const network::ParsedMessage& msg) { check(msg); });
+                lock.lock();
+            }
+        }
+
+        // Same arithmetic as the parser's fixed-point decode, so exact compares hold
+        static float decimetres(int value) {
+            return static_cast<float>(value) * 0.1f;
+        }
+
+        void check(const network::ParsedMessage& msg) {
+            if (msg.kind == network::ParsedMessage::Kind::LaneSummary) {
+                lanes.fetch_add(1, std::memory_order_relaxed);
+                const laneproto::LaneSummary& lane = msg.lane_summary;
+                if (lane.left_offset_m != decimetres(-lane.seq) || lane.right_offset_m != decimetres(35) ||
+                    lane.quality != 200)
+                    corrupt.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            markings.fetch_add(1, std::memory_order_relaxed);
+            const laneproto::MarkingObjects& objects = msg.marking_objects;
+            bool intact = objects.objects.size() == kObjectsPerMessage;
+            for (std::size_t k = 0; intact && k < kObjectsPerMessage; ++k) {
+                const laneproto::MarkingObject& object = objects.objects[k];
+                intact = object.x_m == decimetres(objects.seq) && object.y_m == decimetres(static_cast<int>(k)) &&
+                         object.confidence == 90;
+            }
+            if (!intact)
+                corrupt.fetch_add(1, std::memory_order_relaxed);
+        }
+    };
+
+    bool report(bool ok, const char* what) {
+        std::printf("  %-48s %s\n", what, ok ? "ok" : "FAIL");
+        return ok;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    int streams = 64;
+    int messages = 200;
+    for (int i = 1; i < argc; ++i) {
+        int* target = nullptr;
+        if (std::strcmp(argv[i], "--streams") == 0)
+            target = &streams;
+        else if (std::strcmp(argv[i], "--messages") == 0)
+            target = &messages;
+        if (!target || i + 1 >= argc || (*target = std::atoi(argv[i + 1])) <= 0) {
+            std::fprintf(stderr, "usage: %s [--streams N] [--messages N]\n", argv[0]);
+            return 2;
+        }
+        ++i;
+    }
+
+    std::uint16_t port = 0;
+    const int tcp_listener = listenTcp(port);
+    const std::string unix_path = "/tmp/ingest_loopback_check." + std::to_string(::getpid()) + ".sock";
+    const int unix_listener = listenUnix(unix_path);
+    if (tcp_listener < 0 || unix_listener < 0) {
+        std::perror("listen");
+        return 1;
+    }
+
+    // Enough room for everything, so any loss is a bug rather than a drop
+    const std::size_t total = static_cast<std::size_t>(streams + 1) * static_cast<std::size_t>(messages) * 2;
+    auto queue = std::make_shared<network::ParsedMessageQueue>(total, network::OverflowPolicy::DropNewest);
+    Consumer consumer(queue);
+
+    std::atomic<int> connected{0};
+    std::atomic<int> disconnected{0};
+    std::atomic<int> parse_errors{0};
+    network::IngestQueueSink::Callbacks callbacks;
+    callbacks.messagesAvailable = [&consumer]() { consumer.wake(); };
+    callbacks.streamStateChanged = [&](network::StreamId, network::StreamState state) {
+        if (state == network::StreamState::Connected)
+            ++connected;
+        else if (state == network::StreamState::Disconnected)
+            ++disconnected;
+    };
+    callbacks.parseErrorOccurred = [&](network::StreamId, const laneproto::ParseError&) { ++parse_errors; };
+    network::IngestQueueSink sink(queue, callbacks);
+
+    network::IngestEngineConfig config;
+    config.reconnect_interval_ms = 0;
+    network::IngestEngine engine(sink, config);
+
+    std::vector<network::StreamId> ids;
+    for (int i = 0; i < streams; ++i)
+        ids.push_back(engine.addStream(network::StreamEndpoint::tcp("127.0.0.1", port)));
+    ids.push_back(engine.addStream(network::StreamEndpoint::unixSocket(unix_path)));
+
+    bool ok = true;
+    std::printf("%d TCP streams + 1 Unix stream, %d lane + %d marking messages each\n", streams, messages, messages);
+    ok &= report(engine.start() && engine.isRunning(), "engine started");
+
+    std::vector<int> peers;
+    for (int i = 0; i < streams; ++i)
+        peers.push_back(::accept(tcp_listener, nullptr, nullptr));
+    peers.push_back(::accept(unix_listener, nullptr, nullptr));
+    ok &= report(std::none_of(peers.begin(), peers.end(), [](int fd) { return fd < 0; }), "every stream accepted");
+    ok &= report(waitFor([&]() { return connected.load() == streams + 1; }), "every stream reported Connected");
+
+    const std::vector<std::uint8_t> bytes = recording(messages);
+    std::vector<std::thread> writers;
+    for (int fd : peers)
+        writers.emplace_back(writeAll, fd, std::cref(bytes));
+    for (auto& writer : writers)
+        writer.join();
+
+    const auto expected = static_cast<std::uint64_t>(streams + 1) * static_cast<std::uint64_t>(messages);
+    ok &= report(waitFor([&]() { return consumer.lanes.load() == expected && consumer.markings.load() == expected; }),
+                 "every message delivered");
+    std::printf("    lanes %llu, markings %llu of %llu each\n",
+                static_cast<unsigned long long>(consumer.lanes.load()),
+                static_cast<unsigned long long>(consumer.markings.load()),
+                static_cast<unsigned long long>(expected));
+    ok &= report(consumer.corrupt.load() == 0 && parse_errors.load() == 0 && queue->stats().dropped == 0,
+                 "no corrupt, unparsable or dropped message");
+
+    bool per_stream = true;
+    for (network::StreamId id : ids) {
+        network::StreamStats stats;
+        per_stream &= engine.streamStats(id, stats) && stats.bytes_received == bytes.size() &&
+                      stats.lane_summaries == static_cast<std::uint64_t>(messages) &&
+                      stats.marking_objects == static_cast<std::uint64_t>(messages);
+    }
+    ok &= report(per_stream, "per-stream counters match");
+
+    ::close(peers.front());
+    ok &= report(waitFor([&]() { return disconnected.load() == 1; }), "peer close reported as Disconnected");
+
+    const std::uint16_t refused_port = port;
+    ::close(tcp_listener);
+    const int before = disconnected.load();
+    engine.addStream(network::StreamEndpoint::tcp("127.0.0.1", refused_port));
+    ok &= report(waitFor([&]() { return disconnected.load() == before + 1; }), "refused connection reported as Disconnected");
+
+    engine.stop();
+    ok &= report(!engine.isRunning(), "engine stopped");
+    for (int fd : peers)
+        ::close(fd);
+
+    // Only the Unix listener is left; its stream must come back on restart
+    connected = 0;
+    ok &= report(engine.start() && engine.isRunning(), "engine restarted");
+    const int again = ::accept(unix_listener, nullptr, nullptr);
+    ok &= report(again >= 0 && waitFor([&]() { return connected.load() == 1; }), "stream reconnected after restart");
+
+    engine.stop();
+    if (again >= 0)
+        ::close(again);
+    ::close(unix_listener);
+    ::unlink(unix_path.c_str());
+    return ok ? 0 : 1;
+}
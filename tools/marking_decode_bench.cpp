@@ -0,0 +1,170 @@
+// Checks that every supported laneproto::decodeMarkingObjects kernel
+// decodes exactly what MarkingObjectsView::decodeInto does, then times
+// them against decodeInto on a full 78-record payload.
+//
+//     marking_decode_bench [--check] [--iterations N]
+//
+// The check covers every record count from 0 to the protocol maximum on
+// random payloads, each in an exactly sized buffer, and every 16-bit value
+// of the fixed-point fields. --check skips the timing. Exits non-zero on
+// any mismatch.
+
+#include "marking_soa.h"
+#include "proto_parser.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace {
+    using laneproto::MarkingDecodeKernel;
+    using laneproto::MarkingObjectsSoA;
+    using laneproto::MarkingObjectsView;
+
+    constexpr MarkingDecodeKernel kKernels[] = {MarkingDecodeKernel::Scalar, MarkingDecodeKernel::Avx2};
+
+    bool sameBits(float a, float b) {
+        return std::memcmp(&a, &b, sizeof(float)) == 0;
+    }
+
+    // Record i of soa against the AoS decode of the same record
+    bool sameRecord(const laneproto::MarkingObject& expected, const MarkingObjectsSoA& soa, std::size_t i) {
+        return expected.class_id == soa.class_id[i] &&
+               sameBits(expected.x_m, soa.x_m[i]) &&
+               sameBits(expected.y_m, soa.y_m[i]) &&
+               sameBits(expected.length_m, soa.length_m[i]) &&
+               sameBits(expected.width_m, soa.width_m[i]) &&
+               sameBits(expected.yaw_deg, soa.yaw_deg[i]) &&
+               expected.confidence == soa.confidence[i] &&
+               expected.flags == soa.flags[i];
+    }
+
+    // Returns the number of mismatching records
+    std::size_t compare(const MarkingObjectsView& view, MarkingDecodeKernel kernel) {
+        static laneproto::MarkingObjects expected;
+        static MarkingObjectsSoA actual;
+        view.decodeInto(expected);
+        laneproto::decodeMarkingObjects(kernel, view, actual);
+
+        std::size_t mismatches = actual.size == expected.objects.size() &&
+                                 actual.timestamp_ms == expected.timestamp_ms &&
+                                 actual.seq == expected.seq ? 0 : 1;
+        for (std::size_t i = 0; i < expected.objects.size() && i < actual.size; ++i) {
+            if (!sameRecord(expected.objects[i], actual, i))
+                ++mismatches;
+        }
+        return mismatches;
+    }
+
+    std::size_t checkKernel(MarkingDecodeKernel kernel) {
+        constexpr std::size_t kRecord = laneproto::kMarkingObjectRecordSize;
+        std::size_t mismatches = 0;
+
+        std::uint32_t state = 1;
+        std::vector<std::uint8_t> random(MarkingObjectsSoA::kCapacity * kRecord);
+        for (auto& byte : random) {
+            state = state * 1664525u + 1013904223u;
+            byte = static_cast<std::uint8_t>(state >> 24);
+        }
+        for (std::size_t count = 0; count <= MarkingObjectsSoA::kCapacity; ++count) {
+            // Exactly sized, so a kernel reading past the last record shows
+            // up under a sanitizer
+            const std::vector<std::uint8_t> records(random.begin(), random.begin() + static_cast<std::ptrdiff_t>(count * kRecord));
+            mismatches += compare(MarkingObjectsView(0x12345678u, static_cast<laneproto::SequenceNumber>(count),
+                                                     records.data(), count), kernel);
+        }
+
+        // Every 16-bit pattern in every fixed-point field, eight records
+        // (one vector) at a time
+        std::vector<std::uint8_t> records(8 * kRecord);
+        for (std::uint32_t value = 0; value <= 0xffff; value += 8) {
+            for (std::size_t r = 0; r < 8; ++r) {
+                std::uint8_t* p = records.data() + r * kRecord;
+                const std::uint32_t v = value + static_cast<std::uint32_t>(r);
+                p[0] = static_cast<std::uint8_t>(v % 3);
+                for (std::size_t field = 1; field < 11; field += 2) {
+                    p[field] = static_cast<std::uint8_t>(v & 0xff);
+                    p[field + 1] = static_cast<std::uint8_t>(v >> 8);
+                }
+                p[11] = static_cast<std::uint8_t>(v);
+                p[12] = static_cast<std::uint8_t>(v >> 8);
+            }
+            mismatches += compare(MarkingObjectsView(0, 0, records.data(), 8), kernel);
+        }
+        return mismatches;
+    }
+
+    template <typename Decode>
+    double nanosecondsPerPayload(int iterations, Decode&& decode) {
+        decode();
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i)
+            decode();
+        const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count() / iterations;
+    }
+
+    void usage(const char* program) {
+        std::fprintf(stderr, "usage: %s [--check] [--iterations N]\n", program);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    bool check_only = false;
+    int iterations = 200000;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--check") == 0) {
+            check_only = true;
+        } else if (std::strcmp(argv[i], "--iterations") == 0 && i + 1 < argc && std::atoi(argv[i + 1]) > 0) {
+            iterations = std::atoi(argv[++i]);
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    std::size_t mismatches = 0;
+    for (MarkingDecodeKernel kernel : kKernels) {
+        if (!laneproto::isMarkingDecodeKernelSupported(kernel)) {
+            std::printf("%-8s not supported on this CPU, skipped\n", laneproto::markingDecodeKernelName(kernel));
+            continue;
+        }
+        const std::size_t bad = checkKernel(kernel);
+        std::printf("%-8s %zu mismatches against decodeInto\n", laneproto::markingDecodeKernelName(kernel), bad);
+        mismatches += bad;
+    }
+    if (check_only || mismatches != 0)
+        return mismatches == 0 ? 0 : 1;
+
+    std::vector<std::uint8_t> records(MarkingObjectsSoA::kCapacity * laneproto::kMarkingObjectRecordSize);
+    std::uint32_t state = 7;
+    for (auto& byte : records) {
+        state = state * 1664525u + 1013904223u;
+        byte = static_cast<std::uint8_t>(state >> 24);
+    }
+    const MarkingObjectsView view(1, 2, records.data(), MarkingObjectsSoA::kCapacity);
+
+    std::printf("%zu records per payload, %d iterations\n", MarkingObjectsSoA::kCapacity, iterations);
+    laneproto::MarkingObjects aos;
+    const double aos_ns = nanosecondsPerPayload(iterations, [&]() {
+        view.decodeInto(aos);
+        asm volatile("" : : "r"(aos.objects.data()) : "memory");
+    });
+    std::printf("  %-12s %8.1f ns\n", "decodeInto", aos_ns);
+
+    static MarkingObjectsSoA soa;
+    for (MarkingDecodeKernel kernel : kKernels) {
+        if (!laneproto::isMarkingDecodeKernelSupported(kernel))
+            continue;
+        const double ns = nanosecondsPerPayload(iterations, [&]() {
+            laneproto::decodeMarkingObjects(kernel, view, soa);
+            asm volatile("" : : "r"(soa.x_m) : "memory");
+        });
+        std::printf("  %-12s %8.1f ns\n", laneproto::markingDecodeKernelName(kernel), ns);
+    }
+    return 0;
+}
@@ -0,0 +1,214 @@
+// Runs domain::MarkingTracker over a synthetic marking stream and reports
+// the time per update and how well track ids follow the ground truth.
+//
+//     marking_tracker_bench [--objects N] [--frames N] [--separation M]
+//                           [--noise M] [--dropout P] [--seed S]
+//
+// Objects of two classes are spread over 5..125 m ahead and +-15 m to the
+// side, at least --separation apart, and drift towards the vehicle at
+// 15 m/s with 20 Hz frames. Each frame every position gets Gaussian noise,
+// each object is missed with probability --dropout, and the detections
+// arrive in random order. Objects that pass behind the vehicle respawn
+// far ahead as new objects.
+//
+// An id switch is an object whose confirmed track id changes while it
+// stays in view. The per-update budget is 50 us.
+
+#include "MarkingTracker.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace {
+    constexpr double kBudgetUs = 50.0;
+    constexpr std::uint64_t kFrameMs = 50;
+    constexpr float kSpeedMps = 15.0f;
+    constexpr int kWarmupFrames = 100;
+
+    struct Options {
+        int objects = 78;
+        int frames = 20000;
+        float separation_m = 3.0f;
+        float noise_m = 0.1f;
+        float dropout = 0.05f;
+        unsigned seed = 7;
+    };
+
+    struct TruthObject {
+        float x_m = 0.0f;
+        float y_m = 0.0f;
+        laneproto::MarkingClassId class_id{};
+        std::uint32_t track_id = 0;     // last confirmed id seen for it
+    };
+
+    class Scene {
+    public:
+        explicit Scene(const Options& options)
+            : options_(options), rng_(options.seed), objects_(static_cast<std::size_t>(options.objects)) {
+            for (auto& object : objects_)
+                spawn(object, 5.0f, 125.0f);
+        }
+
+        std::vector<TruthObject>& objects() noexcept { return objects_; }
+        std::mt19937& rng() noexcept { return rng_; }
+
+        void advance(float dt_s) {
+            for (auto& object : objects_) {
+                object.x_m -= kSpeedMps * dt_s;
+                if (object.x_m < -5.0f)
+                    spawn(object, 120.0f, 125.0f);
+            }
+        }
+
+    private:
+        float uniform(float lo, float hi) {
+            return std::uniform_real_distribution<float>(lo, hi)(rng_);
+        }
+
+        bool clear(const TruthObject& object) const {
+            for (const auto& other : objects_) {
+                if (&other != &object &&
+                    std::abs(other.x_m - object.x_m) < options_.separation_m &&
+                    std::abs(other.y_m - object.y_m) < options_.separation_m)
+                    return false;
+            }
+            return true;
+        }
+
+        void spawn(TruthObject& object, float x_min, float x_max) {
+            // Gives up on the separation after a while rather than spin on
+            // a crowded scene
+            for (int attempt = 0; attempt < 100; ++attempt) {
+                object.x_m = uniform(x_min, x_max);
+                object.y_m = uniform(-15.0f, 15.0f);
+                if (clear(object))
+                    break;
+            }
+            object.class_id = uniform(0.0f, 1.0f) < 0.5f ? laneproto::MarkingClassId::Crosswalk
+                                                         : laneproto::MarkingClassId::Arrow;
+            object.track_id = 0;
+        }
+
+        Options options_;
+        std::mt19937 rng_;
+        std::vector<TruthObject> objects_;
+    };
+
+    bool parseArgs(int argc, char** argv, Options& options) {
+        for (int i = 1; i + 1 < argc; i += 2) {
+            const char* name = argv[i];
+            const char* value = argv[i + 1];
+            if (std::strcmp(name, "--objects") == 0)
+                options.objects = std::atoi(value);
+            else if (std::strcmp(name, "--frames") == 0)
+                options.frames = std::atoi(value);
+            else if (std::strcmp(name, "--separation") == 0)
+                options.separation_m = static_cast<float>(std::atof(value));
+            else if (std::strcmp(name, "--noise") == 0)
+                options.noise_m = static_cast<float>(std::atof(value));
+            else if (std::strcmp(name, "--dropout") == 0)
+                options.dropout = static_cast<float>(std::atof(value));
+            else if (std::strcmp(name, "--seed") == 0)
+                options.seed = static_cast<unsigned>(std::strtoul(value, nullptr, 10));
+            else
+                return false;
+        }
+        return argc % 2 == 1 && options.objects > 0 && options.frames > kWarmupFrames;
+    }
+
+    void usage(const char* program) {
+        std::fprintf(stderr,
+                     "usage: %s [--objects N] [--frames N] [--separation M] [--noise M] [--dropout P] [--seed S]\n",
+                     program);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Options options;
+    if (!parseArgs(argc, argv, options)) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    Scene scene(options);
+    std::normal_distribution<float> noise(0.0f, options.noise_m);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    domain::MarkingTracker tracker;
+    domain::MarkingObjectModel model;
+    laneproto::MarkingObjects msg;
+    std::vector<std::size_t> source;        // truth index per detection
+    std::vector<double> update_us;
+    update_us.reserve(static_cast<std::size_t>(options.frames));
+
+    std::uint64_t switches = 0;
+    std::uint64_t observations = 0;
+    std::uint64_t confirmed = 0;
+
+    for (int frame = 0; frame < options.frames; ++frame) {
+        const std::uint64_t timestamp_ms = 1000 + static_cast<std::uint64_t>(frame) * kFrameMs;
+        scene.advance(kFrameMs / 1000.0f);
+
+        source.clear();
+        for (std::size_t i = 0; i < scene.objects().size(); ++i) {
+            if (unit(scene.rng()) >= options.dropout)
+                source.push_back(i);
+        }
+        std::shuffle(source.begin(), source.end(), scene.rng());
+
+        msg.objects.clear();
+        msg.timestamp_ms = static_cast<laneproto::TimestampMs>(timestamp_ms);
+        for (std::size_t i : source) {
+            const TruthObject& object = scene.objects()[i];
+            laneproto::MarkingObject detection{};
+            detection.class_id = object.class_id;
+            detection.x_m = object.x_m + noise(scene.rng());
+            detection.y_m = object.y_m + noise(scene.rng());
+            detection.confidence = 90;
+            msg.objects.push_back(detection);
+        }
+        model.updateFromProto(msg);
+
+        const auto start = std::chrono::steady_clock::now();
+        tracker.update(model, timestamp_ms);
+        const std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+        if (frame >= kWarmupFrames)
+            update_us.push_back(elapsed.count());
+
+        for (std::size_t k = 0; k < source.size(); ++k) {
+            TruthObject& object = scene.objects()[source[k]];
+            const std::uint32_t id = model[k].trackId();
+            ++observations;
+            if (id == 0)
+                continue;
+            ++confirmed;
+            if (object.track_id != 0 && object.track_id != id)
+                ++switches;
+            object.track_id = id;
+        }
+    }
+
+    std::sort(update_us.begin(), update_us.end());
+    double total_us = 0.0;
+    for (double us : update_us)
+        total_us += us;
+    const double mean_us = total_us / static_cast<double>(update_us.size());
+    const double p99_us = update_us[update_us.size() * 99 / 100];
+
+    std::printf("%d objects, %d frames, separation %.1f m, noise %.2f m, dropout %.0f%%\n",
+                options.objects, options.frames, options.separation_m, options.noise_m, options.dropout * 100.0f);
+    std::printf("  update: mean %.2f us, p99 %.2f us, max %.2f us (budget %.0f us: %s)\n",
+                mean_us, p99_us, update_us.back(), kBudgetUs, mean_us <= kBudgetUs ? "ok" : "EXCEEDED");
+    std::printf("  id switches: %llu\n", static_cast<unsigned long long>(switches));
+    std::printf("  confirmed: %.1f%% of observations\n",
+                100.0 * static_cast<double>(confirmed) / static_cast<double>(observations));
+    return 0;
+}
@@ -0,0 +1,142 @@
+// Feeds MarkingOverlayProcessor 60 fps frames against a SnapshotTimeline
+// that receives 20 Hz sensor snapshots, with lane interpolation on, and
+// checks that the marking and warning layer is redrawn at about the sensor
+// rate rather than for every interpolated frame.
+//
+//     overlay_rebuild_check [--seconds N]
+//
+// Runs on the offscreen platform unless QT_QPA_PLATFORM says otherwise.
+// Exits non-zero if the layer rebuilds more than once per snapshot (plus
+// the initial build) or if no frame was interpolated.
+
+#include "BasicFrameHandle.hpp"
+#include "MarkingOverlayProcessor.hpp"
+#include "SnapshotTimeline.h"
+
+#include <QGuiApplication>
+#include <QImage>
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+    constexpr std::uint64_t kStartMs = 1000000;
+    constexpr std::uint64_t kSensorPeriodMs = 50;
+    constexpr double kFramePeriodMs = 1000.0 / 60.0;
+    constexpr std::uint64_t kHoldBackMs = 60;
+    constexpr int kMarkings = 20;
+
+    // Lane drifting sideways and markings moving towards the vehicle, so
+    // every snapshot really differs from the previous one
+    void fillSnapshot(domain::DomainSnapshot& snapshot, std::uint64_t now_ms, std::uint32_t index)
+    {
+        const float t = static_cast<float>(index) * kSensorPeriodMs / 1000.0f;
+
+        laneproto::LaneSummary lane{};
+        lane.timestamp_ms = static_cast<laneproto::TimestampMs>(now_ms);
+        lane.seq = static_cast<laneproto::SequenceNumber>(index);
+        lane.left_offset_m = -1.6f + 0.4f * std::sin(t);
+        lane.right_offset_m = lane.left_offset_m + 3.5f;
+        lane.quality = 200;
+        snapshot.lane.updateFromProto(lane);
+
+        laneproto::MarkingObjects markings;
+        markings.timestamp_ms = lane.timestamp_ms;
+        markings.seq = lane.seq;
+        for (int i = 0; i < kMarkings; ++i) {
+            laneproto::MarkingObject obj{};
+            obj.class_id = i % 2 ? laneproto::MarkingClassId::Arrow : laneproto::MarkingClassId::Crosswalk;
+            obj.x_m = std::fmod(5.0f * static_cast<float>(i) + 60.0f - 15.0f * t, 100.0f);
+            obj.y_m = static_cast<float>(i % 5) - 2.0f;
+            obj.confidence = 90;
+            markings.objects.push_back(obj);
+        }
+        snapshot.markings.updateFromProto(markings);
+
+        snapshot.warnings.clear();
+        snapshot.warnings.addWarning(domain::Warning(domain::WarningType::CrosswalkAhead,
+                                                     domain::WarningSeverity::Warning, now_ms,
+                                                     snapshot.markings[0].xMeters(), 90));
+
+        snapshot.timestamp_ms = now_ms;
+        snapshot.lane_host_ms = now_ms;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    int seconds = 10;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--seconds") == 0 && i + 1 < argc && std::atoi(argv[i + 1]) > 0) {
+            seconds = std::atoi(argv[++i]);
+        } else {
+            std::fprintf(stderr, "usage: %s [--seconds N]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    QGuiApplication app(argc, argv);
+
+    domain::AlignmentConfig alignment;
+    alignment.hold_back_ms = kHoldBackMs;
+    alignment.interpolate_lane = true;
+    domain::SnapshotTimeline timeline(alignment);
+    domain::SnapshotPublisher publisher;
+
+    video::MarkingOverlayProcessor processor;
+    processor.setSnapshotSource(&timeline);
+
+    const QImage blank(1280, 720, QImage::Format_RGB32);
+    const std::uint64_t end_ms = kStartMs + static_cast<std::uint64_t>(seconds) * 1000;
+
+    std::uint32_t snapshots = 0;
+    std::uint64_t frames = 0;
+    std::uint64_t interpolated = 0;
+    std::uint64_t next_sensor_ms = kStartMs;
+    double next_frame_ms = static_cast<double>(kStartMs + kHoldBackMs);
+
+    while (next_sensor_ms < end_ms || next_frame_ms < static_cast<double>(end_ms)) {
+        if (static_cast<double>(next_sensor_ms) <= next_frame_ms) {
+            auto snapshot = publisher.acquire();
+            fillSnapshot(*snapshot, next_sensor_ms, snapshots++);
+            publisher.publish(snapshot);
+            timeline.record(publisher.current());
+            next_sensor_ms += kSensorPeriodMs;
+            continue;
+        }
+
+        const auto frame_ms = static_cast<std::uint64_t>(next_frame_ms);
+        if (timeline.align(frame_ms).interpolated)
+            ++interpolated;
+
+        video::FrameHandlePtr frame(new video::BasicFrameHandle(blank));
+        frame->setTimestamp(static_cast<int64_t>(frame_ms));
+        processor.processFrame(frame);
+        ++frames;
+        next_frame_ms += kFramePeriodMs;
+    }
+
+    const video::OverlayLayerStats stats = processor.layerStats();
+    std::printf("%u snapshots, %llu frames (%llu interpolated)\n", snapshots,
+                static_cast<unsigned long long>(frames), static_cast<unsigned long long>(interpolated));
+    std::printf("  composited %llu, marking/warning rebuilds %llu, lane rebuilds %llu\n",
+                static_cast<unsigned long long>(stats.composited),
+                static_cast<unsigned long long>(stats.rebuilds),
+                static_cast<unsigned long long>(stats.lane_rebuilds));
+
+    bool ok = true;
+    if (interpolated == 0) {
+        std::printf("FAIL: no frame was interpolated, the check exercises nothing\n");
+        ok = false;
+    }
+    if (stats.rebuilds > static_cast<quint64>(snapshots) + 1) {
+        std::printf("FAIL: marking/warning layer rebuilt more often than snapshots arrived\n");
+        ok = false;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,347 @@
+// Compares domain::WarningEngine, which runs compiled rules, with the
+// hand-coded update it replaced, kept here as the reference.
+//
+//     warning_rules_bench [--frames N] [--iterations N] [--seed S]
+//
+// First runs both on random lane and marking frames with the built-in
+// rules and checks they raise the same warnings: same type, severity,
+// distance, confidence, message and source. Then times both on a fixed
+// frame of 78 objects, and the compiled engine alone with 100, 300 and
+// 1000 generated rules. Exits non-zero if any frame differs.
+
+#include "WarningEngine.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace {
+    using domain::LaneState;
+    using domain::MarkingIndex;
+    using domain::MarkingObject;
+    using domain::WarningSeverity;
+    using domain::WarningType;
+    using laneproto::MarkingClassId;
+
+    // What the hand-coded engine produced: Warning as it was then, with
+    // the message built as a string for every warning
+    struct ReferenceWarning {
+        WarningType type = WarningType::Unknown;
+        WarningSeverity severity = WarningSeverity::Info;
+        std::uint64_t timestamp_ms = 0;
+        float distance_m = 0.0f;
+        std::uint8_t confidence = 0;
+        std::string message;
+        std::uint32_t source_id = 0;
+    };
+
+    // WarningEngine::update before the rules were compiled from the config
+    class HandCodedWarningEngine {
+    public:
+        explicit HandCodedWarningEngine(const domain::WarningEngineConfig& config) : config_(config) {}
+
+        std::vector<ReferenceWarning> update(const LaneState& lane, const MarkingIndex& markings,
+                                             std::uint64_t timestamp_ms) const {
+            std::vector<ReferenceWarning> result;
+            result.reserve(8);
+            addCrosswalkWarnings(markings, timestamp_ms, result);
+            addLaneDepartureWarnings(lane, timestamp_ms, result);
+            return result;
+        }
+
+    private:
+        void addCrosswalkWarnings(const MarkingIndex& markings, std::uint64_t timestamp_ms,
+                                  std::vector<ReferenceWarning>& out) const {
+            if (!config_.enable_crosswalk_warnings)
+                return;
+
+            markings.forEachInRange(MarkingClassId::Crosswalk, 0.0f, config_.crosswalk_distance_threshold_m,
+                                    [&](const MarkingObject& obj) {
+                if (!obj.isConfident(config_.min_marking_confidence))
+                    return;
+                ReferenceWarning w;
+                w.type = WarningType::CrosswalkAhead;
+                w.severity = obj.xMeters() < config_.crosswalk_critical_distance_m
+                    ? WarningSeverity::Critical : WarningSeverity::Warning;
+                w.timestamp_ms = timestamp_ms;
+                w.distance_m = obj.xMeters();
+                w.confidence = obj.confidence();
+                w.message = "Crosswalk ahead at ";
+                w.message += std::to_string(static_cast<int>(obj.xMeters()));
+                w.message += " m";
+                w.source_id = obj.trackId();
+                out.push_back(std::move(w));
+            });
+        }
+
+        void addLaneDepartureWarnings(const LaneState& lane, std::uint64_t timestamp_ms,
+                                      std::vector<ReferenceWarning>& out) const {
+            if (!config_.enable_lane_departure_warnings || !lane.isValid() ||
+                !lane.isQualityGood(config_.min_lane_quality) || !lane.hasValidOffsets())
+                return;
+
+            const float center_offset = lane.centerOffsetMeters();
+            const char* side = nullptr;
+            WarningType type = WarningType::Unknown;
+            if (center_offset < -config_.lane_departure_offset_threshold_m) {
+                side = "left";
+                type = WarningType::LaneDepartureLeft;
+            } else if (center_offset > config_.lane_departure_offset_threshold_m) {
+                side = "right";
+                type = WarningType::LaneDepartureRight;
+            } else {
+                return;
+            }
+
+            ReferenceWarning w;
+            w.type = type;
+            w.severity = WarningSeverity::Warning;
+            w.timestamp_ms = timestamp_ms;
+            w.distance_m = std::fabs(center_offset);
+            w.confidence = lane.qualityRaw();
+            w.message = "Lane departure ";
+            w.message += side;
+            w.message += ": offset ";
+            w.message += std::to_string(static_cast<int>(std::fabs(center_offset) * 100));
+            w.message += " cm";
+            out.push_back(std::move(w));
+        }
+
+        domain::WarningEngineConfig config_;
+    };
+
+    using WarningKey = std::tuple<int, int, float, int, std::string, std::uint32_t>;
+
+    std::vector<WarningKey> keys(const std::vector<ReferenceWarning>& warnings) {
+        std::vector<WarningKey> out;
+        for (const auto& w : warnings)
+            out.emplace_back(static_cast<int>(w.type), static_cast<int>(w.severity), w.distance_m,
+                             w.confidence, w.message, w.source_id);
+        std::sort(out.begin(), out.end());
+        return out;
+    }
+
+    std::vector<WarningKey> keys(const std::vector<domain::Warning>& warnings) {
+        std::vector<WarningKey> out;
+        for (const auto& w : warnings)
+            out.emplace_back(static_cast<int>(w.type()), static_cast<int>(w.severity()), w.distanceMeters(),
+                             w.confidence(), w.message(), w.sourceId());
+        std::sort(out.begin(), out.end());
+        return out;
+    }
+
+    class FrameGenerator {
+    public:
+        explicit FrameGenerator(unsigned seed) : rng_(seed) {}
+
+        // Up to 80 objects of all classes, some on whole metres so the
+        // threshold comparisons are hit exactly, some without a track id
+        void markings(domain::MarkingObjectModel& model) {
+            laneproto::MarkingObjects msg;
+            const int count = static_cast<int>(rng_() % 80);
+            for (int i = 0; i < count; ++i) {
+                laneproto::MarkingObject obj{};
+                obj.class_id = static_cast<MarkingClassId>(rng_() % 3);
+                obj.x_m = rng_() % 20 == 0 ? static_cast<float>(rng_() % 31) : uniform(-10.0f, 50.0f);
+                obj.y_m = uniform(-10.0f, 10.0f);
+                obj.confidence = static_cast<std::uint8_t>(rng_() % 101);
+                msg.objects.push_back(obj);
+            }
+            model.updateFromProto(msg);
+            for (std::size_t i = 0; i < model.size(); ++i)
+                model.setTrackId(i, rng_() % 3 ? static_cast<std::uint32_t>(i + 1) : 0);
+        }
+
+        // Mostly valid lanes, occasionally with swapped (invalid) offsets
+        void lane(LaneState& lane) {
+            lane = LaneState{};
+            if (rng_() % 8 == 0)
+                return;
+            laneproto::LaneSummary msg{};
+            msg.left_offset_m = uniform(-2.0f, -0.5f);
+            msg.right_offset_m = msg.left_offset_m + uniform(2.5f, 3.5f);
+            if (rng_() % 10 == 0)
+                std::swap(msg.left_offset_m, msg.right_offset_m);
+            msg.quality = static_cast<std::uint8_t>(rng_() % 101);
+            lane.updateFromProto(msg);
+        }
+
+        float uniform(float lo, float hi) {
+            return std::uniform_real_distribution<float>(lo, hi)(rng_);
+        }
+
+        std::mt19937& rng() noexcept { return rng_; }
+
+    private:
+        std::mt19937 rng_;
+    };
+
+    std::vector<domain::WarningRuleSpec> generatedRules(int count, FrameGenerator& gen) {
+        std::vector<domain::WarningRuleSpec> rules;
+        for (int r = 0; r < count; ++r) {
+            domain::WarningRuleSpec spec;
+            spec.name = "rule_" + std::to_string(r);
+            if (r % 4 == 0) {
+                spec.subject = domain::WarningSubject::Lane;
+                spec.when = {
+                    {domain::WarningField::LaneQuality, domain::WarningCompare::GreaterEqual, static_cast<float>(gen.rng()() % 100)},
+                    {domain::WarningField::CenterOffset, domain::WarningCompare::Greater, gen.uniform(0.0f, 1.0f)},
+                };
+                spec.hysteresis = {{domain::WarningField::CenterOffset, 0.05f}};
+                spec.message = "Lane offset {abs_center_offset*100} cm";
+            } else {
+                const float x0 = gen.uniform(0.0f, 60.0f);
+                spec.subject = domain::WarningSubject::Marking;
+                spec.marking_class = static_cast<MarkingClassId>(1 + r % 2);
+                spec.when = {
+                    {domain::WarningField::X, domain::WarningCompare::GreaterEqual, x0},
+                    {domain::WarningField::X, domain::WarningCompare::Less, x0 + gen.uniform(5.0f, 20.0f)},
+                    {domain::WarningField::AbsY, domain::WarningCompare::Less, gen.uniform(1.0f, 4.0f)},
+                    {domain::WarningField::Confidence, domain::WarningCompare::GreaterEqual, 50.0f},
+                };
+                spec.critical_when = {{domain::WarningField::X, domain::WarningCompare::Less, x0 + 3.0f}};
+                spec.hysteresis = {{domain::WarningField::X, 1.0f}};
+                spec.min_duration_ms = r % 3 ? 0 : 100;
+                spec.message = "Object at {x} m";
+            }
+            rules.push_back(std::move(spec));
+        }
+        return rules;
+    }
+
+    template <typename Update>
+    double microsecondsPerUpdate(int iterations, Update&& update) {
+        for (int i = 0; i < 100; ++i)
+            update(i);
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i)
+            update(100 + i);
+        const std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count() / iterations;
+    }
+
+    void usage(const char* program) {
+        std::fprintf(stderr, "usage: %s [--frames N] [--iterations N] [--seed S]\n", program);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    int frames = 20000;
+    int iterations = 200000;
+    unsigned seed = 5;
+
+    for (int i = 1; i < argc; i += 2) {
+        if (i + 1 >= argc) {
+            usage(argv[0]);
+            return 2;
+        }
+        if (std::strcmp(argv[i], "--frames") == 0)
+            frames = std::atoi(argv[i + 1]);
+        else if (std::strcmp(argv[i], "--iterations") == 0)
+            iterations = std::atoi(argv[i + 1]);
+        else if (std::strcmp(argv[i], "--seed") == 0)
+            seed = static_cast<unsigned>(std::strtoul(argv[i + 1], nullptr, 10));
+        else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (frames <= 0 || iterations <= 0) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    const domain::WarningEngineConfig config;
+    const HandCodedWarningEngine reference(config);
+    domain::WarningEngine engine(config);
+    FrameGenerator gen(seed);
+
+    domain::MarkingObjectModel model;
+    MarkingIndex index;
+    LaneState lane;
+    std::vector<domain::Warning> warnings;
+
+    // Same output on random frames. The built-in rules keep no hysteresis
+    // or duration state, so every frame stands on its own.
+    int mismatches = 0;
+    std::size_t total = 0;
+    for (int frame = 0; frame < frames; ++frame) {
+        gen.markings(model);
+        index.build(model);
+        gen.lane(lane);
+
+        const std::uint64_t timestamp_ms = static_cast<std::uint64_t>(frame) * 50;
+        const auto expected = keys(reference.update(lane, index, timestamp_ms));
+        engine.update(lane, index, timestamp_ms, warnings);
+        total += expected.size();
+        if (expected != keys(warnings) && ++mismatches <= 3) {
+            std::printf("frame %d: hand-coded raised %zu warnings, compiled rules %zu\n",
+                        frame, expected.size(), warnings.size());
+        }
+    }
+    std::printf("%d random frames, %zu warnings: %d frames differ\n", frames, total, mismatches);
+
+    // A fixed frame of 78 tracked objects and a lane departing to the right
+    {
+        laneproto::MarkingObjects msg;
+        for (int i = 0; i < 78; ++i) {
+            laneproto::MarkingObject obj{};
+            obj.class_id = static_cast<MarkingClassId>(1 + gen.rng()() % 2);
+            obj.x_m = gen.uniform(-5.0f, 75.0f);
+            obj.y_m = gen.uniform(-10.0f, 10.0f);
+            obj.confidence = static_cast<std::uint8_t>(40 + gen.rng()() % 60);
+            msg.objects.push_back(obj);
+        }
+        model.updateFromProto(msg);
+        for (std::size_t i = 0; i < model.size(); ++i)
+            model.setTrackId(i, static_cast<std::uint32_t>(i + 1));
+        index.build(model);
+
+        laneproto::LaneSummary summary{};
+        summary.left_offset_m = -1.5f;
+        summary.right_offset_m = 2.2f;
+        summary.quality = 90;
+        lane = LaneState{};
+        lane.updateFromProto(summary);
+    }
+
+    std::size_t sink = 0;
+    const double hand_coded_us = microsecondsPerUpdate(iterations, [&](int i) {
+        sink += reference.update(lane, index, static_cast<std::uint64_t>(i) * 50).size();
+    });
+    const double compiled_us = microsecondsPerUpdate(iterations, [&](int i) {
+        engine.update(lane, index, static_cast<std::uint64_t>(i) * 50, warnings);
+        sink += warnings.size();
+    });
+    std::printf("built-in rules, 78 objects: hand-coded %.3f us, compiled %.3f us per update\n",
+                hand_coded_us, compiled_us);
+
+    for (int count : {100, 300, 1000}) {
+        domain::WarningEngineConfig scaled;
+        scaled.rules = generatedRules(count, gen);
+        std::string error;
+        if (!engine.setConfig(scaled, &error)) {
+            std::fprintf(stderr, "generated rules rejected: %s\n", error.c_str());
+            return 1;
+        }
+        std::size_t raised = 0;
+        const int updates = std::max(1, iterations / 10);
+        const double us = microsecondsPerUpdate(updates, [&](int i) {
+            engine.update(lane, index, static_cast<std::uint64_t>(i) * 50, warnings);
+            raised += warnings.size();
+        });
+        std::printf("%d rules, 78 objects: %.2f us per update\n", count, us);
+        sink += raised;
+    }
+
+    return mismatches == 0 && sink != 0 ? 0 : 1;
+}
@@ -0,0 +1,184 @@
+// Times video::convertYuv420ToRgb32 on a synthetic NV12 frame against the
+// scalar 16.16 per-pixel converter it replaced, at full size and at the
+// downscaled sizes YuvFrameHandle converts to.
+//
+//     yuv_convert_bench [--width W] [--height H] [--iterations N]
+//
+// Also checks that the full-size output stays within 1 LSB of the old path.
+
+#include "YuvConverter.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace {
+
+    // The converter before the SIMD rewrite, kept as the reference
+    namespace reference {
+        constexpr int kFractionBits = 16;
+        constexpr int32_t kRound = 1 << (kFractionBits - 1);
+
+        struct Coefficients
+        {
+            int32_t y_offset, y_scale, v_to_r, u_to_g, v_to_g, u_to_b;
+        };
+
+        int32_t toFixed(double value)
+        {
+            return static_cast<int32_t>(std::lround(value * (1 << kFractionBits)));
+        }
+
+        Coefficients bt709Limited()
+        {
+            const double kr = 0.2126;
+            const double kb = 0.0722;
+            const double kg = 1.0 - kr - kb;
+            const double cScale = 255.0 / 224.0;
+            return {16, toFixed(255.0 / 219.0), toFixed(2.0 * (1.0 - kr) * cScale),
+                    toFixed(2.0 * kb * (1.0 - kb) / kg * cScale), toFixed(2.0 * kr * (1.0 - kr) / kg * cScale),
+                    toFixed(2.0 * (1.0 - kb) * cScale)};
+        }
+
+        inline uint32_t clampChannel(int32_t value)
+        {
+            value >>= kFractionBits;
+            return static_cast<uint32_t>(std::clamp(value, 0, 255));
+        }
+
+        void convertNv12(const uint8_t* y, int yStride, const uint8_t* uv, int uvStride,
+                         int width, int height, uint8_t* dst, int dstStride, const Coefficients& c)
+        {
+            for (int row = 0; row < height; ++row) {
+                const uint8_t* yRow = y + row * yStride;
+                const uint8_t* uvRow = uv + (row >> 1) * uvStride;
+                auto* out = reinterpret_cast<uint32_t*>(dst + row * dstStride);
+                for (int x = 0; x < width; ++x) {
+                    const int32_t u = uvRow[2 * (x >> 1)] - 128;
+                    const int32_t v = uvRow[2 * (x >> 1) + 1] - 128;
+                    const int32_t ys = (yRow[x] - c.y_offset) * c.y_scale + kRound;
+                    const uint32_t r = clampChannel(ys + c.v_to_r * v);
+                    const uint32_t g = clampChannel(ys - c.u_to_g * u - c.v_to_g * v);
+                    const uint32_t b = clampChannel(ys + c.u_to_b * u);
+                    out[x] = 0xff000000u | (r << 16) | (g << 8) | b;
+                }
+            }
+        }
+    }
+
+    template <typename Convert>
+    double millisecondsPerFrame(int iterations, Convert&& convert)
+    {
+        convert();
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i)
+            convert();
+        const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count() / iterations;
+    }
+
+    int maxChannelDifference(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b)
+    {
+        int worst = 0;
+        for (std::size_t i = 0; i < a.size(); ++i) {
+            for (int shift = 0; shift < 24; shift += 8) {
+                const int ca = static_cast<int>((a[i] >> shift) & 0xff);
+                const int cb = static_cast<int>((b[i] >> shift) & 0xff);
+                worst = std::max(worst, std::abs(ca - cb));
+            }
+        }
+        return worst;
+    }
+
+    void usage(const char* program)
+    {
+        std::fprintf(stderr, "usage: %s [--width W] [--height H] [--iterations N]\n", program);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    int width = 1920;
+    int height = 1080;
+    int iterations = 100;
+
+    for (int i = 1; i < argc; ++i) {
+        int* target = nullptr;
+        if (std::strcmp(argv[i], "--width") == 0)
+            target = &width;
+        else if (std::strcmp(argv[i], "--height") == 0)
+            target = &height;
+        else if (std::strcmp(argv[i], "--iterations") == 0)
+            target = &iterations;
+        if (!target || i + 1 >= argc || (*target = std::atoi(argv[i + 1])) <= 0) {
+            usage(argv[0]);
+            return 2;
+        }
+        ++i;
+    }
+
+    // Noise rather than a flat picture, so no branch or clamp is predictable
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> byte(0, 255);
+    const int chromaWidth = (width + 1) / 2;
+    const int chromaHeight = (height + 1) / 2;
+    std::vector<uint8_t> luma(static_cast<std::size_t>(width) * height);
+    std::vector<uint8_t> chroma(static_cast<std::size_t>(chromaWidth) * 2 * chromaHeight);
+    for (auto& value : luma)
+        value = static_cast<uint8_t>(byte(rng));
+    for (auto& value : chroma)
+        value = static_cast<uint8_t>(byte(rng));
+
+    video::Yuv420Image src;
+    src.y = luma.data();
+    src.y_stride = width;
+    src.u = chroma.data();
+    src.u_stride = chromaWidth * 2;
+    src.v = chroma.data() + 1;
+    src.v_stride = chromaWidth * 2;
+    src.chroma_step = 2;
+    src.width = width;
+    src.height = height;
+
+    const video::YuvToRgbCoefficients coeffs = video::yuvToRgbCoefficients(video::YuvColorSpace::Bt709, false);
+    const reference::Coefficients oldCoeffs = reference::bt709Limited();
+
+    std::vector<uint32_t> expected(static_cast<std::size_t>(width) * height);
+    std::vector<uint32_t> actual(expected.size());
+    const int stride = width * 4;
+
+    const double oldMs = millisecondsPerFrame(iterations, [&]() {
+        reference::convertNv12(src.y, src.y_stride, src.u, src.u_stride, width, height,
+                               reinterpret_cast<uint8_t*>(expected.data()), stride, oldCoeffs);
+    });
+    std::printf("%dx%d NV12, %d iterations\n", width, height, iterations);
+    std::printf("  %-32s %8.3f ms\n", "scalar 16.16, full size", oldMs);
+
+    const double fullMs = millisecondsPerFrame(iterations, [&]() {
+        video::convertYuv420ToRgb32(src, reinterpret_cast<uint8_t*>(actual.data()), stride, width, height, coeffs);
+    });
+    std::printf("  %-32s %8.3f ms\n", "convertYuv420ToRgb32, full size", fullMs);
+
+    for (int divisor : {2, 4}) {
+        const int dstWidth = std::max(1, width / divisor);
+        const int dstHeight = std::max(1, height / divisor);
+        const double ms = millisecondsPerFrame(iterations, [&]() {
+            video::convertYuv420ToRgb32(src, reinterpret_cast<uint8_t*>(actual.data()), dstWidth * 4,
+                                        dstWidth, dstHeight, coeffs);
+        });
+        char label[64];
+        std::snprintf(label, sizeof(label), "convertYuv420ToRgb32, %dx%d", dstWidth, dstHeight);
+        std::printf("  %-32s %8.3f ms\n", label, ms);
+    }
+
+    video::convertYuv420ToRgb32(src, reinterpret_cast<uint8_t*>(actual.data()), stride, width, height, coeffs);
+    const int difference = maxChannelDifference(expected, actual);
+    std::printf("  max channel difference vs scalar 16.16: %d\n", difference);
+    return difference <= 1 ? 0 : 1;
+}
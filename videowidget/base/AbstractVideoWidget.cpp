@@ -1,16 +1,45 @@
 #include "AbstractVideoWidget.hpp"
+#include "GlVideoSurface.hpp"
 #include "IVideoFrameProvider.hpp"
 #include "LoggerMacros.hpp"
 
 #include <QPainter>
 #include <QPaintEvent>
+#include <QResizeEvent>
 #include <algorithm>
 
 using namespace video;
 
+bool AbstractVideoWidget::scaleQualityFromString(const QString& name, ScaleQuality& out)
+{
+    if (name == "fast") {
+        out = ScaleQuality::Fast;
+    } else if (name == "smooth") {
+        out = ScaleQuality::Smooth;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool AbstractVideoWidget::renderBackendFromString(const QString& name, RenderBackend& out)
+{
+    if (name == "raster") {
+        out = RenderBackend::Raster;
+    } else if (name == "opengl") {
+        out = RenderBackend::OpenGL;
+    } else {
+        return false;
+    }
+    return true;
+}
+
 AbstractVideoWidget::AbstractVideoWidget(QWidget* parent) 
     : QWidget(parent)
+    , m_pipeline(new FrameProcessingPipeline(this))
 {
+    connect(m_pipeline, &FrameProcessingPipeline::frameProcessed,
+            this, &AbstractVideoWidget::presentFrame);
     LOG_TRACE << "Abstract video widget created";
 }
 
@@ -67,6 +96,7 @@ void AbstractVideoWidget::stop()
     }
     LOG_INFO << "Stopping provider";
     m_provider->stop();
+    m_pipeline->clear();
 }
 
 void AbstractVideoWidget::pause()
@@ -135,6 +165,32 @@ int AbstractVideoWidget::processorCount() const
     return m_processors.size();
 }
 
+void AbstractVideoWidget::setAsyncProcessing(bool enabled)
+{
+    if (m_asyncProcessing == enabled)
+        return;
+
+    m_asyncProcessing = enabled;
+    if (!enabled)
+        m_pipeline->clear();
+    LOG_DEBUG << "Async frame processing " << (enabled ? "enabled" : "disabled");
+}
+
+bool AbstractVideoWidget::asyncProcessing() const
+{
+    return m_asyncProcessing;
+}
+
+void AbstractVideoWidget::setPipelineConfig(const FramePipelineConfig& config)
+{
+    m_pipeline->setConfig(config);
+}
+
+FramePipelineStats AbstractVideoWidget::pipelineStats() const
+{
+    return m_pipeline->stats();
+}
+
 FrameHandlePtr AbstractVideoWidget::lastFrameHandle() const
 {
     return m_lastFrame;
@@ -155,6 +211,7 @@ void AbstractVideoWidget::setAspectRatioMode(Qt::AspectRatioMode mode)
 
     m_aspectRatioMode = mode;
     LOG_DEBUG << "Aspect ratio mode changed to" << static_cast<int>(mode);
+    syncGlSurface();
     update(); 
 }
 
@@ -170,6 +227,7 @@ void AbstractVideoWidget::setMaintainAspectRatio(bool enabled)
 
     m_maintainAspectRatio = enabled;
     LOG_DEBUG << "Maintain aspect ratio changed to" << (enabled ? "true" : "false");
+    syncGlSurface();
     update();
 }
 
@@ -185,6 +243,7 @@ void AbstractVideoWidget::setBackgroundColor(const QColor& color)
 
     m_backgroundColor = color;
     LOG_DEBUG << "Background color changed";
+    syncGlSurface();
     update();
 }
 
@@ -193,6 +252,81 @@ QColor AbstractVideoWidget::backgroundColor() const
     return m_backgroundColor;
 }
 
+void AbstractVideoWidget::setScaleQuality(ScaleQuality quality)
+{
+    if (m_scaleQuality == quality)
+        return;
+
+    m_scaleQuality = quality;
+    LOG_DEBUG << "Scale quality changed to" << static_cast<int>(quality);
+    update();
+}
+
+AbstractVideoWidget::ScaleQuality AbstractVideoWidget::scaleQuality() const
+{
+    return m_scaleQuality;
+}
+
+void AbstractVideoWidget::setRenderBackend(RenderBackend backend)
+{
+    if (m_renderBackend == backend)
+        return;
+
+    m_renderBackend = backend;
+    if (backend == RenderBackend::OpenGL) {
+        m_glSurface = new GlVideoSurface(this);
+        m_glSurface->setGeometry(rect());
+        m_glSurface->setSnapshotSource(m_overlaySource);
+        m_glSurface->setOverlayPainter([this](QPainter& painter) { drawOverlay(painter); });
+        // Queued: the surface is still inside initializeGL() when it reports
+        connect(m_glSurface, &GlVideoSurface::initializationFailed,
+                this, &AbstractVideoWidget::onGlInitializationFailed, Qt::QueuedConnection);
+        syncGlSurface();
+        m_glSurface->setFrame(m_lastFrame);
+        m_glSurface->show();
+
+        // Textures are uploaded at full size and scaled by the GPU
+        if (m_provider)
+            m_provider->setOutputSizeHint(QSize());
+        m_scaledFrame = QImage();
+    } else if (m_glSurface) {
+        m_glSurface->hide();
+        m_glSurface->deleteLater();
+        m_glSurface = nullptr;
+    }
+
+    LOG_INFO << "Render backend: " << (backend == RenderBackend::OpenGL ? "opengl" : "raster");
+    emit renderBackendChanged(backend);
+    update();
+}
+
+AbstractVideoWidget::RenderBackend AbstractVideoWidget::renderBackend() const
+{
+    return m_renderBackend;
+}
+
+void AbstractVideoWidget::setOverlaySnapshotSource(const domain::SnapshotSource* source)
+{
+    m_overlaySource = source;
+    if (m_glSurface)
+        m_glSurface->setSnapshotSource(source);
+}
+
+void AbstractVideoWidget::syncGlSurface()
+{
+    if (!m_glSurface)
+        return;
+
+    m_glSurface->setKeepAspectRatio(m_maintainAspectRatio && m_aspectRatioMode == Qt::KeepAspectRatio);
+    m_glSurface->setBackgroundColor(m_backgroundColor);
+}
+
+void AbstractVideoWidget::onGlInitializationFailed(const QString& reason)
+{
+    LOG_WARN << "OpenGL backend unavailable (" << reason.toStdString() << "), falling back to raster";
+    setRenderBackend(RenderBackend::Raster);
+}
+
 void AbstractVideoWidget::setShowFps(bool show)
 {
     if (m_showFps == show)
@@ -276,22 +410,39 @@ void AbstractVideoWidget::onFrameReady(const FrameHandlePtr& frame)
     if (!frame || !frame->isValid()) {
         LOG_WARN << "Received invalid frame";
         m_lastFrame.reset();
+        m_scaledFrame = QImage();
+        if (m_glSurface)
+            m_glSurface->setFrame(m_lastFrame);
         update();
         return;
     }
 
-    m_lastFrame = frame;
-    ++m_totalFrames;
-    updateFpsCounter();
+    if (m_asyncProcessing && !m_processors.isEmpty()) {
+        // Shown from presentFrame() once the pipeline is done with it
+        m_pipeline->submit(frame, m_processors);
+        return;
+    }
 
     for (const auto& processor : m_processors) {
         if (processor) {
-            processor->processFrame(m_lastFrame);
+            processor->processFrame(frame);
         }
     }
 
+    presentFrame(frame);
+}
+
+void AbstractVideoWidget::presentFrame(const FrameHandlePtr& frame)
+{
+    m_lastFrame = frame;
+    ++m_totalFrames;
+    updateFpsCounter();
+
     emit frameUpdated(m_lastFrame);
-    update();
+    if (m_glSurface)
+        m_glSurface->setFrame(m_lastFrame);
+    else
+        update();
 }
 
 void AbstractVideoWidget::onProviderError(const QString& message)
@@ -312,6 +463,10 @@ void AbstractVideoWidget::paintEvent(QPaintEvent* event)
 {
     Q_UNUSED(event);
 
+    // Covered by the surface, which paints everything itself
+    if (m_glSurface)
+        return;
+
     QPainter p(this);
 
     if (!m_lastFrame || !m_lastFrame->isValid()) {
@@ -353,11 +508,59 @@ void AbstractVideoWidget::paintEvent(QPaintEvent* event)
         target = QRect(x, y, w, h);
     }
 
+    // Lets the provider hand over frames already at this size
+    if (m_provider)
+        m_provider->setOutputSizeHint(target.size() * devicePixelRatioF());
+
     p.fillRect(rect(), m_backgroundColor);
-    p.drawImage(target, img);
+
+    const QSize deviceSize = target.size() * devicePixelRatioF();
+    if (img.size() == deviceSize || deviceSize.isEmpty()) {
+        p.drawImage(target, img);
+    } else {
+        // Repaints of the same frame at the same size are a plain blit
+        p.drawImage(target.topLeft(), scaledFrame(img, deviceSize, devicePixelRatioF()));
+    }
     drawOverlay(p);
 }
 
+void AbstractVideoWidget::resizeEvent(QResizeEvent* event)
+{
+    QWidget::resizeEvent(event);
+    if (m_glSurface)
+        m_glSurface->setGeometry(rect());
+}
+
+const QImage& AbstractVideoWidget::scaledFrame(const QImage& image, const QSize& size, qreal devicePixelRatio)
+{
+    const qint64 key = image.cacheKey();
+    if (key == m_scaledFrameKey && m_scaledFrame.size() == size && m_scaledFrameQuality == m_scaleQuality) {
+        m_scaledFrame.setDevicePixelRatio(devicePixelRatio);
+        return m_scaledFrame;
+    }
+
+    if (m_scaleQuality == ScaleQuality::Smooth) {
+        m_scaledFrame = image.scaled(size, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+    } else {
+        // Nearest-neighbour into the buffer kept from the previous frame
+        const QImage::Format format = image.hasAlphaChannel() ? QImage::Format_ARGB32_Premultiplied
+                                                              : QImage::Format_RGB32;
+        if (m_scaledFrame.size() != size || m_scaledFrame.format() != format)
+            m_scaledFrame = QImage(size, format);
+
+        // Paint in plain device pixels
+        m_scaledFrame.setDevicePixelRatio(1.0);
+        QPainter painter(&m_scaledFrame);
+        painter.setCompositionMode(QPainter::CompositionMode_Source);
+        painter.drawImage(QRect(QPoint(0, 0), size), image);
+    }
+
+    m_scaledFrame.setDevicePixelRatio(devicePixelRatio);
+    m_scaledFrameKey = key;
+    m_scaledFrameQuality = m_scaleQuality;
+    return m_scaledFrame;
+}
+
 void AbstractVideoWidget::drawOverlay(QPainter& painter)
 {
     if (!m_showFps)
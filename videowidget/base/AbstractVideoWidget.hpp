@@ -8,14 +8,40 @@
 
 #include "IVideoFrameProcessor.hpp"
 #include "IVideoFrameProvider.hpp"
+#include "FrameProcessingPipeline.hpp"
 
+namespace domain {
+    class SnapshotSource;
+}
 
 namespace video {
+    class GlVideoSurface;
+
     class AbstractVideoWidget : public QWidget
     {
         Q_OBJECT
 
     public:
+        // качество масштабирования кадра под размер виджета
+        enum class ScaleQuality
+        {
+            Fast,       // ближайший пиксель
+            Smooth      // усреднение по площади (QImage::scaled)
+        };
+        Q_ENUM(ScaleQuality)
+
+        static bool scaleQualityFromString(const QString& name, ScaleQuality& out);
+
+        // чем рисуется кадр
+        enum class RenderBackend
+        {
+            Raster,     // QPainter, конвертация YUV на CPU
+            OpenGL      // GlVideoSurface, конвертация YUV в шейдере
+        };
+        Q_ENUM(RenderBackend)
+
+        static bool renderBackendFromString(const QString& name, RenderBackend& out);
+
         explicit AbstractVideoWidget(QWidget* parent = nullptr);
         ~AbstractVideoWidget() override;
 
@@ -37,6 +63,13 @@ namespace video {
         void clearFrameProcessors();
         [[nodiscard]] int processorCount() const;
 
+        // асинхронная обработка: процессоры выполняются в пуле потоков,
+        // кадр показывается после их завершения (в порядке поступления)
+        void setAsyncProcessing(bool enabled);
+        [[nodiscard]] bool asyncProcessing() const;
+        void setPipelineConfig(const FramePipelineConfig& config);
+        [[nodiscard]] FramePipelineStats pipelineStats() const;
+
         // доступ к последнему кадру
         [[nodiscard]] FrameHandlePtr lastFrameHandle() const;
         [[nodiscard]] QImage lastFrameImage() const;
@@ -51,6 +84,18 @@ namespace video {
         void setBackgroundColor(const QColor& color);
         [[nodiscard]] QColor backgroundColor() const;
 
+        // масштабированный кадр кэшируется, пока не сменится кадр или размер
+        void setScaleQuality(ScaleQuality quality);
+        [[nodiscard]] ScaleQuality scaleQuality() const;
+
+        // при недоступном OpenGL виджет сам возвращается к Raster
+        void setRenderBackend(RenderBackend backend);
+        [[nodiscard]] RenderBackend renderBackend() const;
+
+        // разметка для OpenGL: рисуется из снимка домена при показе кадра,
+        // без MarkingOverlayProcessor
+        void setOverlaySnapshotSource(const domain::SnapshotSource* source);
+
         // FPS и статистика
         void setShowFps(bool show);
         [[nodiscard]] bool showFps() const;
@@ -66,10 +111,21 @@ namespace video {
         IVideoFrameProvider* m_provider = nullptr;
         FrameHandlePtr m_lastFrame;
         QVector<FrameProcessorPtr> m_processors;
+        FrameProcessingPipeline* m_pipeline = nullptr;
+        bool m_asyncProcessing = false;
         Qt::AspectRatioMode m_aspectRatioMode = Qt::KeepAspectRatio;
         bool m_maintainAspectRatio = true;
         QColor m_backgroundColor = Qt::black;
 
+        ScaleQuality m_scaleQuality = ScaleQuality::Fast;
+        QImage m_scaledFrame;
+        qint64 m_scaledFrameKey = 0;        // QImage::cacheKey() of the source
+        ScaleQuality m_scaledFrameQuality = ScaleQuality::Fast;
+
+        RenderBackend m_renderBackend = RenderBackend::Raster;
+        GlVideoSurface* m_glSurface = nullptr;
+        const domain::SnapshotSource* m_overlaySource = nullptr;
+
         bool m_showFps = false;
         QElapsedTimer m_fpsTimer;
         int m_frameCounter = 0;
@@ -77,12 +133,17 @@ namespace video {
         int64_t m_totalFrames = 0;
 
         void updateFpsCounter();
+        void presentFrame(const FrameHandlePtr& frame);
+        const QImage& scaledFrame(const QImage& image, const QSize& size, qreal devicePixelRatio);
+        void syncGlSurface();
+        void onGlInitializationFailed(const QString& reason);
 
     signals:
         void frameUpdated(const FrameHandlePtr& frame);
         void errorOccurred(const QString& message);
         void providerStateChanged(IVideoFrameProvider::ProviderState state);
         void fpsChanged(double fps);
+        void renderBackendChanged(RenderBackend backend);
 
     private slots:
         void onFrameReady(const FrameHandlePtr& frame);
@@ -91,6 +152,7 @@ namespace video {
 
     protected:
         void paintEvent(QPaintEvent* event) override;
+        void resizeEvent(QResizeEvent* event) override;
         virtual void drawOverlay(QPainter& painter);
 
     };
@@ -0,0 +1,147 @@
+#include "FrameProcessingPipeline.hpp"
+#include "LoggerMacros.hpp"
+
+#include <QMetaObject>
+#include <algorithm>
+#include <exception>
+#include <utility>
+#include <vector>
+
+using namespace video;
+
+FrameProcessingPipeline::FrameProcessingPipeline(QObject* parent)
+    : QObject(parent)
+{
+    m_pool.setMaxThreadCount(m_config.worker_count);
+    m_lateTimer.setSingleShot(true);
+    connect(&m_lateTimer, &QTimer::timeout, this, &FrameProcessingPipeline::flush);
+
+    LOG_TRACE << "FrameProcessingPipeline created";
+}
+
+FrameProcessingPipeline::~FrameProcessingPipeline()
+{
+    // Workers post their completion back to this object; finish them first
+    m_pool.clear();
+    m_pool.waitForDone();
+    LOG_TRACE << "FrameProcessingPipeline destroyed";
+}
+
+void FrameProcessingPipeline::setConfig(const FramePipelineConfig& config)
+{
+    m_config.worker_count = std::max(1, config.worker_count);
+    m_config.max_in_flight = std::max(1, config.max_in_flight);
+    m_config.late_threshold_ms = std::max(0, config.late_threshold_ms);
+    m_pool.setMaxThreadCount(m_config.worker_count);
+
+    LOG_DEBUG << "Frame pipeline configured: workers=" << m_config.worker_count
+              << ", max_in_flight=" << m_config.max_in_flight
+              << ", late_threshold=" << m_config.late_threshold_ms << "ms";
+}
+
+FramePipelineConfig FrameProcessingPipeline::config() const
+{
+    return m_config;
+}
+
+bool FrameProcessingPipeline::submit(const FrameHandlePtr& frame, const QVector<FrameProcessorPtr>& processors)
+{
+    if (!frame)
+        return false;
+
+    if (m_running >= m_config.max_in_flight ||
+        static_cast<int>(m_pending.size()) >= m_config.max_in_flight) {
+        ++m_stats.dropped_backpressure;
+        LOG_TRACE << "Frame pipeline full, frame dropped";
+        return false;
+    }
+
+    std::vector<IVideoFrameProcessor::FrameTask> tasks;
+    tasks.reserve(static_cast<std::size_t>(processors.size()));
+    for (const auto& processor : processors) {
+        if (!processor)
+            continue;
+        if (auto task = processor->prepareFrameTask())
+            tasks.push_back(std::move(task));
+    }
+
+    const quint64 seq = m_nextSeq++;
+    Pending& pending = m_pending[seq];
+    pending.frame = frame;
+    pending.started.start();
+
+    ++m_running;
+    ++m_stats.submitted;
+
+    // The processors are captured so the tasks never outlive what they point into
+    m_pool.start([this, seq, frame, processors, tasks = std::move(tasks)]() {
+        for (const auto& task : tasks) {
+            try {
+                task(frame);
+            } catch (const std::exception& e) {
+                LOG_ERROR << "Exception in frame processor task: " << e.what();
+            }
+        }
+        QMetaObject::invokeMethod(this, [this, seq]() { onTaskFinished(seq); }, Qt::QueuedConnection);
+    });
+    return true;
+}
+
+void FrameProcessingPipeline::clear()
+{
+    m_lateTimer.stop();
+    m_pending.clear();
+}
+
+FramePipelineStats FrameProcessingPipeline::stats() const
+{
+    FramePipelineStats stats = m_stats;
+    stats.in_flight = std::max(m_running, static_cast<int>(m_pending.size()));
+    return stats;
+}
+
+void FrameProcessingPipeline::onTaskFinished(quint64 seq)
+{
+    --m_running;
+
+    auto it = m_pending.find(seq);
+    if (it == m_pending.end())
+        return;     // skipped as late or cleared meanwhile
+
+    it->second.done = true;
+    flush();
+}
+
+void FrameProcessingPipeline::flush()
+{
+    m_lateTimer.stop();
+
+    while (!m_pending.empty()) {
+        auto head = m_pending.begin();
+        if (head->second.done) {
+            FrameHandlePtr frame = std::move(head->second.frame);
+            m_pending.erase(head);
+            ++m_stats.delivered;
+            emit frameProcessed(frame);
+            continue;
+        }
+
+        auto firstDone = std::find_if(head, m_pending.end(),
+                                      [](const auto& entry) { return entry.second.done; });
+        if (firstDone == m_pending.end())
+            break;
+
+        const qint64 waited = head->second.started.elapsed();
+        if (waited < m_config.late_threshold_ms) {
+            m_lateTimer.start(static_cast<int>(m_config.late_threshold_ms - waited));
+            break;
+        }
+
+        // Newer frames are ready and the older ones are late: skip them
+        for (auto it = head; it != firstDone; ) {
+            ++m_stats.dropped_late;
+            it = m_pending.erase(it);
+        }
+        LOG_TRACE << "Frame pipeline skipped late frames, total=" << m_stats.dropped_late;
+    }
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <QObject>
+#include <QThreadPool>
+#include <QTimer>
+#include <QVector>
+#include <QElapsedTimer>
+#include <map>
+
+#include "IVideoFrameProcessor.hpp"
+
+namespace video {
+
+    struct FramePipelineConfig
+    {
+        int worker_count = 2;
+        int max_in_flight = 3;          // frames submitted but not yet delivered
+        int late_threshold_ms = 100;    // head-of-line frame skipped after this
+    };
+
+    struct FramePipelineStats
+    {
+        quint64 submitted = 0;
+        quint64 delivered = 0;
+        quint64 dropped_backpressure = 0;   // rejected because max_in_flight was reached
+        quint64 dropped_late = 0;           // overtaken by newer frames and skipped
+        int in_flight = 0;
+    };
+
+    // Runs frame processors on a worker pool and hands frames back to the GUI
+    // thread in submission order.
+    //
+    // submit() and everything else must be called from the thread the pipeline
+    // lives on. For each frame every processor's prepareFrameTask() is called
+    // there, so processors can capture GUI-side state; the returned tasks then
+    // run one after another on a worker. frameProcessed() is never emitted for
+    // a frame older than one already delivered: if the oldest frame is still
+    // running after late_threshold_ms while newer ones are done, it is skipped.
+    class FrameProcessingPipeline : public QObject
+    {
+        Q_OBJECT
+
+    public:
+        explicit FrameProcessingPipeline(QObject* parent = nullptr);
+        ~FrameProcessingPipeline() override;
+
+        void setConfig(const FramePipelineConfig& config);
+        [[nodiscard]] FramePipelineConfig config() const;
+
+        // Returns false if the frame was dropped because the pipeline is full
+        bool submit(const FrameHandlePtr& frame, const QVector<FrameProcessorPtr>& processors);
+
+        // Forgets every frame in flight; their results are discarded
+        void clear();
+
+        [[nodiscard]] FramePipelineStats stats() const;
+
+    signals:
+        void frameProcessed(const FrameHandlePtr& frame);
+
+    private:
+        struct Pending
+        {
+            FrameHandlePtr frame;
+            QElapsedTimer started;
+            bool done = false;
+        };
+
+        QThreadPool m_pool;
+        QTimer m_lateTimer;
+        FramePipelineConfig m_config;
+
+        std::map<quint64, Pending> m_pending;
+        quint64 m_nextSeq = 0;
+        int m_running = 0;
+        FramePipelineStats m_stats;
+
+        void onTaskFinished(quint64 seq);
+        void flush();
+    };
+
+} // namespace video
@@ -0,0 +1,578 @@
+#include "GlVideoSurface.hpp"
+#include "MarkingOverlayProcessor.hpp"
+#include "YuvFrameHandle.hpp"
+#include "LoggerMacros.hpp"
+
+#include <QFontMetrics>
+#include <QOpenGLContext>
+#include <QPainter>
+#include <QSurfaceFormat>
+#include <QVector2D>
+#include <QVector4D>
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+
+using namespace video;
+
+namespace {
+
+    const char* const kVideoVertexShader = R"(
+layout(location = 0) in vec2 a_corner;
+uniform vec4 u_rect;
+out vec2 v_uv;
+void main()
+{
+    v_uv = a_corner;
+    gl_Position = vec4(mix(u_rect.xy, u_rect.zw, a_corner), 0.0, 1.0);
+}
+)";
+
+    // Same arithmetic as YuvConverter, in floating point
+    const char* const kVideoFragmentShader = R"(
+in vec2 v_uv;
+out vec4 fragColor;
+uniform int u_mode;
+uniform sampler2D u_plane0;
+uniform sampler2D u_plane1;
+uniform sampler2D u_plane2;
+uniform float u_yOffset;
+uniform float u_yScale;
+uniform vec4 u_chroma;      // v_to_r, u_to_g, v_to_g, u_to_b
+void main()
+{
+    if (u_mode == 0) {
+        // RGB32 is B, G, R, X in memory and uploaded as RGBA
+        fragColor = vec4(texture(u_plane0, v_uv).bgr, 1.0);
+        return;
+    }
+    float ys = (texture(u_plane0, v_uv).r * 255.0 - u_yOffset) * u_yScale;
+    vec2 c = u_mode == 1 ? texture(u_plane1, v_uv).rg
+                         : vec2(texture(u_plane1, v_uv).r, texture(u_plane2, v_uv).r);
+    c = c * 255.0 - 128.0;
+    vec3 rgb = vec3(ys + u_chroma.x * c.y,
+                    ys - u_chroma.y * c.x - u_chroma.z * c.y,
+                    ys + u_chroma.w * c.x);
+    fragColor = vec4(clamp(rgb / 255.0, 0.0, 1.0), 1.0);
+}
+)";
+
+    const char* const kOverlayVertexShader = R"(
+layout(location = 0) in vec2 a_corner;
+layout(location = 1) in vec4 a_rect;
+layout(location = 2) in vec4 a_color;
+layout(location = 3) in float a_shape;
+uniform vec4 u_rect;
+uniform vec2 u_frameSize;
+out vec2 v_local;
+out vec2 v_pixel;
+out vec4 v_color;
+flat out float v_shape;
+void main()
+{
+    vec2 pixel = a_rect.xy + a_corner * a_rect.zw;
+    gl_Position = vec4(mix(u_rect.xy, u_rect.zw, pixel / u_frameSize), 0.0, 1.0);
+    v_local = a_corner * 2.0 - 1.0;
+    v_pixel = a_corner * a_rect.zw;
+    v_color = a_color;
+    v_shape = a_shape;
+}
+)";
+
+    const char* const kOverlayFragmentShader = R"(
+in vec2 v_local;
+in vec2 v_pixel;
+in vec4 v_color;
+flat in float v_shape;
+out vec4 fragColor;
+void main()
+{
+    float alpha = v_color.a;
+    if (v_shape > 1.5) {
+        // Qt::DashLine at width 2: 8 px dash, 4 px gap
+        if (mod(v_pixel.y, 12.0) >= 8.0)
+            discard;
+    } else if (v_shape > 0.5) {
+        float r = length(v_local);
+        alpha *= 1.0 - smoothstep(1.0 - fwidth(r), 1.0, r);
+        if (alpha <= 0.0)
+            discard;
+    }
+    fragColor = vec4(v_color.rgb, alpha);
+}
+)";
+
+    constexpr float kLaneLineWidth = 3.0f;
+    constexpr float kCenterLineWidth = 2.0f;
+    constexpr float kMarkingRadius = 9.0f;      // 8 px disc plus half the 2 px outline
+
+    // Unit quad as a triangle strip
+    constexpr GLfloat kQuad[] = {0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f};
+
+    QVector4D toNdc(const QRectF& rect, const QSize& viewport)
+    {
+        const float w = static_cast<float>(viewport.width());
+        const float h = static_cast<float>(viewport.height());
+        return QVector4D(2.0f * static_cast<float>(rect.left()) / w - 1.0f,
+                         1.0f - 2.0f * static_cast<float>(rect.top()) / h,
+                         2.0f * static_cast<float>(rect.left() + rect.width()) / w - 1.0f,
+                         1.0f - 2.0f * static_cast<float>(rect.top() + rect.height()) / h);
+    }
+
+    // Same mapping as MarkingOverlayProcessor: 10 m across the frame width,
+    // vehicle at the bottom centre
+    QPointF worldToFrame(float x, float y, const QSize& frameSize)
+    {
+        const float pixelsPerMeter = frameSize.width() / 10.0f;
+        const int centerX = frameSize.width() / 2;
+        const int bottomY = frameSize.height();
+        return QPointF(centerX + static_cast<int>(y * pixelsPerMeter),
+                       bottomY - static_cast<int>(x * pixelsPerMeter));
+    }
+}
+
+GlVideoSurface::GlVideoSurface(QWidget* parent)
+    : QOpenGLWidget(parent)
+    , m_laneFont("Arial", 10)
+    , m_markingFont("Arial", 8)
+    , m_warningFont("Arial", 11, QFont::Bold)
+{
+    QSurfaceFormat surfaceFormat = QSurfaceFormat::defaultFormat();
+    if (QOpenGLContext::openGLModuleType() == QOpenGLContext::LibGL) {
+        surfaceFormat.setVersion(3, 3);
+        surfaceFormat.setProfile(QSurfaceFormat::CoreProfile);
+    } else {
+        surfaceFormat.setVersion(3, 0);
+    }
+    setFormat(surfaceFormat);
+
+    m_instances.reserve(64);
+    LOG_TRACE << "GlVideoSurface created";
+}
+
+GlVideoSurface::~GlVideoSurface()
+{
+    cleanup();
+    LOG_TRACE << "GlVideoSurface destroyed";
+}
+
+void GlVideoSurface::setFrame(const FrameHandlePtr& frame)
+{
+    m_frame = frame;
+    m_frameDirty = true;
+    if (!m_frame)
+        m_frameSize = QSize();
+    update();
+}
+
+void GlVideoSurface::setKeepAspectRatio(bool keep)
+{
+    m_keepAspectRatio = keep;
+    update();
+}
+
+void GlVideoSurface::setBackgroundColor(const QColor& color)
+{
+    m_backgroundColor = color;
+    update();
+}
+
+void GlVideoSurface::setSnapshotSource(const domain::SnapshotSource* source)
+{
+    m_snapshotSource = source;
+    update();
+}
+
+void GlVideoSurface::setOverlayPainter(std::function<void(QPainter&)> painter)
+{
+    m_overlayPainter = std::move(painter);
+    update();
+}
+
+void GlVideoSurface::initializeGL()
+{
+    initializeOpenGLFunctions();
+    connect(context(), &QOpenGLContext::aboutToBeDestroyed,
+            this, &GlVideoSurface::cleanup, Qt::UniqueConnection);
+
+    const QSurfaceFormat actual = context()->format();
+    const bool supported = context()->isOpenGLES()
+        ? actual.majorVersion() >= 3
+        : actual.version() >= qMakePair(3, 3);
+    if (!supported) {
+        const QString reason = QString("OpenGL %1.%2 context; 3.3 or ES 3.0 required")
+                                   .arg(actual.majorVersion()).arg(actual.minorVersion());
+        LOG_ERROR << "GlVideoSurface: " << reason.toStdString();
+        emit initializationFailed(reason);
+        return;
+    }
+
+    QString error;
+    if (!buildPrograms(error)) {
+        LOG_ERROR << "GlVideoSurface: " << error.toStdString();
+        emit initializationFailed(error);
+        return;
+    }
+
+    m_quadBuffer.create();
+    m_quadBuffer.bind();
+    m_quadBuffer.allocate(kQuad, sizeof(kQuad));
+    m_quadBuffer.release();
+
+    m_instanceBuffer.setUsagePattern(QOpenGLBuffer::StreamDraw);
+    m_instanceBuffer.create();
+
+    m_videoVao = std::make_unique<QOpenGLVertexArrayObject>();
+    m_videoVao->create();
+    m_videoVao->bind();
+    m_quadBuffer.bind();
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
+    m_quadBuffer.release();
+    m_videoVao->release();
+
+    m_overlayVao = std::make_unique<QOpenGLVertexArrayObject>();
+    m_overlayVao->create();
+    m_overlayVao->bind();
+    m_quadBuffer.bind();
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
+    m_instanceBuffer.bind();
+    const auto stride = static_cast<GLsizei>(sizeof(Instance));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<const void*>(offsetof(Instance, rect)));
+    glVertexAttribDivisor(1, 1);
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<const void*>(offsetof(Instance, color)));
+    glVertexAttribDivisor(2, 1);
+    glEnableVertexAttribArray(3);
+    glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<const void*>(offsetof(Instance, shape)));
+    glVertexAttribDivisor(3, 1);
+    m_instanceBuffer.release();
+    m_quadBuffer.release();
+    m_overlayVao->release();
+
+    glGenTextures(3, m_textures);
+    for (GLuint texture : m_textures) {
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+    for (auto& size : m_textureSizes)
+        size = QSize();
+
+    m_ready = true;
+    m_frameDirty = true;
+    LOG_INFO << "OpenGL video surface ready: "
+             << reinterpret_cast<const char*>(glGetString(GL_RENDERER))
+             << ", " << reinterpret_cast<const char*>(glGetString(GL_VERSION));
+}
+
+bool GlVideoSurface::buildPrograms(QString& error)
+{
+    const QByteArray header = context()->isOpenGLES()
+        ? QByteArrayLiteral("#version 300 es\nprecision highp float;\n")
+        : QByteArrayLiteral("#version 330 core\n");
+
+    auto build = [&](std::unique_ptr<QOpenGLShaderProgram>& program, const char* vertex, const char* fragment) {
+        program = std::make_unique<QOpenGLShaderProgram>();
+        if (!program->addShaderFromSourceCode(QOpenGLShader::Vertex, header + vertex) ||
+            !program->addShaderFromSourceCode(QOpenGLShader::Fragment, header + fragment) ||
+            !program->link()) {
+            error = "Shader build failed: " + program->log();
+            return false;
+        }
+        return true;
+    };
+
+    if (!build(m_videoProgram, kVideoVertexShader, kVideoFragmentShader) ||
+        !build(m_overlayProgram, kOverlayVertexShader, kOverlayFragmentShader))
+        return false;
+
+    m_videoProgram->bind();
+    m_videoProgram->setUniformValue("u_plane0", 0);
+    m_videoProgram->setUniformValue("u_plane1", 1);
+    m_videoProgram->setUniformValue("u_plane2", 2);
+    m_videoProgram->release();
+    return true;
+}
+
+void GlVideoSurface::cleanup()
+{
+    if (!isValid())
+        return;
+
+    makeCurrent();
+    m_videoVao.reset();
+    m_overlayVao.reset();
+    m_videoProgram.reset();
+    m_overlayProgram.reset();
+    m_quadBuffer.destroy();
+    m_instanceBuffer.destroy();
+    if (m_textures[0] != 0) {
+        glDeleteTextures(3, m_textures);
+        m_textures[0] = m_textures[1] = m_textures[2] = 0;
+    }
+    m_ready = false;
+    doneCurrent();
+}
+
+void GlVideoSurface::paintGL()
+{
+    glClearColor(static_cast<GLfloat>(m_backgroundColor.redF()),
+                 static_cast<GLfloat>(m_backgroundColor.greenF()),
+                 static_cast<GLfloat>(m_backgroundColor.blueF()), 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    if (!m_ready)
+        return;
+
+    if (m_frame && m_frameDirty) {
+        m_frameDirty = false;
+        if (!uploadFrame())
+            m_frameSize = QSize();
+    }
+
+    QRectF target;
+    domain::DomainSnapshotPtr snapshot;
+    if (!m_frameSize.isEmpty()) {
+        target = targetRect();
+        drawVideo(target);
+
+        if (m_snapshotSource) {
+            snapshot = m_snapshotSource->snapshotFor(static_cast<std::uint64_t>(std::max<int64_t>(m_frame->timestamp(), 0)));
+            if (snapshot)
+                drawOverlayGeometry(target, *snapshot);
+        }
+    }
+
+    if (!snapshot && !m_overlayPainter && !m_frameSize.isEmpty())
+        return;
+
+    QPainter painter(this);
+    if (m_frameSize.isEmpty()) {
+        painter.setPen(Qt::gray);
+        painter.setFont(QFont("Arial", 24, QFont::Bold));
+        painter.drawText(rect(), Qt::AlignCenter, "NO VIDEO");
+    }
+    if (snapshot)
+        drawOverlayLabels(painter, target, *snapshot);
+    if (m_overlayPainter)
+        m_overlayPainter(painter);
+}
+
+bool GlVideoSurface::uploadFrame()
+{
+    if (const auto* yuv = dynamic_cast<const YuvFrameHandle*>(m_frame.data())) {
+        const bool uploaded = yuv->withPlanes([this](const Yuv420Image& planes, const YuvToRgbCoefficients& coeffs) {
+            const int chromaWidth = (planes.width + 1) / 2;
+            const int chromaHeight = (planes.height + 1) / 2;
+
+            uploadPlane(0, GL_R8, GL_RED, planes.width, planes.height, planes.y, planes.y_stride);
+            if (planes.chroma_step == 2) {
+                uploadPlane(1, GL_RG8, GL_RG, chromaWidth, chromaHeight, planes.u, planes.u_stride / 2);
+                m_textureMode = TextureMode::Nv12;
+            } else {
+                uploadPlane(1, GL_R8, GL_RED, chromaWidth, chromaHeight, planes.u, planes.u_stride);
+                uploadPlane(2, GL_R8, GL_RED, chromaWidth, chromaHeight, planes.v, planes.v_stride);
+                m_textureMode = TextureMode::Yuv420p;
+            }
+            m_coefficients = coeffs;
+            m_frameSize = QSize(planes.width, planes.height);
+        });
+        if (uploaded)
+            return true;
+    }
+
+    QImage image = m_frame->image();
+    if (image.isNull())
+        return false;
+
+    if (image.format() != QImage::Format_RGB32 &&
+        image.format() != QImage::Format_ARGB32 &&
+        image.format() != QImage::Format_ARGB32_Premultiplied) {
+        image = image.convertToFormat(QImage::Format_RGB32);
+    }
+
+    uploadPlane(0, GL_RGBA8, GL_RGBA, image.width(), image.height(), image.constBits(),
+                static_cast<int>(image.bytesPerLine() / 4));
+    m_textureMode = TextureMode::Rgb32;
+    m_frameSize = image.size();
+    return true;
+}
+
+void GlVideoSurface::uploadPlane(int index, GLenum internalFormat, GLenum format,
+                                 int width, int height, const uchar* data, int rowLength)
+{
+    glBindTexture(GL_TEXTURE_2D, m_textures[index]);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, rowLength);
+
+    const QSize size(width, height);
+    if (m_textureSizes[index] != size || m_textureFormats[index] != internalFormat) {
+        glTexImage2D(GL_TEXTURE_2D, 0, static_cast<GLint>(internalFormat), width, height, 0,
+                     format, GL_UNSIGNED_BYTE, data);
+        m_textureSizes[index] = size;
+        m_textureFormats[index] = internalFormat;
+    } else {
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, format, GL_UNSIGNED_BYTE, data);
+    }
+
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+QRectF GlVideoSurface::targetRect() const
+{
+    const QRectF area = rect();
+    if (!m_keepAspectRatio || m_frameSize.isEmpty())
+        return area;
+
+    const double s = std::min(area.width() / m_frameSize.width(), area.height() / m_frameSize.height());
+    const double w = m_frameSize.width() * s;
+    const double h = m_frameSize.height() * s;
+    return QRectF(area.x() + (area.width() - w) / 2, area.y() + (area.height() - h) / 2, w, h);
+}
+
+void GlVideoSurface::drawVideo(const QRectF& target)
+{
+    m_videoProgram->bind();
+    m_videoProgram->setUniformValue("u_rect", toNdc(target, size()));
+    m_videoProgram->setUniformValue("u_mode", static_cast<int>(m_textureMode));
+
+    const int planes = m_textureMode == TextureMode::Yuv420p ? 3 : (m_textureMode == TextureMode::Nv12 ? 2 : 1);
+    for (int i = 0; i < planes; ++i) {
+        glActiveTexture(GL_TEXTURE0 + i);
+        glBindTexture(GL_TEXTURE_2D, m_textures[i]);
+    }
+
+    if (m_textureMode != TextureMode::Rgb32) {
+        const float scale = 1.0f / static_cast<float>(1 << YuvToRgbCoefficients::fraction_bits);
+        m_videoProgram->setUniformValue("u_yOffset", static_cast<GLfloat>(m_coefficients.y_offset));
+        m_videoProgram->setUniformValue("u_yScale", m_coefficients.y_scale * scale);
+        m_videoProgram->setUniformValue("u_chroma", QVector4D(m_coefficients.v_to_r * scale,
+                                                              m_coefficients.u_to_g * scale,
+                                                              m_coefficients.v_to_g * scale,
+                                                              m_coefficients.u_to_b * scale));
+    }
+
+    m_videoVao->bind();
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    m_videoVao->release();
+
+    for (int i = planes - 1; i >= 0; --i) {
+        glActiveTexture(GL_TEXTURE0 + i);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+    m_videoProgram->release();
+}
+
+void GlVideoSurface::drawOverlayGeometry(const QRectF& target, const domain::DomainSnapshot& snapshot)
+{
+    m_instances.clear();
+
+    const QSize& frame = m_frameSize;
+    auto add = [this](float x, float y, float w, float h, const QColor& color, float shape) {
+        m_instances.push_back({{x, y, w, h},
+                               {static_cast<float>(color.redF()), static_cast<float>(color.greenF()),
+                                static_cast<float>(color.blueF()), static_cast<float>(color.alphaF())},
+                               shape});
+    };
+
+    const domain::LaneState& lane = snapshot.lane;
+    if (lane.isValid()) {
+        const int centerX = frame.width() / 2;
+        const float topY = static_cast<float>(frame.height() / 2);
+        const float height = static_cast<float>(frame.height()) - topY;
+        const float pixelsPerMeter = frame.width() / 10.0f;
+
+        const float leftX = static_cast<float>(centerX + static_cast<int>(lane.leftOffsetMeters() * pixelsPerMeter));
+        const float rightX = static_cast<float>(centerX + static_cast<int>(lane.rightOffsetMeters() * pixelsPerMeter));
+        const float centerLineX = static_cast<float>(centerX + static_cast<int>(lane.centerOffsetMeters() * pixelsPerMeter));
+
+        add(leftX - kLaneLineWidth / 2, topY, kLaneLineWidth, height, Qt::green, 0.0f);
+        add(rightX - kLaneLineWidth / 2, topY, kLaneLineWidth, height, Qt::green, 0.0f);
+        add(centerLineX - kCenterLineWidth / 2, topY, kCenterLineWidth, height, Qt::yellow, 2.0f);
+    }
+
+    for (const auto& marking : snapshot.markings) {
+        const QPointF pos = worldToFrame(marking.xMeters(), marking.yMeters(), frame);
+        const QColor color = marking.isCrosswalk() ? Qt::cyan : (marking.isArrow() ? Qt::magenta : Qt::blue);
+        add(static_cast<float>(pos.x()) - kMarkingRadius, static_cast<float>(pos.y()) - kMarkingRadius,
+            2 * kMarkingRadius, 2 * kMarkingRadius, color, 1.0f);
+    }
+
+    if (m_instances.empty())
+        return;
+
+    m_instanceBuffer.bind();
+    m_instanceBuffer.allocate(m_instances.data(), static_cast<int>(m_instances.size() * sizeof(Instance)));
+    m_instanceBuffer.release();
+
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    m_overlayProgram->bind();
+    m_overlayProgram->setUniformValue("u_rect", toNdc(target, size()));
+    m_overlayProgram->setUniformValue("u_frameSize", QVector2D(frame.width(), frame.height()));
+    m_overlayVao->bind();
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, static_cast<GLsizei>(m_instances.size()));
+    m_overlayVao->release();
+    m_overlayProgram->release();
+
+    glDisable(GL_BLEND);
+}
+
+void GlVideoSurface::drawOverlayLabels(QPainter& painter, const QRectF& target, const domain::DomainSnapshot& snapshot)
+{
+    const QSize& frame = m_frameSize;
+    const double sx = target.width() / frame.width();
+    const double sy = target.height() / frame.height();
+    auto toWidget = [&](double x, double y) { return QPointF(target.x() + x * sx, target.y() + y * sy); };
+
+    painter.setPen(Qt::white);
+
+    const domain::LaneState& lane = snapshot.lane;
+    if (lane.isValid()) {
+        const int qualityPercent = static_cast<int>((lane.qualityRaw() * 100) / 255);
+        painter.setFont(m_laneFont);
+        painter.drawText(toWidget(10, 20), QString("Lane Width: %1m").arg(lane.laneWidthMeters(), 0, 'f', 2));
+        painter.drawText(toWidget(10, 35), QString("Quality: %1%").arg(qualityPercent));
+    }
+
+    painter.setFont(m_markingFont);
+    for (const auto& marking : snapshot.markings) {
+        const QPointF pos = worldToFrame(marking.xMeters(), marking.yMeters(), frame);
+
+        painter.drawText(toWidget(pos.x() + 10, pos.y()), MarkingOverlayProcessor::markingLabel(marking));
+    }
+
+    if (snapshot.warnings.empty())
+        return;
+
+    painter.setFont(m_warningFont);
+    const QFontMetrics fm(m_warningFont);
+    QPointF origin = toWidget(10, 50);
+
+    for (const auto& warning : snapshot.warnings) {
+        if (!warning.isActive())
+            continue;
+
+        const QColor bgColor = warning.isCritical() ? QColor(220, 0, 0, 180) : QColor(255, 165, 0, 180);
+        const QString text = MarkingOverlayProcessor::warningLabel(warning);
+
+        QRect textRect = fm.boundingRect(text);
+        textRect.adjust(-5, -3, 5, 3);
+        textRect.moveTopLeft(origin.toPoint());
+
+        painter.fillRect(textRect, bgColor);
+        painter.setPen(Qt::white);
+        painter.drawText(textRect, Qt::AlignCenter, text);
+
+        origin.ry() += textRect.height() + 5;
+    }
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <QOpenGLWidget>
+#include <QOpenGLExtraFunctions>
+#include <QOpenGLShaderProgram>
+#include <QOpenGLBuffer>
+#include <QOpenGLVertexArrayObject>
+#include <QColor>
+#include <QFont>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "IFrameHandle.hpp"
+#include "DomainSnapshot.h"
+#include "YuvConverter.hpp"
+
+namespace video {
+
+    // OpenGL display surface used by AbstractVideoWidget's OpenGL backend.
+    //
+    // Frames become textures: NV12/YUV420P frames straight from the planes of
+    // a YuvFrameHandle, converted to RGB in the fragment shader, anything else
+    // from image(). Lane lines and marking glyphs from the domain snapshot are
+    // drawn as one instanced batch; their labels and the warning boxes go
+    // through QPainter (GL paint engine) on top. Needs OpenGL 3.3 or OpenGL ES
+    // 3.0, which Mesa llvmpipe provides, so no GPU is required.
+    class GlVideoSurface : public QOpenGLWidget, protected QOpenGLExtraFunctions
+    {
+        Q_OBJECT
+
+    public:
+        explicit GlVideoSurface(QWidget* parent = nullptr);
+        ~GlVideoSurface() override;
+
+        void setFrame(const FrameHandlePtr& frame);
+
+        void setKeepAspectRatio(bool keep);
+        void setBackgroundColor(const QColor& color);
+
+        // Overlay data, looked up by frame timestamp; nothing is drawn over
+        // the video without a source
+        void setSnapshotSource(const domain::SnapshotSource* source);
+
+        // Painted last, over video and overlay
+        void setOverlayPainter(std::function<void(QPainter&)> painter);
+
+    signals:
+        // The context cannot run the surface; emitted from initializeGL()
+        void initializationFailed(const QString& reason);
+
+    protected:
+        void initializeGL() override;
+        void paintGL() override;
+
+    private:
+        enum class TextureMode
+        {
+            Rgb32 = 0,
+            Nv12 = 1,
+            Yuv420p = 2
+        };
+
+        // One overlay primitive in frame pixels
+        struct Instance
+        {
+            float rect[4];      // x, y, width, height
+            float color[4];
+            float shape;        // 0 = rectangle, 1 = disc, 2 = vertically dashed rectangle
+        };
+
+        bool m_ready = false;
+        bool m_frameDirty = false;
+        bool m_keepAspectRatio = true;
+        QColor m_backgroundColor = Qt::black;
+        FrameHandlePtr m_frame;
+        const domain::SnapshotSource* m_snapshotSource = nullptr;
+        std::function<void(QPainter&)> m_overlayPainter;
+
+        std::unique_ptr<QOpenGLShaderProgram> m_videoProgram;
+        std::unique_ptr<QOpenGLShaderProgram> m_overlayProgram;
+        std::unique_ptr<QOpenGLVertexArrayObject> m_videoVao;
+        std::unique_ptr<QOpenGLVertexArrayObject> m_overlayVao;
+        QOpenGLBuffer m_quadBuffer{QOpenGLBuffer::VertexBuffer};
+        QOpenGLBuffer m_instanceBuffer{QOpenGLBuffer::VertexBuffer};
+
+        GLuint m_textures[3] = {0, 0, 0};
+        QSize m_textureSizes[3];
+        GLenum m_textureFormats[3] = {0, 0, 0};
+        TextureMode m_textureMode = TextureMode::Rgb32;
+        QSize m_frameSize;
+        YuvToRgbCoefficients m_coefficients;
+
+        std::vector<Instance> m_instances;
+        QFont m_laneFont;
+        QFont m_markingFont;
+        QFont m_warningFont;
+
+        bool buildPrograms(QString& error);
+        void cleanup();
+
+        bool uploadFrame();
+        void uploadPlane(int index, GLenum internalFormat, GLenum format,
+                         int width, int height, const uchar* data, int rowLength);
+
+        [[nodiscard]] QRectF targetRect() const;
+        void drawVideo(const QRectF& target);
+        void drawOverlayGeometry(const QRectF& target, const domain::DomainSnapshot& snapshot);
+        void drawOverlayLabels(QPainter& painter, const QRectF& target, const domain::DomainSnapshot& snapshot);
+    };
+
+} // namespace video
@@ -11,6 +11,7 @@ namespace video {
     {
     public:
         using ProcessingCallback = std::function<void(bool success, const QString& error)>;
+        using FrameTask = std::function<void(const FrameHandlePtr& frame)>;
 
         virtual ~IVideoFrameProcessor() = default;
 
@@ -20,6 +21,14 @@ namespace video {
         virtual void cancel() = 0;
         [[nodiscard]] virtual QString name() const = 0;
         virtual void reset() = 0;
+
+        // Off-thread processing: called on the GUI thread, in frame order, to
+        // capture whatever GUI-side state processFrame() reads. The returned
+        // task may run on any thread. The default just defers processFrame().
+        [[nodiscard]] virtual FrameTask prepareFrameTask()
+        {
+            return [this](const FrameHandlePtr& frame) { processFrame(frame); };
+        }
     };
 
     using FrameProcessorPtr = QSharedPointer<IVideoFrameProcessor>;
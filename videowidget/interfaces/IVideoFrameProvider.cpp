@@ -6,3 +6,8 @@ IVideoFrameProvider::IVideoFrameProvider(QObject* parent)
     : QObject(parent)
 {
 }
+
+void IVideoFrameProvider::setOutputSizeHint(const QSize& size)
+{
+    Q_UNUSED(size);
+}
@@ -3,6 +3,7 @@
 #include <QObject>
 #include <QString>
 #include <QSharedPointer>
+#include <QSize>
 #include "IFrameHandle.hpp"
 
 namespace video {
@@ -35,6 +36,11 @@ namespace video {
         virtual void setSource(const QString& source) = 0;
         [[nodiscard]] virtual double frameRate() const = 0;
 
+        // Size the frames end up displayed at, in device pixels. Providers
+        // may use it to produce smaller frames that fit inside it with the
+        // source aspect ratio; empty means full size.
+        virtual void setOutputSizeHint(const QSize& size);
+
     signals:
         void frameReady(const FrameHandlePtr& frame);
         void errorOccurred(const QString& message);
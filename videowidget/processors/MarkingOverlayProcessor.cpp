@@ -2,81 +2,90 @@
 #include "LoggerMacros.hpp"
 #include <QPen>
 #include <QBrush>
+#include <QFontMetrics>
+#include <QThreadPool>
+#include <algorithm>
 #include <cmath>
+#include <string>
+#include <utility>
 
 using namespace video;
 
-MarkingOverlayProcessor::MarkingOverlayProcessor()
-{
-    LOG_TRACE << "MarkingOverlayProcessor created";
-}
+namespace {
 
-void MarkingOverlayProcessor::setLaneStateViewModel(viewmodels::LaneStateViewModel* viewModel)
-{
-    QMutexLocker locker(&m_mutex);
-    m_laneStateViewModel = viewModel;
-    LOG_DEBUG << "LaneStateViewModel set";
-}
+    // Labels change with the data (lane width, distances); start over rather
+    // than let the caches grow without bound
+    constexpr int kMaxCachedLabels = 256;
 
-void MarkingOverlayProcessor::setMarkingObjectListModel(viewmodels::MarkingObjectListModel* model)
-{
-    QMutexLocker locker(&m_mutex);
-    m_markingObjectListModel = model;
-    LOG_DEBUG << "MarkingObjectListModel set";
+    // Room for the antialiased edges and pen widths around painted shapes
+    constexpr int kBoundsMargin = 3;
+
+    // Everything drawLaneOverlay() reads
+    bool sameDrawnLane(const domain::LaneState& a, const domain::LaneState& b)
+    {
+        if (a.isValid() != b.isValid())
+            return false;
+        return !a.isValid() ||
+               (a.leftOffsetMeters() == b.leftOffsetMeters() && a.rightOffsetMeters() == b.rightOffsetMeters() &&
+                a.qualityRaw() == b.qualityRaw());
+    }
 }
 
-void MarkingOverlayProcessor::setWarningListModel(viewmodels::WarningListModel* model)
+MarkingOverlayProcessor::MarkingOverlayProcessor()
 {
-    QMutexLocker locker(&m_mutex);
-    m_warningListModel = model;
-    LOG_DEBUG << "WarningListModel set";
+    initLabelCache(m_laneLabels, QFont("Arial", 10));
+    initLabelCache(m_markingLabels, QFont("Arial", 8));
+    initLabelCache(m_warningLabels, QFont("Arial", 11, QFont::Bold));
+    LOG_TRACE << "MarkingOverlayProcessor created";
 }
 
-void MarkingOverlayProcessor::updateMarkings(const domain::MarkingObjectModel& model)
+void MarkingOverlayProcessor::setSnapshotSource(const domain::SnapshotSource* source)
 {
-    if (m_markingObjectListModel) {
-        QMutexLocker locker(&m_mutex);
-        m_markingObjectListModel->updateFromDomain(model);
-        LOG_DEBUG << "MarkingObjectListModel updated from domain, objects count: " << model.size();
-    } else {
-        LOG_WARN << "Cannot update markings: MarkingObjectListModel not set";
-    }
+    QMutexLocker locker(&m_mutex);
+    m_snapshotSource = source;
+    LOG_DEBUG << "Snapshot source set";
 }
 
 void MarkingOverlayProcessor::setDrawLanes(bool draw)
 {
     QMutexLocker locker(&m_mutex);
-    m_drawLanes = draw;
+    m_options.lanes = draw;
 }
 
 void MarkingOverlayProcessor::setDrawMarkings(bool draw)
 {
     QMutexLocker locker(&m_mutex);
-    m_drawMarkings = draw;
+    m_options.markings = draw;
 }
 
 void MarkingOverlayProcessor::setDrawWarnings(bool draw)
 {
     QMutexLocker locker(&m_mutex);
-    m_drawWarnings = draw;
+    m_options.warnings = draw;
 }
 
 bool MarkingOverlayProcessor::drawLanes() const
 {
     QMutexLocker locker(&m_mutex);
-    return m_drawLanes;
+    return m_options.lanes;
 }
 
 bool MarkingOverlayProcessor::drawMarkings() const
 {
     QMutexLocker locker(&m_mutex);
-    return m_drawMarkings;
+    return m_options.markings;
 }
 
 bool MarkingOverlayProcessor::drawWarnings() const
 {
     QMutexLocker locker(&m_mutex);
-    return m_drawWarnings;
+    return m_options.warnings;
+}
+
+OverlayLayerStats MarkingOverlayProcessor::layerStats() const
+{
+    QMutexLocker locker(&m_layerMutex);
+    return m_layerStats;
 }
 
 void MarkingOverlayProcessor::processFrame(const FrameHandlePtr& frame)
@@ -86,17 +95,8 @@ void MarkingOverlayProcessor::processFrame(const FrameHandlePtr& frame)
         return;
     }
 
-    if (!m_enabled) {
-        return;
-    }
-
-    QMutexLocker locker(&m_mutex);
-    m_processing = true;
-
-    QImage& image = frame->writableImage();
-    drawOverlay(image);
-
-    m_processing = false;
+    if (auto task = prepareFrameTask())
+        task(frame);
 }
 
 void MarkingOverlayProcessor::processFrameAsync(const FrameHandlePtr& frame, ProcessingCallback callback)
@@ -109,36 +109,65 @@ void MarkingOverlayProcessor::processFrameAsync(const FrameHandlePtr& frame, Pro
         return;
     }
 
-    if (!m_enabled) {
+    FrameTask task = prepareFrameTask();
+    if (!task) {
         if (callback) {
             callback(true, "");
         }
         return;
     }
 
-    try {
-        processFrame(frame);
-        if (callback) {
-            callback(true, "");
+    // The callback runs on the worker thread
+    QThreadPool::globalInstance()->start([task, frame, callback]() {
+        try {
+            task(frame);
+            if (callback) {
+                callback(true, "");
+            }
+        } catch (const std::exception& e) {
+            LOG_ERROR << "Exception in async processing:" << e.what();
+            if (callback) {
+                callback(false, QString::fromStdString(e.what()));
+            }
         }
-    } catch (const std::exception& e) {
-        LOG_ERROR << "Exception in async processing:" << e.what();
-        if (callback) {
-            callback(false, QString::fromStdString(e.what()));
-        }
-    }
+    });
 }
 
-bool MarkingOverlayProcessor::isProcessing() const
+IVideoFrameProcessor::FrameTask MarkingOverlayProcessor::prepareFrameTask()
 {
     QMutexLocker locker(&m_mutex);
-    return m_processing;
+    if (!m_enabled || !m_snapshotSource)
+        return {};
+
+    const domain::SnapshotSource* source = m_snapshotSource;
+    const DrawOptions options = m_options;
+    const quint64 generation = m_generation.load(std::memory_order_relaxed);
+
+    return [this, source, options, generation](const FrameHandlePtr& frame) {
+        if (!frame || !frame->isValid())
+            return;
+        if (m_generation.load(std::memory_order_relaxed) != generation)
+            return;     // cancelled after the task was prepared
+
+        const domain::DomainSnapshotPtr snapshot =
+            source->snapshotFor(static_cast<std::uint64_t>(std::max<int64_t>(frame->timestamp(), 0)));
+        if (!snapshot)
+            return;
+
+        m_activeTasks.fetch_add(1, std::memory_order_relaxed);
+        compositeOverlay(frame->writableImage(), *snapshot, options);
+        m_activeTasks.fetch_sub(1, std::memory_order_relaxed);
+    };
+}
+
+bool MarkingOverlayProcessor::isProcessing() const
+{
+    return m_activeTasks.load(std::memory_order_relaxed) > 0;
 }
 
 void MarkingOverlayProcessor::cancel()
 {
-    QMutexLocker locker(&m_mutex);
-    m_processing = false;
+    m_generation.fetch_add(1, std::memory_order_relaxed);
     LOG_DEBUG << "Processing cancelled";
 }
 
@@ -149,8 +178,11 @@ QString MarkingOverlayProcessor::name() const
 
 void MarkingOverlayProcessor::reset()
 {
-    QMutexLocker locker(&m_mutex);
-    m_processing = false;
+    m_generation.fetch_add(1, std::memory_order_relaxed);
+    {
+        QMutexLocker locker(&m_layerMutex);
+        m_layerValid = false;
+    }
     LOG_INFO << "Processor reset";
 }
 
@@ -170,47 +202,109 @@ bool MarkingOverlayProcessor::isEnabled() const
     return m_enabled;
 }
 
-void MarkingOverlayProcessor::drawOverlay(QImage& image)
+void MarkingOverlayProcessor::compositeOverlay(QImage& image, const domain::DomainSnapshot& snapshot, const DrawOptions& options)
 {
     if (image.isNull())
         return;
 
+    Layer lane;
+    Layer content;
+    {
+        QMutexLocker locker(&m_layerMutex);
+        const bool stale = !m_layerValid || m_contentLayer.image.size() != image.size() || !(m_layerOptions == options);
+        if (stale || m_layerContentVersion != snapshot.content_version)
+            rebuildContentLayer(image.size(), snapshot, options);
+        if (stale || !sameDrawnLane(m_layerLane, snapshot.lane))
+            rebuildLaneLayer(image.size(), snapshot.lane, options);
+        m_layerOptions = options;
+        m_layerValid = true;
+
+        // Shallow copies: a concurrent rebuild detaches instead of drawing under us
+        lane = m_laneLayer;
+        content = m_contentLayer;
+        ++m_layerStats.composited;
+    }
+
+    if (lane.bounds.isEmpty() && content.bounds.isEmpty())
+        return;
+
     QPainter painter(&image);
-    painter.setRenderHint(QPainter::Antialiasing);
+    if (!lane.bounds.isEmpty())
+        painter.drawImage(lane.bounds.topLeft(), lane.image, lane.bounds);
+    if (!content.bounds.isEmpty())
+        painter.drawImage(content.bounds.topLeft(), content.image, content.bounds);
+}
 
-    const QSize imageSize = image.size();
+void MarkingOverlayProcessor::rebuildLaneLayer(const QSize& size, const domain::LaneState& lane, const DrawOptions& options)
+{
+    clearLayer(m_laneLayer, size);
 
-    if (m_drawLanes && m_laneStateViewModel) {
-        drawLaneOverlay(painter, imageSize);
+    QRect bounds;
+    if (options.lanes) {
+        QPainter painter(&m_laneLayer.image);
+        painter.setRenderHint(QPainter::Antialiasing);
+        bounds = drawLaneOverlay(painter, size, lane);
     }
 
-    if (m_drawMarkings && m_markingObjectListModel) {
-        drawMarkingObjects(painter, imageSize);
+    setLayerBounds(m_laneLayer, bounds);
+    m_layerLane = lane;
+    ++m_layerStats.lane_rebuilds;
+}
+
+void MarkingOverlayProcessor::rebuildContentLayer(const QSize& size, const domain::DomainSnapshot& snapshot, const DrawOptions& options)
+{
+    clearLayer(m_contentLayer, size);
+
+    QRect bounds;
+    if (options.markings || options.warnings) {
+        QPainter painter(&m_contentLayer.image);
+        painter.setRenderHint(QPainter::Antialiasing);
+        if (options.markings)
+            bounds |= drawMarkingObjects(painter, size, snapshot.markings);
+        if (options.warnings)
+            bounds |= drawWarnings(painter, snapshot.warnings);
     }
 
-    if (m_drawWarnings && m_warningListModel) {
-        drawWarnings(painter, imageSize);
+    setLayerBounds(m_contentLayer, bounds);
+    m_layerContentVersion = snapshot.content_version;
+    ++m_layerStats.rebuilds;
+}
+
+void MarkingOverlayProcessor::clearLayer(Layer& layer, const QSize& size)
+{
+    if (layer.image.size() != size) {
+        layer.image = QImage(size, QImage::Format_ARGB32_Premultiplied);
+        layer.image.fill(Qt::transparent);
+    } else if (!layer.bounds.isEmpty()) {
+        // Only what the last rebuild painted needs clearing
+        QPainter painter(&layer.image);
+        painter.setCompositionMode(QPainter::CompositionMode_Source);
+        painter.fillRect(layer.bounds, Qt::transparent);
     }
+    layer.bounds = QRect();
 }
 
-void MarkingOverlayProcessor::drawLaneOverlay(QPainter& painter, const QSize& imageSize)
+void MarkingOverlayProcessor::setLayerBounds(Layer& layer, const QRect& painted)
 {
-    if (!m_laneStateViewModel || !m_laneStateViewModel->isValid())
-        return;
+    layer.bounds = painted.isEmpty()
+        ? QRect()
+        : painted.adjusted(-kBoundsMargin, -kBoundsMargin, kBoundsMargin, kBoundsMargin) & layer.image.rect();
+}
+
+QRect MarkingOverlayProcessor::drawLaneOverlay(QPainter& painter, const QSize& imageSize, const domain::LaneState& lane)
+{
+    if (!lane.isValid())
+        return {};
 
     const int centerX = imageSize.width() / 2;
     const int bottomY = imageSize.height();
     const int topY = imageSize.height() / 2;
 
-    const float leftOffset = m_laneStateViewModel->leftOffsetMeters();
-    const float rightOffset = m_laneStateViewModel->rightOffsetMeters();
-    const float centerOffset = m_laneStateViewModel->centerOffsetMeters();
-
     const float pixelsPerMeter = imageSize.width() / 10.0f;
 
-    const int leftLineX = centerX + static_cast<int>(leftOffset * pixelsPerMeter);
-    const int rightLineX = centerX + static_cast<int>(rightOffset * pixelsPerMeter);
-    const int centerLineX = centerX + static_cast<int>(centerOffset * pixelsPerMeter);
+    const int leftLineX = centerX + static_cast<int>(lane.leftOffsetMeters() * pixelsPerMeter);
+    const int rightLineX = centerX + static_cast<int>(lane.rightOffsetMeters() * pixelsPerMeter);
+    const int centerLineX = centerX + static_cast<int>(lane.centerOffsetMeters() * pixelsPerMeter);
 
     QPen lanePen(Qt::green, 3);
     painter.setPen(lanePen);
@@ -222,87 +316,138 @@ void MarkingOverlayProcessor::drawLaneOverlay(QPainter& painter, const QSize& im
     painter.setPen(centerPen);
     painter.drawLine(centerLineX, bottomY, centerLineX, topY);
 
+    QRect bounds(QPoint(std::min({leftLineX, rightLineX, centerLineX}), topY),
+                 QPoint(std::max({leftLineX, rightLineX, centerLineX}), bottomY));
+
+    // Same 0-255 -> percent conversion as LaneStateViewModel
+    const int qualityPercent = static_cast<int>((lane.qualityRaw() * 100) / 255);
+
+    const QStaticText widthLabel = cachedLabel(m_laneLabels, QString("Lane Width: %1m").arg(lane.laneWidthMeters(), 0, 'f', 2));
+    const QStaticText qualityLabel = cachedLabel(m_laneLabels, QString("Quality: %1%").arg(qualityPercent));
+
+    // drawText() took baselines; static text is positioned by its top-left corner
+    const QPointF widthPos(10, 20 - m_laneLabels.ascent);
+    const QPointF qualityPos(10, 35 - m_laneLabels.ascent);
+
     painter.setPen(Qt::white);
-    painter.setFont(QFont("Arial", 10));
-    painter.drawText(10, 20, QString("Lane Width: %1m").arg(m_laneStateViewModel->laneWidthMeters(), 0, 'f', 2));
-    painter.drawText(10, 35, QString("Quality: %1%").arg(m_laneStateViewModel->qualityPercent()));
+    painter.setFont(m_laneLabels.font);
+    painter.drawStaticText(widthPos, widthLabel);
+    painter.drawStaticText(qualityPos, qualityLabel);
+
+    bounds |= QRectF(widthPos, widthLabel.size()).toAlignedRect();
+    bounds |= QRectF(qualityPos, qualityLabel.size()).toAlignedRect();
+    return bounds;
 }
 
-void MarkingOverlayProcessor::drawMarkingObjects(QPainter& painter, const QSize& imageSize)
+QString MarkingOverlayProcessor::markingLabel(const domain::MarkingObject& marking)
 {
-    if (!m_markingObjectListModel)
-        return;
+    static const QString crosswalkName = QStringLiteral("Crosswalk");
+    static const QString arrowName = QStringLiteral("Arrow");
+    static const QString unknownName = QStringLiteral("Unknown");
+
+    const QString* className = &unknownName;
+    switch (marking.classId()) {
+        case laneproto::MarkingClassId::Crosswalk: className = &crosswalkName; break;
+        case laneproto::MarkingClassId::Arrow: className = &arrowName; break;
+        default: break;
+    }
 
-    const int count = m_markingObjectListModel->rowCount();
-    if (count == 0)
-        return;
+    // confidence() is already a percentage, 0..100
+    return QString("%1 (%2%)").arg(*className).arg(static_cast<int>(marking.confidence()));
+}
 
-    for (int i = 0; i < count; ++i) {
-        QModelIndex index = m_markingObjectListModel->index(i, 0);
+QString MarkingOverlayProcessor::warningLabel(const domain::Warning& warning)
+{
+    // Called from pool workers as well as the GUI thread
+    thread_local std::string message;
+    message.clear();
+    warning.appendMessage(message);
+    return QString("%1 (%2 m)").arg(QString::fromStdString(message)).arg(warning.distanceMeters(), 0, 'f', 1);
+}
 
-        const float x = m_markingObjectListModel->data(index, viewmodels::MarkingObjectListModel::XMetersRole).toFloat();
-        const float y = m_markingObjectListModel->data(index, viewmodels::MarkingObjectListModel::YMetersRole).toFloat();
-        const QString className = m_markingObjectListModel->data(index, viewmodels::MarkingObjectListModel::ClassNameRole).toString();
-        const bool isCrosswalk = m_markingObjectListModel->data(index, viewmodels::MarkingObjectListModel::IsCrosswalkRole).toBool();
-        const bool isArrow = m_markingObjectListModel->data(index, viewmodels::MarkingObjectListModel::IsArrowRole).toBool();
-        const float confidence = m_markingObjectListModel->data(index, viewmodels::MarkingObjectListModel::ConfidenceRole).toFloat();
+QRect MarkingOverlayProcessor::drawMarkingObjects(QPainter& painter, const QSize& imageSize, const domain::MarkingObjectModel& markings)
+{
+    QRect bounds;
+    painter.setFont(m_markingLabels.font);
 
-        QPointF pos = worldToImage(x, y, imageSize);
+    for (const auto& marking : markings) {
+        QPointF pos = worldToImage(marking.xMeters(), marking.yMeters(), imageSize);
 
-        QColor color = isCrosswalk ? Qt::cyan : (isArrow ? Qt::magenta : Qt::blue);
+        QColor color = marking.isCrosswalk() ? Qt::cyan : (marking.isArrow() ? Qt::magenta : Qt::blue);
         const int radius = 8;
 
         painter.setPen(QPen(color, 2));
         painter.setBrush(QBrush(color, Qt::SolidPattern));
         painter.drawEllipse(pos, radius, radius);
 
+        const QStaticText label = cachedLabel(m_markingLabels, markingLabel(marking));
+        const QPointF labelPos(pos.x() + radius + 2, pos.y() - m_markingLabels.ascent);
+
         painter.setPen(Qt::white);
-        painter.setFont(QFont("Arial", 8));
-        painter.drawText(pos.x() + radius + 2, pos.y(), QString("%1 (%.0f%%)").arg(className).arg(confidence * 100));
+        painter.drawStaticText(labelPos, label);
+
+        bounds |= QRectF(pos.x() - radius, pos.y() - radius, 2 * radius, 2 * radius).toAlignedRect();
+        bounds |= QRectF(labelPos, label.size()).toAlignedRect();
     }
+    return bounds;
 }
 
-void MarkingOverlayProcessor::drawWarnings(QPainter& painter, const QSize& imageSize)
+QRect MarkingOverlayProcessor::drawWarnings(QPainter& painter, const domain::WarningModel& warnings)
 {
-    if (!m_warningListModel)
-        return;
-
-    const int count = m_warningListModel->rowCount();
-    if (count == 0)
-        return;
+    if (warnings.empty())
+        return {};
 
+    QRect bounds;
     int yOffset = 50;
-    painter.setFont(QFont("Arial", 11, QFont::Bold));
-
-    for (int i = 0; i < count; ++i) {
-        QModelIndex index = m_warningListModel->index(i, 0);
+    painter.setFont(m_warningLabels.font);
 
-        const bool isActive = m_warningListModel->data(index, viewmodels::WarningListModel::IsActiveRole).toBool();
-        if (!isActive)
+    for (const auto& warning : warnings) {
+        if (!warning.isActive())
             continue;
 
-        const bool isCritical = m_warningListModel->data(index, viewmodels::WarningListModel::IsCriticalRole).toBool();
-        const QString message = m_warningListModel->data(index, viewmodels::WarningListModel::MessageRole).toString();
-        const float distance = m_warningListModel->data(index, viewmodels::WarningListModel::DistanceMetersRole).toFloat();
-
-        QColor bgColor = isCritical ? QColor(220, 0, 0, 180) : QColor(255, 165, 0, 180);
+        QColor bgColor = warning.isCritical() ? QColor(220, 0, 0, 180) : QColor(255, 165, 0, 180);
         QColor textColor = Qt::white;
 
-        QString text = QString("%1 (%.1fm)").arg(message).arg(distance);
-        QFontMetrics fm(painter.font());
-        QRect textRect = fm.boundingRect(text);
+        const QStaticText label = cachedLabel(m_warningLabels, warningLabel(warning));
+        QRect textRect(QPoint(0, 0), label.size().toSize());
         textRect.adjust(-5, -3, 5, 3);
         textRect.moveTopLeft(QPoint(10, yOffset));
 
         painter.fillRect(textRect, bgColor);
         painter.setPen(textColor);
-        painter.drawText(textRect, Qt::AlignCenter, text);
+        painter.drawStaticText(textRect.topLeft() + QPoint(5, 3), label);
 
+        bounds |= textRect;
         yOffset += textRect.height() + 5;
     }
+    return bounds;
+}
+
+void MarkingOverlayProcessor::initLabelCache(LabelCache& cache, const QFont& font)
+{
+    cache.font = font;
+    cache.ascent = QFontMetrics(font).ascent();
+    cache.labels.reserve(kMaxCachedLabels);
+}
+
+QStaticText MarkingOverlayProcessor::cachedLabel(LabelCache& cache, const QString& text)
+{
+    auto it = cache.labels.constFind(text);
+    if (it != cache.labels.constEnd())
+        return *it;
+
+    if (cache.labels.size() >= kMaxCachedLabels)
+        cache.labels.clear();
+
+    QStaticText label(text);
+    label.setTextFormat(Qt::PlainText);
+    label.setPerformanceHint(QStaticText::AggressiveCaching);
+    label.prepare(QTransform(), cache.font);
+    cache.labels.insert(text, label);
+    return label;
 }
 
-QPointF MarkingOverlayProcessor::worldToImage(float x, float y, const QSize& imageSize) const
+QPointF MarkingOverlayProcessor::worldToImage(float x, float y, const QSize& imageSize)
 {
     const float pixelsPerMeter = imageSize.width() / 10.0f;
     const int centerX = imageSize.width() / 2;
@@ -1,15 +1,23 @@
 #pragma once
 
 #include "IVideoFrameProcessor.hpp"
-#include "LaneStateViewModel.h"
-#include "MarkingObjectListModel.h"
-#include "WarningListModel.h"
-#include "MarkingObject.h"
+#include "DomainSnapshot.h"
 #include <QPainter>
 #include <QMutex>
+#include <QHash>
+#include <QImage>
+#include <QStaticText>
+#include <atomic>
 
 namespace video {
 
+    struct OverlayLayerStats
+    {
+        quint64 composited = 0;     // frames the cached layers were blended onto
+        quint64 rebuilds = 0;       // times the marking and warning layer had to be redrawn
+        quint64 lane_rebuilds = 0;  // times the lane layer had to be redrawn
+    };
+
     class MarkingOverlayProcessor : public IVideoFrameProcessor
     {
     public:
@@ -23,15 +31,18 @@ namespace video {
         [[nodiscard]] QString name() const override;
         void reset() override;
 
+        // Captures the options; the task looks up the snapshot for the
+        // frame's timestamp and paints it. Empty when the processor is
+        // disabled or has no snapshot source.
+        [[nodiscard]] FrameTask prepareFrameTask() override;
+
         void setEnabled(bool enabled);
         [[nodiscard]] bool isEnabled() const;
 
-        void setLaneStateViewModel(viewmodels::LaneStateViewModel* viewModel);
-        void setMarkingObjectListModel(viewmodels::MarkingObjectListModel* model);
-        void setWarningListModel(viewmodels::WarningListModel* model);
-
-        // Update marking data from domain model
-        void updateMarkings(const domain::MarkingObjectModel& model);
+        // Overlay data: ConnectionManager's publisher (newest state) or the
+        // sync monitor's timeline (state at the frame's time). The source
+        // must outlive the processor.
+        void setSnapshotSource(const domain::SnapshotSource* source);
 
         void setDrawLanes(bool draw);
         void setDrawMarkings(bool draw);
@@ -41,25 +52,81 @@ namespace video {
         [[nodiscard]] bool drawMarkings() const;
         [[nodiscard]] bool drawWarnings() const;
 
+        [[nodiscard]] OverlayLayerStats layerStats() const;
+
+        // Label texts, shared with GlVideoSurface so both paths read the same
+        [[nodiscard]] static QString markingLabel(const domain::MarkingObject& marking);
+        [[nodiscard]] static QString warningLabel(const domain::Warning& warning);
+
     private:
+        struct DrawOptions
+        {
+            bool lanes = true;
+            bool markings = true;
+            bool warnings = true;
+
+            bool operator==(const DrawOptions& other) const
+            {
+                return lanes == other.lanes && markings == other.markings && warnings == other.warnings;
+            }
+        };
+
+        // Laid-out labels for one font, reused while the text stays the same
+        struct LabelCache
+        {
+            QFont font;
+            int ascent = 0;
+            QHash<QString, QStaticText> labels;
+        };
+
         bool m_enabled = true;
-        bool m_processing = false;
+        std::atomic<int> m_activeTasks{0};
+        std::atomic<quint64> m_generation{0};      // bumped by cancel()/reset()
         mutable QMutex m_mutex;
 
-        viewmodels::LaneStateViewModel* m_laneStateViewModel = nullptr;
-        viewmodels::MarkingObjectListModel* m_markingObjectListModel = nullptr;
-        viewmodels::WarningListModel* m_warningListModel = nullptr;
+        const domain::SnapshotSource* m_snapshotSource = nullptr;
+
+        DrawOptions m_options;
+
+        struct Layer
+        {
+            QImage image;
+            QRect bounds;               // area of image that holds anything
+        };
+
+        // The overlay is drawn into two layers that are blended onto every
+        // frame. Markings and warnings change at the sensor rate and are keyed
+        // on the snapshot's content_version; the lane is keyed on what is
+        // drawn of it, since interpolation moves it between sensor updates.
+        // Both are redrawn when the frame size or draw options change.
+        // Everything below is guarded by m_layerMutex.
+        mutable QMutex m_layerMutex;
+        Layer m_laneLayer;
+        Layer m_contentLayer;
+        domain::LaneState m_layerLane;
+        quint64 m_layerContentVersion = 0;
+        DrawOptions m_layerOptions;
+        bool m_layerValid = false;
+        LabelCache m_laneLabels;
+        LabelCache m_markingLabels;
+        LabelCache m_warningLabels;
+        OverlayLayerStats m_layerStats;
+
+        void compositeOverlay(QImage& image, const domain::DomainSnapshot& snapshot, const DrawOptions& options);
+        void rebuildLaneLayer(const QSize& size, const domain::LaneState& lane, const DrawOptions& options);
+        void rebuildContentLayer(const QSize& size, const domain::DomainSnapshot& snapshot, const DrawOptions& options);
+        static void clearLayer(Layer& layer, const QSize& size);
+        static void setLayerBounds(Layer& layer, const QRect& painted);
 
-        bool m_drawLanes = true;
-        bool m_drawMarkings = true;
-        bool m_drawWarnings = true;
+        // Each returns the area it painted
+        QRect drawLaneOverlay(QPainter& painter, const QSize& imageSize, const domain::LaneState& lane);
+        QRect drawMarkingObjects(QPainter& painter, const QSize& imageSize, const domain::MarkingObjectModel& markings);
+        QRect drawWarnings(QPainter& painter, const domain::WarningModel& warnings);
 
-        void drawOverlay(QImage& image);
-        void drawLaneOverlay(QPainter& painter, const QSize& imageSize);
-        void drawMarkingObjects(QPainter& painter, const QSize& imageSize);
-        void drawWarnings(QPainter& painter, const QSize& imageSize);
+        static void initLabelCache(LabelCache& cache, const QFont& font);
+        static QStaticText cachedLabel(LabelCache& cache, const QString& text);
 
-        QPointF worldToImage(float x, float y, const QSize& imageSize) const;
+        static QPointF worldToImage(float x, float y, const QSize& imageSize);
     };
 
 } // namespace video
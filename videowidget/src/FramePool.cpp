@@ -0,0 +1,175 @@
+#include "FramePool.hpp"
+#include "BasicFrameHandle.hpp"
+#include "LoggerMacros.hpp"
+
+#include <QMutexLocker>
+#include <algorithm>
+#include <cstdlib>
+
+using namespace video;
+
+namespace {
+
+    constexpr std::size_t kAlignment = 64;
+
+    constexpr std::size_t alignUp(std::size_t value, std::size_t alignment)
+    {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+}
+
+struct FramePool::Buffer
+{
+    uchar* data = nullptr;
+    std::size_t size = 0;
+    bool transient = false;
+    FramePoolPtr owner;     // set while handed out; keeps the pool alive
+
+    ~Buffer()
+    {
+        std::free(data);
+    }
+
+    // Returns true if the buffer had to be (re)allocated
+    bool reserve(std::size_t bytes)
+    {
+        if (bytes <= size && data)
+            return false;
+
+        std::free(data);
+        size = alignUp(bytes, kAlignment);
+        data = static_cast<uchar*>(std::aligned_alloc(kAlignment, size));
+        if (!data)
+            size = 0;
+        return true;
+    }
+};
+
+QSharedPointer<FramePool> FramePool::create(int capacity)
+{
+    return QSharedPointer<FramePool>(new FramePool(capacity));
+}
+
+FramePool::FramePool(int capacity)
+{
+    setCapacity(capacity);
+    LOG_TRACE << "FramePool created, capacity=" << m_capacity;
+}
+
+FramePool::~FramePool()
+{
+    LOG_TRACE << "FramePool destroyed";
+}
+
+QImage FramePool::acquireImage(int width, int height, QImage::Format format)
+{
+    if (width <= 0 || height <= 0 || format == QImage::Format_Invalid)
+        return {};
+
+    const std::size_t bitsPerPixel = QImage::toPixelFormat(format).bitsPerPixel();
+    const std::size_t bytesPerLine = alignUp((static_cast<std::size_t>(width) * bitsPerPixel + 7) / 8,
+                                             kAlignment);
+    const std::size_t bytes = bytesPerLine * static_cast<std::size_t>(height);
+
+    Buffer* buffer = nullptr;
+    {
+        QMutexLocker locker(&m_mutex);
+        ++m_stats.acquired;
+
+        bool recycled = false;
+        if (!m_free.empty()) {
+            buffer = m_free.back();
+            m_free.pop_back();
+            recycled = true;
+        } else if (static_cast<int>(m_buffers.size()) < m_capacity) {
+            m_buffers.push_back(std::make_unique<Buffer>());
+            buffer = m_buffers.back().get();
+        } else {
+            ++m_stats.exhausted;
+            buffer = new Buffer;
+            buffer->transient = true;
+        }
+
+        if (buffer->reserve(bytes))
+            ++m_stats.allocations;
+        else if (recycled)
+            ++m_stats.reused;
+
+        if (!buffer->data) {
+            LOG_ERROR << "FramePool: failed to allocate " << bytes << " bytes";
+            if (buffer->transient)
+                delete buffer;
+            else
+                m_free.push_back(buffer);
+            return {};
+        }
+    }
+
+    buffer->owner = sharedFromThis();
+    return QImage(buffer->data, width, height, static_cast<qsizetype>(bytesPerLine), format,
+                  &FramePool::releaseBuffer, buffer);
+}
+
+FrameHandlePtr FramePool::acquire(int width, int height, QImage::Format format)
+{
+    QImage image = acquireImage(width, height, format);
+    if (image.isNull())
+        return {};
+    return QSharedPointer<BasicFrameHandle>::create(image);
+}
+
+void FramePool::setCapacity(int capacity)
+{
+    QMutexLocker locker(&m_mutex);
+    m_capacity = std::max(1, capacity);
+
+    // Free buffers above the new capacity go now; in-use ones on release
+    while (static_cast<int>(m_buffers.size()) > m_capacity && !m_free.empty()) {
+        Buffer* victim = m_free.back();
+        m_free.pop_back();
+        m_buffers.erase(std::find_if(m_buffers.begin(), m_buffers.end(),
+                                     [victim](const auto& b) { return b.get() == victim; }));
+    }
+    m_free.reserve(static_cast<std::size_t>(m_capacity));
+    m_buffers.reserve(static_cast<std::size_t>(m_capacity));
+}
+
+int FramePool::capacity() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_capacity;
+}
+
+FramePoolStats FramePool::stats() const
+{
+    QMutexLocker locker(&m_mutex);
+    FramePoolStats stats = m_stats;
+    stats.capacity = m_capacity;
+    stats.pooled = static_cast<int>(m_buffers.size());
+    stats.in_use = stats.pooled - static_cast<int>(m_free.size());
+    return stats;
+}
+
+void FramePool::releaseBuffer(void* info)
+{
+    auto* buffer = static_cast<Buffer*>(info);
+    // The pool may die with this reference, so drop it only after release()
+    FramePoolPtr pool = std::move(buffer->owner);
+    pool->release(buffer);
+}
+
+void FramePool::release(Buffer* buffer)
+{
+    if (buffer->transient) {
+        delete buffer;
+        return;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    if (static_cast<int>(m_buffers.size()) > m_capacity) {
+        m_buffers.erase(std::find_if(m_buffers.begin(), m_buffers.end(),
+                                     [buffer](const auto& b) { return b.get() == buffer; }));
+        return;
+    }
+    m_free.push_back(buffer);
+}
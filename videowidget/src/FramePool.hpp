@@ -0,0 +1,67 @@
+#pragma once
+
+#include <QImage>
+#include <QMutex>
+#include <QSharedPointer>
+#include <QtGlobal>
+#include <memory>
+#include <vector>
+
+#include "IFrameHandle.hpp"
+
+namespace video {
+
+    struct FramePoolStats
+    {
+        int capacity = 0;
+        int pooled = 0;             // buffers owned by the pool (free + in use)
+        int in_use = 0;             // pooled buffers still referenced by a frame
+        quint64 acquired = 0;
+        quint64 reused = 0;         // acquires served by a recycled buffer as-is
+        quint64 allocations = 0;    // buffer (re)allocations, transient ones included
+        quint64 exhausted = 0;      // acquires that found every pooled buffer in use
+    };
+
+    // Fixed set of 64-byte aligned pixel buffers recycled between frames.
+    //
+    // acquire() hands out a BasicFrameHandle whose QImage wraps pooled memory;
+    // the buffer goes back to the pool once the last QImage sharing it (and so
+    // the last FrameHandlePtr) is gone. When every buffer is in use the frame
+    // gets a transient buffer that is freed instead of recycled, and the
+    // exhaustion counter is bumped. Thread-safe: frames may be released on
+    // any thread.
+    class FramePool : public QEnableSharedFromThis<FramePool>
+    {
+    public:
+        static QSharedPointer<FramePool> create(int capacity);
+        ~FramePool();
+
+        FramePool(const FramePool&) = delete;
+        FramePool& operator=(const FramePool&) = delete;
+
+        // Contents of the returned image are undefined; callers overwrite it.
+        [[nodiscard]] QImage acquireImage(int width, int height, QImage::Format format);
+        [[nodiscard]] FrameHandlePtr acquire(int width, int height, QImage::Format format);
+
+        void setCapacity(int capacity);
+        [[nodiscard]] int capacity() const;
+        [[nodiscard]] FramePoolStats stats() const;
+
+    private:
+        struct Buffer;
+
+        explicit FramePool(int capacity);
+
+        static void releaseBuffer(void* info);
+        void release(Buffer* buffer);
+
+        mutable QMutex m_mutex;
+        std::vector<std::unique_ptr<Buffer>> m_buffers;
+        std::vector<Buffer*> m_free;
+        int m_capacity = 0;
+        FramePoolStats m_stats;
+    };
+
+    using FramePoolPtr = QSharedPointer<FramePool>;
+
+} // namespace video
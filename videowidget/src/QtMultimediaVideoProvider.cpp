@@ -1,13 +1,22 @@
 #include "QtMultimediaVideoProvider.hpp"
 #include "LoggerMacros.hpp"
+#include "SensorTimebase.h"
 
 #include <QUrl>
-#include <QDateTime>
+#include <QVideoFrameFormat>
+#include <algorithm>
+#include <cstring>
 
 using namespace video;
 
+namespace {
+
+    constexpr int kDefaultFramePoolSize = 6;
+}
+
 QtMultimediaVideoProvider::QtMultimediaVideoProvider (QObject* parent)
     : IVideoFrameProvider(parent)
+    , m_framePool(FramePool::create(kDefaultFramePoolSize))
 {
     LOG_TRACE << "QtMultimediaVideoProvider created";
 
@@ -124,6 +133,31 @@ double QtMultimediaVideoProvider::frameRate() const
     return m_currentFps;
 }
 
+void QtMultimediaVideoProvider::setFramePoolSize(int size)
+{
+    m_framePool->setCapacity(size);
+    LOG_DEBUG << "Frame pool size set to " << m_framePool->capacity();
+}
+
+int QtMultimediaVideoProvider::framePoolSize() const
+{
+    return m_framePool->capacity();
+}
+
+FramePoolStats QtMultimediaVideoProvider::framePoolStats() const
+{
+    return m_framePool->stats();
+}
+
+void QtMultimediaVideoProvider::setOutputSizeHint(const QSize& size)
+{
+    if (m_outputSizeHint == size)
+        return;
+
+    m_outputSizeHint = size;
+    LOG_DEBUG << "Output size hint set to " << size.width() << "x" << size.height();
+}
+
 void QtMultimediaVideoProvider::updateState(ProviderState newState)
 {
     if (m_state == newState)
@@ -137,17 +171,16 @@ void QtMultimediaVideoProvider::updateState(ProviderState newState)
 
 void QtMultimediaVideoProvider::onVideoFrameChanged(const QVideoFrame& frame)
 {
-    LOG_TRACE << "Video frame changed";
-    QImage img = frame.toImage();
+    FrameHandlePtr handle = convertFrame(frame);
 
-    if (img.isNull()){
+    if (!handle || !handle->isValid()){
         LOG_WARN << "Image is null";
         return;
     }
 
-    FrameHandlePtr handle(new BasicFrameHandle(img));
-    const auto ts = QDateTime::currentMSecsSinceEpoch();
-    handle->setTimestamp(ts);
+    // Same clock the sensor timebase maps data timestamps onto
+    handle->setTimestamp(static_cast<int64_t>(domain::hostClockMs()));
+    BLOG_TRACE("Video frame {}x{} at {} ms", frame.width(), frame.height(), handle->timestamp());
 
     m_framesInSecond++;
     updateFps();
@@ -212,6 +245,56 @@ void QtMultimediaVideoProvider::onPlaybackStateChanged(QMediaPlayer::PlaybackSta
     }
 }
 
+FrameHandlePtr QtMultimediaVideoProvider::convertFrame(const QVideoFrame& frame)
+{
+    if (YuvFrameHandle::supportsFormat(frame.pixelFormat())) {
+        // Converted later, at display size, by whoever first needs the pixels
+        auto handle = QSharedPointer<YuvFrameHandle>::create(frame, m_framePool, m_outputSizeHint);
+        if (handle->isValid())
+            return handle;
+    }
+
+    QVideoFrame mapped(frame);
+    if (!mapped.isValid() || !mapped.map(QVideoFrame::ReadOnly)) {
+        LOG_WARN << "Cannot map video frame";
+        return {};
+    }
+
+    const int width = mapped.width();
+    const int height = mapped.height();
+    const QVideoFrameFormat::PixelFormat pixelFormat = mapped.pixelFormat();
+    const QImage::Format imageFormat = QVideoFrameFormat::imageFormatFromPixelFormat(pixelFormat);
+
+    QImage image;
+    if (imageFormat != QImage::Format_Invalid) {
+        // Packed RGB: straight row copy into a pooled buffer
+        image = m_framePool->acquireImage(width, height, imageFormat);
+        if (!image.isNull()) {
+            const uchar* src = mapped.bits(0);
+            const qsizetype srcStride = mapped.bytesPerLine(0);
+            const qsizetype rowBytes = std::min<qsizetype>(srcStride, image.bytesPerLine());
+            for (int row = 0; row < height; ++row)
+                std::memcpy(image.scanLine(row), src + row * srcStride, static_cast<std::size_t>(rowBytes));
+        }
+    }
+    mapped.unmap();
+
+    if (image.isNull()) {
+        // Formats without a direct path (and allocation failures) still go
+        // through Qt's converter, which allocates a fresh image per frame.
+        if (!m_loggedFallback) {
+            LOG_WARN << "No pooled conversion for pixel format " << static_cast<int>(pixelFormat)
+                     << ", falling back to QVideoFrame::toImage()";
+            m_loggedFallback = true;
+        }
+        image = frame.toImage();
+        if (image.isNull())
+            return {};
+    }
+
+    return QSharedPointer<BasicFrameHandle>::create(image);
+}
+
 void QtMultimediaVideoProvider::updateFps()
 {
     const qint64 elapsed = m_fpsTimer.elapsed();
@@ -219,6 +302,13 @@ void QtMultimediaVideoProvider::updateFps()
     if (elapsed >= 1000) {
         m_currentFps = (m_framesInSecond * 1000.0) / elapsed;
         LOG_DEBUG << "Current FPS:" << m_currentFps;
+
+        const FramePoolStats pool = m_framePool->stats();
+        LOG_DEBUG << "Frame pool: in_use=" << pool.in_use << "/" << pool.capacity
+                  << ", acquired=" << pool.acquired
+                  << ", reused=" << pool.reused
+                  << ", allocations=" << pool.allocations
+                  << ", exhausted=" << pool.exhausted;
         m_framesInSecond = 0;
         m_fpsTimer.restart();
     }
@@ -7,6 +7,8 @@
 
 #include "IVideoFrameProvider.hpp"
 #include "BasicFrameHandle.hpp"
+#include "FramePool.hpp"
+#include "YuvFrameHandle.hpp"
 
 namespace video {
     class QtMultimediaVideoProvider : public IVideoFrameProvider
@@ -26,6 +28,14 @@ namespace video {
         void setSource(const QString& source) override;
         [[nodiscard]] double frameRate() const override;
 
+        // NV12/YUV420P frames are converted at this size, and only when used
+        void setOutputSizeHint(const QSize& size) override;
+
+        // Number of recycled frame buffers; frames beyond it get transient ones
+        void setFramePoolSize(int size);
+        [[nodiscard]] int framePoolSize() const;
+        [[nodiscard]] FramePoolStats framePoolStats() const;
+
     private slots:
         void onVideoFrameChanged(const QVideoFrame& frame);
         void onMediaError(QMediaPlayer::Error error, const QString& errorString);
@@ -40,11 +50,16 @@ namespace video {
         ProviderState m_state = ProviderState::Stopped;
         bool m_running = false;
 
+        FramePoolPtr m_framePool;
+        QSize m_outputSizeHint;
+        bool m_loggedFallback = false;
+
         QElapsedTimer m_fpsTimer;
         int m_framesInSecond = 0;
         double m_currentFps = 0.0;
 
         void updateState(ProviderState newState);
         void updateFps();
+        FrameHandlePtr convertFrame(const QVideoFrame& frame);
     };
 }
\ No newline at end of file
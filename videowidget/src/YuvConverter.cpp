@@ -0,0 +1,220 @@
+#include "YuvConverter.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define VIDEO_YUV_SSE2 1
+#endif
+
+using namespace video;
+
+namespace {
+
+    constexpr int kFractionBits = YuvToRgbCoefficients::fraction_bits;
+    constexpr int32_t kRound = 1 << (kFractionBits - 1);
+
+    int32_t toFixed(double value)
+    {
+        return static_cast<int32_t>(std::lround(value * (1 << kFractionBits)));
+    }
+
+    inline uint32_t clampChannel(int32_t value)
+    {
+        value >>= kFractionBits;
+        return static_cast<uint32_t>(std::clamp(value, 0, 255));
+    }
+
+    inline uint32_t yuvToRgb32(int32_t y, int32_t u, int32_t v, const YuvToRgbCoefficients& c)
+    {
+        const int32_t ys = (y - c.y_offset) * c.y_scale + kRound;
+        const uint32_t r = clampChannel(ys + c.v_to_r * v);
+        const uint32_t g = clampChannel(ys - c.u_to_g * u - c.v_to_g * v);
+        const uint32_t b = clampChannel(ys + c.u_to_b * u);
+        return 0xff000000u | (r << 16) | (g << 8) | b;
+    }
+
+    void convertRowScalar(const uint8_t* y, const uint8_t* u, const uint8_t* v, int begin, int end,
+                          uint32_t* out, const YuvToRgbCoefficients& c)
+    {
+        for (int x = begin; x < end; ++x)
+            out[x] = yuvToRgb32(y[x], u[x] - 128, v[x] - 128, c);
+    }
+
+#ifdef VIDEO_YUV_SSE2
+    // Two int16 coefficients per 32-bit lane, as _mm_madd_epi16 consumes them
+    inline __m128i coefficientPair(int32_t lo, int32_t hi)
+    {
+        const uint32_t packed = static_cast<uint16_t>(lo) | (static_cast<uint32_t>(static_cast<uint16_t>(hi)) << 16);
+        return _mm_set1_epi32(static_cast<int32_t>(packed));
+    }
+
+    // Eight pixels per iteration; produces exactly what the scalar path does
+    void convertRow(const uint8_t* y, const uint8_t* u, const uint8_t* v, int width,
+                    uint32_t* out, const YuvToRgbCoefficients& c)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i yOffset = _mm_set1_epi16(static_cast<int16_t>(c.y_offset));
+        const __m128i chromaBias = _mm_set1_epi16(128);
+        const __m128i round = _mm_set1_epi32(kRound);
+        const __m128i opaque = _mm_set1_epi8(static_cast<char>(0xff));
+
+        const __m128i yOnly = coefficientPair(c.y_scale, 0);
+        const __m128i yv = coefficientPair(c.y_scale, c.v_to_r);
+        const __m128i yu = coefficientPair(c.y_scale, c.u_to_b);
+        const __m128i uv = coefficientPair(-c.u_to_g, -c.v_to_g);
+
+        int x = 0;
+        for (; x + 8 <= width; x += 8) {
+            const __m128i y16 = _mm_sub_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(y + x)), zero), yOffset);
+            const __m128i u16 = _mm_sub_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(u + x)), zero), chromaBias);
+            const __m128i v16 = _mm_sub_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(v + x)), zero), chromaBias);
+
+            auto channels = [&](__m128i yy, __m128i uu, __m128i vv, __m128i& r, __m128i& g, __m128i& b) {
+                r = _mm_madd_epi16(_mm_unpacklo_epi16(yy, vv), yv);
+                b = _mm_madd_epi16(_mm_unpacklo_epi16(yy, uu), yu);
+                g = _mm_add_epi32(_mm_madd_epi16(_mm_unpacklo_epi16(yy, zero), yOnly),
+                                  _mm_madd_epi16(_mm_unpacklo_epi16(uu, vv), uv));
+                r = _mm_srai_epi32(_mm_add_epi32(r, round), kFractionBits);
+                g = _mm_srai_epi32(_mm_add_epi32(g, round), kFractionBits);
+                b = _mm_srai_epi32(_mm_add_epi32(b, round), kFractionBits);
+            };
+
+            __m128i rLo, gLo, bLo, rHi, gHi, bHi;
+            channels(y16, u16, v16, rLo, gLo, bLo);
+            channels(_mm_unpackhi_epi64(y16, y16), _mm_unpackhi_epi64(u16, u16), _mm_unpackhi_epi64(v16, v16),
+                     rHi, gHi, bHi);
+
+            // Saturating packs do the 0..255 clamp
+            const __m128i r8 = _mm_packus_epi16(_mm_packs_epi32(rLo, rHi), zero);
+            const __m128i g8 = _mm_packus_epi16(_mm_packs_epi32(gLo, gHi), zero);
+            const __m128i b8 = _mm_packus_epi16(_mm_packs_epi32(bLo, bHi), zero);
+
+            const __m128i bg = _mm_unpacklo_epi8(b8, g8);
+            const __m128i ra = _mm_unpacklo_epi8(r8, opaque);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + x), _mm_unpacklo_epi16(bg, ra));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + x + 4), _mm_unpackhi_epi16(bg, ra));
+        }
+        convertRowScalar(y, u, v, x, width, out, c);
+    }
+#else
+    void convertRow(const uint8_t* y, const uint8_t* u, const uint8_t* v, int width,
+                    uint32_t* out, const YuvToRgbCoefficients& c)
+    {
+        convertRowScalar(y, u, v, 0, width, out, c);
+    }
+#endif
+
+    // Per-thread rows the 4:2:0 input is expanded into before conversion
+    struct RowScratch
+    {
+        std::vector<uint8_t> y;
+        std::vector<uint8_t> u;
+        std::vector<uint8_t> v;
+        std::vector<int> luma_x;
+
+        void resize(int width)
+        {
+            const auto n = static_cast<std::size_t>(width);
+            if (y.size() < n) {
+                y.resize(n);
+                u.resize(n);
+                v.resize(n);
+                luma_x.resize(n);
+            }
+        }
+    };
+
+    RowScratch& rowScratch()
+    {
+        thread_local RowScratch scratch;
+        return scratch;
+    }
+
+    // Centre of destination pixel i mapped back onto the source grid
+    inline int nearestSource(int i, int srcSize, int dstSize)
+    {
+        return static_cast<int>((static_cast<int64_t>(2 * i + 1) * srcSize) / (2 * static_cast<int64_t>(dstSize)));
+    }
+}
+
+namespace video {
+
+    YuvToRgbCoefficients yuvToRgbCoefficients(YuvColorSpace colorSpace, bool fullRange)
+    {
+        double kr = 0.299;
+        double kb = 0.114;
+        switch (colorSpace) {
+            case YuvColorSpace::Bt601:
+                break;
+            case YuvColorSpace::Bt709:
+                kr = 0.2126;
+                kb = 0.0722;
+                break;
+            case YuvColorSpace::Bt2020:
+                kr = 0.2627;
+                kb = 0.0593;
+                break;
+        }
+        const double kg = 1.0 - kr - kb;
+
+        const double yScale = fullRange ? 1.0 : 255.0 / 219.0;
+        const double cScale = fullRange ? 1.0 : 255.0 / 224.0;
+
+        YuvToRgbCoefficients c;
+        c.y_offset = fullRange ? 0 : 16;
+        c.y_scale = toFixed(yScale);
+        c.v_to_r = toFixed(2.0 * (1.0 - kr) * cScale);
+        c.u_to_g = toFixed(2.0 * kb * (1.0 - kb) / kg * cScale);
+        c.v_to_g = toFixed(2.0 * kr * (1.0 - kr) / kg * cScale);
+        c.u_to_b = toFixed(2.0 * (1.0 - kb) * cScale);
+        return c;
+    }
+
+    void convertYuv420ToRgb32(const Yuv420Image& src,
+                              uint8_t* dst, int dstStride, int dstWidth, int dstHeight,
+                              const YuvToRgbCoefficients& coeffs)
+    {
+        if (!src.y || !src.u || !src.v || src.width <= 0 || src.height <= 0 || dstWidth <= 0 || dstHeight <= 0)
+            return;
+
+        RowScratch& scratch = rowScratch();
+        scratch.resize(dstWidth);
+
+        const bool sameWidth = dstWidth == src.width;
+        if (!sameWidth) {
+            for (int x = 0; x < dstWidth; ++x)
+                scratch.luma_x[x] = nearestSource(x, src.width, dstWidth);
+        }
+
+        for (int row = 0; row < dstHeight; ++row) {
+            const int srcRow = dstHeight == src.height ? row : nearestSource(row, src.height, dstHeight);
+            const uint8_t* yRow = src.y + static_cast<std::ptrdiff_t>(srcRow) * src.y_stride;
+            const uint8_t* uRow = src.u + static_cast<std::ptrdiff_t>(srcRow >> 1) * src.u_stride;
+            const uint8_t* vRow = src.v + static_cast<std::ptrdiff_t>(srcRow >> 1) * src.v_stride;
+
+            if (sameWidth) {
+                for (int x = 0; x < dstWidth; ++x) {
+                    const int cx = (x >> 1) * src.chroma_step;
+                    scratch.u[x] = uRow[cx];
+                    scratch.v[x] = vRow[cx];
+                }
+            } else {
+                for (int x = 0; x < dstWidth; ++x) {
+                    const int sx = scratch.luma_x[x];
+                    const int cx = (sx >> 1) * src.chroma_step;
+                    scratch.y[x] = yRow[sx];
+                    scratch.u[x] = uRow[cx];
+                    scratch.v[x] = vRow[cx];
+                }
+                yRow = scratch.y.data();
+            }
+
+            convertRow(yRow, scratch.u.data(), scratch.v.data(), dstWidth,
+                       reinterpret_cast<uint32_t*>(dst + static_cast<std::ptrdiff_t>(row) * dstStride), coeffs);
+        }
+    }
+
+} // namespace video
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+
+namespace video {
+
+    enum class YuvColorSpace
+    {
+        Bt601,
+        Bt709,
+        Bt2020
+    };
+
+    // Fixed-point (x.13) YUV -> RGB matrix for one colour space and range.
+    // Every coefficient fits in int16, which the SIMD row kernel relies on.
+    struct YuvToRgbCoefficients
+    {
+        static constexpr int fraction_bits = 13;
+
+        int32_t y_offset = 16;      // 0 for full range
+        int32_t y_scale = 0;
+        int32_t v_to_r = 0;
+        int32_t u_to_g = 0;         // subtracted
+        int32_t v_to_g = 0;         // subtracted
+        int32_t u_to_b = 0;
+    };
+
+    [[nodiscard]] YuvToRgbCoefficients yuvToRgbCoefficients(YuvColorSpace colorSpace, bool fullRange);
+
+    // One 4:2:0 picture. NV12 is described with u pointing at the UV plane,
+    // v = u + 1 and chroma_step = 2; planar YUV420P uses chroma_step = 1.
+    struct Yuv420Image
+    {
+        const uint8_t* y = nullptr;
+        int y_stride = 0;
+        const uint8_t* u = nullptr;
+        int u_stride = 0;
+        const uint8_t* v = nullptr;
+        int v_stride = 0;
+        int chroma_step = 1;
+        int width = 0;
+        int height = 0;
+    };
+
+    // Converts straight into a dstWidth x dstHeight QImage::Format_RGB32
+    // buffer, picking the nearest source pixel for every output pixel (the
+    // same sampling as an unfiltered QPainter::drawImage). Downscaling this
+    // way never touches the pixels that would be thrown away.
+    void convertYuv420ToRgb32(const Yuv420Image& src,
+                              uint8_t* dst, int dstStride, int dstWidth, int dstHeight,
+                              const YuvToRgbCoefficients& coeffs);
+
+} // namespace video
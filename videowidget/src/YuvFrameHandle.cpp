@@ -0,0 +1,174 @@
+#include "YuvFrameHandle.hpp"
+#include "BasicFrameHandle.hpp"
+#include "LoggerMacros.hpp"
+
+#include <QMutexLocker>
+#include <QVideoFrameFormat>
+#include <algorithm>
+#include <utility>
+
+using namespace video;
+
+namespace {
+
+    YuvToRgbCoefficients coefficientsFor(const QVideoFrameFormat& format)
+    {
+        YuvColorSpace colorSpace = YuvColorSpace::Bt601;
+        switch (format.colorSpace()) {
+            case QVideoFrameFormat::ColorSpace_BT709:
+                colorSpace = YuvColorSpace::Bt709;
+                break;
+            case QVideoFrameFormat::ColorSpace_BT2020:
+                colorSpace = YuvColorSpace::Bt2020;
+                break;
+            case QVideoFrameFormat::ColorSpace_Undefined:
+                // Same guess as Qt: HD material is BT.709
+                if (format.frameHeight() > 576)
+                    colorSpace = YuvColorSpace::Bt709;
+                break;
+            default:
+                break;
+        }
+        const bool fullRange = format.colorRange() == QVideoFrameFormat::ColorRange_Full;
+        return yuvToRgbCoefficients(colorSpace, fullRange);
+    }
+}
+
+YuvFrameHandle::YuvFrameHandle(const QVideoFrame& frame, FramePoolPtr pool, const QSize& outputSize)
+    : m_frame(frame)
+    , m_pool(std::move(pool))
+{
+    if (!m_frame.isValid() || !supportsFormat(m_frame.pixelFormat()) || !m_frame.map(QVideoFrame::ReadOnly)) {
+        m_frame = QVideoFrame();
+        return;
+    }
+
+    m_planes.width = m_frame.width();
+    m_planes.height = m_frame.height();
+    m_planes.y = m_frame.bits(0);
+    m_planes.y_stride = m_frame.bytesPerLine(0);
+
+    if (m_frame.pixelFormat() == QVideoFrameFormat::Format_NV12) {
+        m_planes.u = m_frame.bits(1);
+        m_planes.u_stride = m_frame.bytesPerLine(1);
+        m_planes.v = m_planes.u + 1;
+        m_planes.v_stride = m_planes.u_stride;
+        m_planes.chroma_step = 2;
+    } else {
+        m_planes.u = m_frame.bits(1);
+        m_planes.u_stride = m_frame.bytesPerLine(1);
+        m_planes.v = m_frame.bits(2);
+        m_planes.v_stride = m_frame.bytesPerLine(2);
+        m_planes.chroma_step = 1;
+    }
+    m_coefficients = coefficientsFor(m_frame.surfaceFormat());
+
+    // Fit inside the hint with the source's aspect ratio, whatever shape the
+    // hint has (it is stretched under IgnoreAspectRatio), so the image the
+    // widget fits next never carries a distortion forward. Never upscale:
+    // the painter does that for free.
+    m_outputSize = QSize(m_planes.width, m_planes.height);
+    if (!outputSize.isEmpty()) {
+        const double scale = std::min({1.0,
+                                       double(outputSize.width()) / m_planes.width,
+                                       double(outputSize.height()) / m_planes.height});
+        m_outputSize = QSize(std::max(1, int(m_planes.width * scale + 0.5)),
+                             std::max(1, int(m_planes.height * scale + 0.5)));
+    }
+}
+
+YuvFrameHandle::~YuvFrameHandle()
+{
+    releaseFrame();
+}
+
+bool YuvFrameHandle::supportsFormat(QVideoFrameFormat::PixelFormat format)
+{
+    return format == QVideoFrameFormat::Format_NV12 || format == QVideoFrameFormat::Format_YUV420P;
+}
+
+const QImage& YuvFrameHandle::image() const
+{
+    QMutexLocker locker(&m_mutex);
+    convert();
+    return m_image;
+}
+
+QImage& YuvFrameHandle::writableImage()
+{
+    QMutexLocker locker(&m_mutex);
+    convert();
+    return m_image;
+}
+
+bool YuvFrameHandle::isValid() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_converted ? !m_image.isNull() : m_frame.isMapped();
+}
+
+int YuvFrameHandle::width() const
+{
+    return m_outputSize.width();
+}
+
+int YuvFrameHandle::height() const
+{
+    return m_outputSize.height();
+}
+
+int64_t YuvFrameHandle::timestamp() const
+{
+    return m_timestamp;
+}
+
+void YuvFrameHandle::setTimestamp(int64_t timestamp)
+{
+    m_timestamp = timestamp;
+}
+
+IFrameHandle* YuvFrameHandle::clone() const
+{
+    auto* copy = new BasicFrameHandle(image());
+    copy->setTimestamp(m_timestamp);
+    return copy;
+}
+
+bool YuvFrameHandle::withPlanes(const std::function<void(const Yuv420Image&, const YuvToRgbCoefficients&)>& use) const
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_converted || !m_frame.isMapped())
+        return false;
+
+    use(m_planes, m_coefficients);
+    return true;
+}
+
+void YuvFrameHandle::convert() const
+{
+    if (m_converted)
+        return;
+    m_converted = true;
+
+    if (!m_frame.isMapped())
+        return;
+
+    const int width = m_outputSize.width();
+    const int height = m_outputSize.height();
+    m_image = m_pool ? m_pool->acquireImage(width, height, QImage::Format_RGB32)
+                     : QImage(width, height, QImage::Format_RGB32);
+    if (m_image.isNull()) {
+        LOG_ERROR << "YuvFrameHandle: no buffer for " << width << "x" << height << " frame";
+    } else {
+        convertYuv420ToRgb32(m_planes, m_image.bits(), static_cast<int>(m_image.bytesPerLine()),
+                             width, height, m_coefficients);
+    }
+    releaseFrame();
+}
+
+void YuvFrameHandle::releaseFrame() const
+{
+    if (m_frame.isMapped())
+        m_frame.unmap();
+    m_frame = QVideoFrame();
+}
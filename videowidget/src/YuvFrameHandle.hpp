@@ -0,0 +1,62 @@
+#pragma once
+
+#include <QImage>
+#include <QMutex>
+#include <QSize>
+#include <QVideoFrame>
+#include <cstdint>
+#include <functional>
+
+#include "IFrameHandle.hpp"
+#include "FramePool.hpp"
+#include "YuvConverter.hpp"
+
+namespace video {
+
+    // Frame handle over a mapped NV12/YUV420P QVideoFrame.
+    //
+    // Nothing is converted up front: the planes stay in the decoder's buffer
+    // until image() or writableImage() is first called, and then go straight
+    // to RGB32 at the output size given at construction (normally the size
+    // the widget displays at), into a FramePool buffer. The video frame is
+    // released right after that. width()/height() report the output size.
+    // The first image() may come from any thread.
+    class YuvFrameHandle : public IFrameHandle
+    {
+    public:
+        // Output size is clamped to the frame size; an empty one means full size
+        YuvFrameHandle(const QVideoFrame& frame, FramePoolPtr pool, const QSize& outputSize);
+        ~YuvFrameHandle() override;
+
+        [[nodiscard]] static bool supportsFormat(QVideoFrameFormat::PixelFormat format);
+
+        const QImage& image() const override;
+        QImage& writableImage() override;
+        [[nodiscard]] bool isValid() const override;
+        [[nodiscard]] int width() const override;
+        [[nodiscard]] int height() const override;
+        [[nodiscard]] int64_t timestamp() const override;
+        void setTimestamp(int64_t timestamp) override;
+        IFrameHandle* clone() const override;
+
+        // Calls `use` with the still-mapped planes and their colour matrix, so
+        // a consumer that converts on its own (e.g. in a shader) can skip
+        // image(). Returns false once the frame has been converted.
+        bool withPlanes(const std::function<void(const Yuv420Image&, const YuvToRgbCoefficients&)>& use) const;
+
+    private:
+        mutable QMutex m_mutex;
+        mutable QVideoFrame m_frame;    // mapped until converted
+        mutable QImage m_image;
+        mutable bool m_converted = false;
+        FramePoolPtr m_pool;
+        Yuv420Image m_planes;
+        YuvToRgbCoefficients m_coefficients;
+        QSize m_outputSize;
+        int64_t m_timestamp = 0;
+
+        void convert() const;
+        void releaseFrame() const;
+    };
+
+} // namespace video
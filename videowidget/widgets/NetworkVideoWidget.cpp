@@ -74,6 +74,16 @@ bool NetworkVideoWidget::isConnected() const
     return m_connected;
 }
 
+void NetworkVideoWidget::setFramePoolSize(int size)
+{
+    m_videoProvider->setFramePoolSize(size);
+}
+
+FramePoolStats NetworkVideoWidget::framePoolStats() const
+{
+    return m_videoProvider->framePoolStats();
+}
+
 void NetworkVideoWidget::connectToSource()
 {
     if (m_sourceUrl.isEmpty()) {
@@ -24,6 +24,9 @@ namespace video
 
         [[nodiscard]] bool isConnected() const;
 
+        void setFramePoolSize(int size);
+        [[nodiscard]] FramePoolStats framePoolStats() const;
+
         void connectToSource();
         void disconnectFromSource();
 
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <QAbstractListModel>
+#include <QList>
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+namespace viewmodels {
+
+    // Keys for items without an id of their own: the item's kind plus the
+    // number of items of that kind before it, so the second crosswalk stays
+    // the second crosswalk from one update to the next
+    class OrdinalKeys {
+    public:
+        std::uint64_t next(std::uint8_t kind) noexcept {
+            return (static_cast<std::uint64_t>(kind) << 32) | seen_[kind]++;
+        }
+
+    private:
+        std::array<std::uint32_t, 256> seen_{};
+    };
+
+    // Keys for items with a persistent id; the top bit keeps them apart
+    // from ordinal keys
+    inline std::uint64_t idKey(std::uint64_t id) noexcept {
+        return (std::uint64_t{1} << 63) | id;
+    }
+
+    // List model base that applies a new collection as a diff against the
+    // rows it shows. Rows are matched by key; unmatched rows are removed,
+    // new keys inserted, reordered rows moved, and matched rows report
+    // dataChanged with only the roles whose values differ. Views keep their
+    // delegates, selection and scroll position.
+    class KeyedListModel : public QAbstractListModel
+    {
+    public:
+        using QAbstractListModel::QAbstractListModel;
+
+    protected:
+        // rows and keys are the model's storage, kept parallel. Keys must be
+        // unique within incoming_keys. changed_roles(old, new) returns the
+        // roles that differ between two items with the same key.
+        template<typename Item, typename Key, typename ChangedRoles>
+        void applyUpdate(std::vector<Item>& rows, std::vector<Key>& keys,
+                         std::vector<Item>&& incoming, const std::vector<Key>& incoming_keys,
+                         ChangedRoles changed_roles)
+        {
+            const auto incoming_has = [&incoming_keys](const Key& key) {
+                return std::find(incoming_keys.begin(), incoming_keys.end(), key) != incoming_keys.end();
+            };
+
+            // Removals, back to front, one signal per contiguous range
+            for (int last = static_cast<int>(keys.size()) - 1; last >= 0; --last) {
+                if (incoming_has(keys[static_cast<std::size_t>(last)]))
+                    continue;
+                int first = last;
+                while (first > 0 && !incoming_has(keys[static_cast<std::size_t>(first - 1)]))
+                    --first;
+
+                beginRemoveRows({}, first, last);
+                rows.erase(rows.begin() + first, rows.begin() + last + 1);
+                keys.erase(keys.begin() + first, keys.begin() + last + 1);
+                endRemoveRows();
+                last = first;
+            }
+
+            // Every remaining row has a place in incoming; walk it and bring
+            // row i in line with incoming[i]
+            int changed_first = -1;
+            int changed_last = -1;
+            QList<int> changed;
+            const auto flush_changed = [&]() {
+                if (changed_first < 0)
+                    return;
+                emit dataChanged(index(changed_first), index(changed_last), changed);
+                changed_first = changed_last = -1;
+                changed.clear();
+            };
+
+            std::size_t i = 0;
+            while (i < incoming.size()) {
+                if (i < keys.size() && keys[i] == incoming_keys[i]) {
+                    const QList<int> roles = changed_roles(rows[i], incoming[i]);
+                    rows[i] = std::move(incoming[i]);
+                    if (!roles.isEmpty()) {
+                        if (changed_last != static_cast<int>(i) - 1)
+                            flush_changed();
+                        if (changed_first < 0)
+                            changed_first = static_cast<int>(i);
+                        changed_last = static_cast<int>(i);
+                        for (int role : roles) {
+                            if (!changed.contains(role))
+                                changed.append(role);
+                        }
+                    }
+                    ++i;
+                    continue;
+                }
+
+                const auto found = std::find(keys.begin() + static_cast<std::ptrdiff_t>(i), keys.end(), incoming_keys[i]);
+                if (found != keys.end()) {
+                    // Rows before i are settled, so the pending dataChanged
+                    // range stays valid across the move
+                    const int from = static_cast<int>(std::distance(keys.begin(), found));
+                    beginMoveRows({}, from, from, {}, static_cast<int>(i));
+                    std::rotate(rows.begin() + static_cast<std::ptrdiff_t>(i), rows.begin() + from, rows.begin() + from + 1);
+                    std::rotate(keys.begin() + static_cast<std::ptrdiff_t>(i), found, found + 1);
+                    endMoveRows();
+                    continue;
+                }
+
+                std::size_t end = i + 1;
+                while (end < incoming.size() &&
+                       std::find(keys.begin() + static_cast<std::ptrdiff_t>(i), keys.end(), incoming_keys[end]) == keys.end())
+                    ++end;
+
+                beginInsertRows({}, static_cast<int>(i), static_cast<int>(end) - 1);
+                rows.insert(rows.begin() + static_cast<std::ptrdiff_t>(i),
+                            std::make_move_iterator(incoming.begin() + static_cast<std::ptrdiff_t>(i)),
+                            std::make_move_iterator(incoming.begin() + static_cast<std::ptrdiff_t>(end)));
+                keys.insert(keys.begin() + static_cast<std::ptrdiff_t>(i),
+                            incoming_keys.begin() + static_cast<std::ptrdiff_t>(i),
+                            incoming_keys.begin() + static_cast<std::ptrdiff_t>(end));
+                endInsertRows();
+                i = end;
+            }
+
+            flush_changed();
+        }
+    };
+
+}
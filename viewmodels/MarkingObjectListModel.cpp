@@ -1,30 +1,45 @@
 #include "MarkingObjectListModel.h"
 #include <cmath>
+#include <utility>
 
 namespace viewmodels {
 
+    namespace {
+        float distanceFromVehicle(const domain::MarkingObject& obj) {
+            // Euclidean distance from vehicle (0, 0)
+            float x = obj.xMeters();
+            float y = obj.yMeters();
+            return std::sqrt(x * x + y * y);
+        }
+    }
+
     MarkingObjectListModel::MarkingObjectListModel(QObject* parent)
-        : QAbstractListModel(parent)
+        : KeyedListModel(parent)
     {
     }
 
     void MarkingObjectListModel::updateFromDomain(const domain::MarkingObjectModel& model) {
-        beginResetModel();
-
-        objects_.clear();
-        objects_.reserve(model.size());
-
-        for (const auto& obj : model) {
-            objects_.push_back(obj);
+        const int old_count = static_cast<int>(objects_.size());
+
+        incoming_.assign(model.begin(), model.end());
+        incoming_keys_.clear();
+        OrdinalKeys ordinal_keys;
+        for (const auto& obj : incoming_) {
+            // Tentative tracks have no id yet and fall back to class ordinal
+            incoming_keys_.push_back(obj.trackId() != 0
+                ? idKey(obj.trackId())
+                : ordinal_keys.next(static_cast<std::uint8_t>(obj.classId())));
         }
 
+        applyUpdate(objects_, keys_, std::move(incoming_), incoming_keys_, &MarkingObjectListModel::changedRoles);
+
         if (timestamp_ms_ != model.timestampMs()) {
             timestamp_ms_ = model.timestampMs();
             emit timestampChanged(timestamp_ms_);
         }
 
-        endResetModel();
-        emit countChanged(static_cast<int>(objects_.size()));
+        if (old_count != static_cast<int>(objects_.size()))
+            emit countChanged(static_cast<int>(objects_.size()));
     }
 
     void MarkingObjectListModel::clear() {
@@ -33,6 +48,7 @@ namespace viewmodels {
 
         beginResetModel();
         objects_.clear();
+        keys_.clear();
         timestamp_ms_ = 0;
         endResetModel();
 
@@ -40,6 +56,32 @@ namespace viewmodels {
         emit timestampChanged(0);
     }
 
+    QList<int> MarkingObjectListModel::changedRoles(const domain::MarkingObject& before,
+                                                    const domain::MarkingObject& after) {
+        // A track keeps its class, and ordinal keys include it, so class id
+        // and the roles derived from it never change for a row
+        QList<int> roles;
+        if (before.xMeters() != after.xMeters())
+            roles.append(XMetersRole);
+        if (before.yMeters() != after.yMeters())
+            roles.append(YMetersRole);
+        if (before.lengthMeters() != after.lengthMeters())
+            roles.append(LengthMetersRole);
+        if (before.widthMeters() != after.widthMeters())
+            roles.append(WidthMetersRole);
+        if (before.yawDeg() != after.yawDeg())
+            roles.append(YawDegRole);
+        if (before.confidence() != after.confidence())
+            roles.append(ConfidenceRole);
+        if (before.isValid() != after.isValid())
+            roles.append(IsValidRole);
+        if (before.area() != after.area())
+            roles.append(AreaRole);
+        if (distanceFromVehicle(before) != distanceFromVehicle(after))
+            roles.append(DistanceRole);
+        return roles;
+    }
+
     int MarkingObjectListModel::rowCount(const QModelIndex& parent) const {
         if (parent.isValid())
             return 0;
@@ -89,12 +131,8 @@ namespace viewmodels {
             case AreaRole:
                 return obj.area();
 
-            case DistanceRole: {
-                // Calculate Euclidean distance from vehicle (0, 0)
-                float x = obj.xMeters();
-                float y = obj.yMeters();
-                return std::sqrt(x * x + y * y);
-            }
+            case DistanceRole:
+                return distanceFromVehicle(obj);
 
             default:
                 return {};
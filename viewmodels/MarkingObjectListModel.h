@@ -1,11 +1,11 @@
 #pragma once
 
-#include <QAbstractListModel>
+#include "KeyedListModel.h"
 #include "MarkingObject.h"
 
 namespace viewmodels {
 
-    class MarkingObjectListModel : public QAbstractListModel
+    class MarkingObjectListModel : public KeyedListModel
     {
         Q_OBJECT
         Q_PROPERTY(int count READ rowCount NOTIFY countChanged)
@@ -46,8 +46,12 @@ namespace viewmodels {
 
     private:
         QString classIdToString(laneproto::MarkingClassId id) const;
+        static QList<int> changedRoles(const domain::MarkingObject& before, const domain::MarkingObject& after);
 
         std::vector<domain::MarkingObject> objects_;
+        std::vector<std::uint64_t> keys_;       // track id, or class and ordinal within the class, per row
+        std::vector<domain::MarkingObject> incoming_;   // update scratch, kept for its capacity
+        std::vector<std::uint64_t> incoming_keys_;
         quint64 timestamp_ms_{0};
     };
 
@@ -1,39 +1,69 @@
 #include "WarningListModel.h"
+#include <utility>
 
 namespace viewmodels {
 
     WarningListModel::WarningListModel(QObject* parent)
-        : QAbstractListModel(parent)
+        : KeyedListModel(parent)
     {
     }
 
     void WarningListModel::updateFromDomain(const domain::WarningModel& model) {
-        beginResetModel();
-
-        warnings_.clear();
-        warnings_.reserve(model.size());
-
-        for (const auto& warning : model) {
-            warnings_.push_back(warning);
+        const int old_count = static_cast<int>(warnings_.size());
+
+        // Warnings about a tracked object are matched by rule, type and track
+        // id, the rest by type and position among warnings of that type
+        incoming_.assign(model.begin(), model.end());
+        incoming_keys_.clear();
+        OrdinalKeys ordinal_keys;
+        for (const auto& warning : incoming_) {
+            incoming_keys_.push_back(warning.sourceId() != 0
+                ? idKey((static_cast<std::uint64_t>(warning.ruleId()) << 40) |
+                        (static_cast<std::uint64_t>(warning.type()) << 32) | warning.sourceId())
+                : ordinal_keys.next(static_cast<std::uint8_t>(warning.type())));
         }
 
+        applyUpdate(warnings_, keys_, std::move(incoming_), incoming_keys_, &WarningListModel::changedRoles);
+
         if (last_update_ms_ != model.lastUpdateMs()) {
             last_update_ms_ = model.lastUpdateMs();
             emit lastUpdateChanged(last_update_ms_);
         }
 
-        endResetModel();
-        emit countChanged(static_cast<int>(warnings_.size()));
+        if (old_count != static_cast<int>(warnings_.size()))
+            emit countChanged(static_cast<int>(warnings_.size()));
 
         updateCounters();
     }
 
+    QList<int> WarningListModel::changedRoles(const domain::Warning& before, const domain::Warning& after) {
+        // Type is part of the key
+        QList<int> roles;
+        if (before.severity() != after.severity()) {
+            roles.append(SeverityRole);
+            roles.append(SeverityNameRole);
+            roles.append(IsCriticalRole);
+        }
+        if (before.timestampMs() != after.timestampMs())
+            roles.append(TimestampMsRole);
+        if (before.distanceMeters() != after.distanceMeters())
+            roles.append(DistanceMetersRole);
+        if (before.confidence() != after.confidence())
+            roles.append(ConfidenceRole);
+        if (!before.hasSameMessage(after))
+            roles.append(MessageRole);
+        if (before.isActive() != after.isActive())
+            roles.append(IsActiveRole);
+        return roles;
+    }
+
     void WarningListModel::clear() {
         if (warnings_.empty())
             return;
 
         beginResetModel();
         warnings_.clear();
+        keys_.clear();
         last_update_ms_ = 0;
         endResetModel();
 
@@ -87,7 +117,9 @@ namespace viewmodels {
                 return warning.confidence();
 
             case MessageRole:
-                return QString::fromStdString(warning.message());
+                message_scratch_.clear();
+                warning.appendMessage(message_scratch_);
+                return QString::fromStdString(message_scratch_);
 
             case IsActiveRole:
                 return warning.isActive();
@@ -1,11 +1,11 @@
 #pragma once
 
-#include <QAbstractListModel>
+#include "KeyedListModel.h"
 #include "Warning.h"
 
 namespace viewmodels {
 
-    class WarningListModel : public QAbstractListModel
+    class WarningListModel : public KeyedListModel
     {
         Q_OBJECT
         Q_PROPERTY(int count READ rowCount NOTIFY countChanged)
@@ -54,8 +54,13 @@ namespace viewmodels {
         QString warningTypeToString(domain::WarningType type) const;
         QString warningSeverityToString(domain::WarningSeverity severity) const;
         void updateCounters();
+        static QList<int> changedRoles(const domain::Warning& before, const domain::Warning& after);
 
         std::vector<domain::Warning> warnings_;
+        std::vector<std::uint64_t> keys_;       // rule, type and source track id, or type and ordinal, per row
+        std::vector<domain::Warning> incoming_; // update scratch, kept for its capacity
+        std::vector<std::uint64_t> incoming_keys_;
+        mutable std::string message_scratch_;   // data() formats MessageRole into it
         quint64 last_update_ms_{0};
         int active_count_{0};
         int critical_count_{0};